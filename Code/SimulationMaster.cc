@@ -24,6 +24,7 @@
 #include "net/IOCommunicator.h"
 #include "colloids/BodyForces.h"
 #include "colloids/BoundaryConditions.h"
+#include "Exception.h"
 
 #include <map>
 #include <limits>
@@ -52,6 +53,7 @@ SimulationMaster::SimulationMaster(hemelb::configuration::CommandLine & options,
   stepManager = NULL;
   netConcern = NULL;
   neighbouringDataManager = NULL;
+  loadBalancer = NULL;
   imagesPerSimulation = options.NumberOfImages();
   steeringSessionId = options.GetSteeringSessionId();
 
@@ -85,6 +87,24 @@ SimulationMaster::SimulationMaster(hemelb::configuration::CommandLine & options,
 SimulationMaster::~SimulationMaster()
 {
 
+  DeleteSimulationObjects();
+  delete network;
+  delete simulationState;
+  delete loadBalancer;
+
+  delete simConfig;
+  delete fileManager;
+  if (IsCurrentProcTheIOProc())
+  {
+    delete reporter;
+  }
+}
+
+/**
+ * Deletes everything built by CreateSimulationObjects.
+ */
+void SimulationMaster::DeleteSimulationObjects()
+{
   if (ioComms.OnIORank())
   {
     delete imageSendCpt;
@@ -94,25 +114,33 @@ SimulationMaster::~SimulationMaster()
   delete latticeBoltzmannModel;
   delete inletValues;
   delete outletValues;
-  delete network;
   delete steeringCpt;
   delete visualisationControl;
   delete propertyExtractor;
   delete propertyDataSource;
   delete stabilityTester;
   delete entropyTester;
-  delete simulationState;
   delete incompressibilityChecker;
   delete neighbouringDataManager;
-
-  delete simConfig;
-  delete fileManager;
-  if (IsCurrentProcTheIOProc())
-  {
-    delete reporter;
-  }
   delete stepManager;
   delete netConcern;
+
+  imageSendCpt = NULL;
+  latticeData = NULL;
+  colloidController = NULL;
+  latticeBoltzmannModel = NULL;
+  inletValues = NULL;
+  outletValues = NULL;
+  steeringCpt = NULL;
+  visualisationControl = NULL;
+  propertyExtractor = NULL;
+  propertyDataSource = NULL;
+  stabilityTester = NULL;
+  entropyTester = NULL;
+  incompressibilityChecker = NULL;
+  neighbouringDataManager = NULL;
+  stepManager = NULL;
+  netConcern = NULL;
 }
 
 /**
@@ -144,6 +172,49 @@ void SimulationMaster::Initialise()
   simulationState = new hemelb::lb::SimulationState(simConfig->GetTimeStepLength(),
                                                     simConfig->GetTotalTimeSteps());
 
+  // Initialise and begin the steering.
+  if (ioComms.OnIORank())
+  {
+    network = new hemelb::steering::Network(steeringSessionId, timings);
+  }
+  else
+  {
+    network = NULL;
+  }
+
+  for (unsigned outputNumber = 0; outputNumber < simConfig->PropertyOutputCount(); ++outputNumber)
+  {
+    simConfig->GetPropertyOutput(outputNumber)->filename = fileManager->GetDataExtractionPath()
+        + simConfig->GetPropertyOutput(outputNumber)->filename;
+  }
+
+  CreateSimulationObjects(std::vector<float>());
+
+  if (!simConfig->GetCheckpointConfiguration().restartPath.empty())
+  {
+    RestoreFromCheckpoint(simConfig->GetCheckpointConfiguration().restartPath);
+  }
+
+  const hemelb::configuration::SimConfig::RebalanceConfig& rebalanceConfig = simConfig->GetRebalanceConfiguration();
+  if (rebalanceConfig.interval != 0)
+  {
+    const hemelb::geometry::decomposition::SiteWeights
+        siteWeights(simConfig->GetGeometryReadingConfiguration().siteWeightsPath);
+    loadBalancer = new hemelb::geometry::decomposition::LoadBalancer(ioComms,
+                                                                     latticeData->GetBlockCount(),
+                                                                     siteWeights,
+                                                                     rebalanceConfig.threshold);
+  }
+}
+
+/**
+ * Reads and decomposes the geometry, and builds the lattice, the LBM and everything that works
+ * on them.
+ *
+ * @param blockWeightScales passed on to GeometryReader::LoadAndDecompose
+ */
+void SimulationMaster::CreateSimulationObjects(const std::vector<float>& blockWeightScales)
+{
   hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Initialising LatticeData.");
 
   timings[hemelb::reporting::Timers::latDatInitialise].Start();
@@ -152,9 +223,10 @@ void SimulationMaster::Initialise()
 
   hemelb::geometry::GeometryReader reader(hemelb::steering::SteeringComponent::RequiresSeparateSteeringCore(),
                                           latticeType::GetLatticeInfo(),
-                                          timings, ioComms);
+                                          timings, ioComms,
+                                          simConfig->GetGeometryReadingConfiguration());
   hemelb::geometry::Geometry readGeometryData =
-      reader.LoadAndDecompose(simConfig->GetDataFilePath());
+      reader.LoadAndDecompose(simConfig->GetDataFilePath(), blockWeightScales);
 
   // Create a new lattice based on that info and return it.
   latticeData = new hemelb::geometry::LatticeData(latticeType::GetLatticeInfo(), readGeometryData, ioComms);
@@ -182,11 +254,20 @@ void SimulationMaster::Initialise()
     std::string colloidConfigPath = simConfig->GetColloidConfigPath();
     hemelb::io::xml::Document xml(colloidConfigPath);
 
-    hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Creating Body Forces.");
-    hemelb::colloids::BodyForces::InitBodyForces(xml);
+    // The forces and boundary conditions are registered with the first, unscaled, decomposition.
+    // After rebalancing the boundary conditions just need the new lattice.
+    if (blockWeightScales.empty())
+    {
+      hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Creating Body Forces.");
+      hemelb::colloids::BodyForces::InitBodyForces(xml);
 
-    hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Creating Boundary Conditions.");
-    hemelb::colloids::BoundaryConditions::InitBoundaryConditions(latticeData, xml);
+      hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Creating Boundary Conditions.");
+      hemelb::colloids::BoundaryConditions::InitBoundaryConditions(latticeData, xml);
+    }
+    else
+    {
+      hemelb::colloids::BoundaryConditions::SetLatticeData(latticeData);
+    }
 
     hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Initialising Colloids.");
     colloidController =
@@ -202,19 +283,10 @@ void SimulationMaster::Initialise()
   }
   timings[hemelb::reporting::Timers::colloidInitialisation].Stop();
 
-  // Initialise and begin the steering.
-  if (ioComms.OnIORank())
-  {
-    network = new hemelb::steering::Network(steeringSessionId, timings);
-  }
-  else
-  {
-    network = NULL;
-  }
-
   stabilityTester = new hemelb::lb::StabilityTester<latticeType>(latticeData,
                                                                  &communicationNet,
                                                                  simulationState,
+                                                                 latticeBoltzmannModel->GetPropertyCache(),
                                                                  timings,
                                                                  monitoringConfig);
   entropyTester = NULL;
@@ -293,17 +365,12 @@ void SimulationMaster::Initialise()
 
   if (simConfig->PropertyOutputCount() > 0)
   {
-
-    for (unsigned outputNumber = 0; outputNumber < simConfig->PropertyOutputCount(); ++outputNumber)
-    {
-      simConfig->GetPropertyOutput(outputNumber)->filename = fileManager->GetDataExtractionPath()
-          + simConfig->GetPropertyOutput(outputNumber)->filename;
-    }
-
+    // After a rebalance, carry on writing the files begun under the previous decomposition.
     propertyExtractor = new hemelb::extraction::PropertyActor(*simulationState,
                                                               simConfig->GetPropertyOutputs(),
                                                               *propertyDataSource,
-                                                              timings, ioComms);
+                                                              timings, ioComms,
+                                                              !blockWeightScales.empty());
   }
 
   imagesPeriod = OutputPeriod(imagesPerSimulation);
@@ -466,6 +533,13 @@ void SimulationMaster::Finalise()
 {
   timings[hemelb::reporting::Timers::total].Stop();
   timings.Reduce();
+
+  const std::string& siteWeightsPath = simConfig->GetGeometryReadingConfiguration().siteWeightsCalibrationPath;
+  if (!siteWeightsPath.empty())
+  {
+    WriteSiteWeights(siteWeightsPath);
+  }
+
   if (IsCurrentProcTheIOProc())
   {
     reporter->FillDictionary();
@@ -479,6 +553,44 @@ void SimulationMaster::Finalise()
   hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Finish running simulation.");
 }
 
+void SimulationMaster::WriteSiteWeights(const std::string& path)
+{
+  const std::vector<double> collisionTypeTimes =
+      ioComms.AllReduce(latticeBoltzmannModel->GetCollisionTypeTimes(), MPI_SUM);
+
+  std::vector<hemelb::site_t> collisionTypeSites(hemelb::COLLISION_TYPES);
+  for (unsigned collisionType = 0; collisionType < hemelb::COLLISION_TYPES; ++collisionType)
+  {
+    collisionTypeSites[collisionType] = latticeData->GetMidDomainCollisionCount(collisionType)
+        + latticeData->GetDomainEdgeCollisionCount(collisionType);
+  }
+  collisionTypeSites = ioComms.AllReduce(collisionTypeSites, MPI_SUM);
+
+  std::vector<double> costPerSite(hemelb::COLLISION_TYPES, 0.0);
+  for (unsigned collisionType = 0; collisionType < hemelb::COLLISION_TYPES; ++collisionType)
+  {
+    if (collisionTypeSites[collisionType] > 0)
+    {
+      costPerSite[collisionType] = collisionTypeTimes[collisionType] / collisionTypeSites[collisionType];
+    }
+  }
+
+  const hemelb::geometry::decomposition::SiteWeights siteWeights =
+      hemelb::geometry::decomposition::SiteWeights::FromMeasuredCosts(costPerSite);
+  if (IsCurrentProcTheIOProc())
+  {
+    siteWeights.Write(path);
+    hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Wrote site weights %i %i %i %i %i %i to %s",
+                                                                        siteWeights[0],
+                                                                        siteWeights[1],
+                                                                        siteWeights[2],
+                                                                        siteWeights[3],
+                                                                        siteWeights[4],
+                                                                        siteWeights[5],
+                                                                        path.c_str());
+  }
+}
+
 void SimulationMaster::DoTimeStep()
 {
   bool writeImage = ( (simulationState->GetTimeStep() % imagesPeriod) == 0) ?
@@ -573,9 +685,114 @@ void SimulationMaster::DoTimeStep()
   {
     fflush(NULL);
   }
+
+  const hemelb::LatticeTimeStep checkpointInterval = simConfig->GetCheckpointConfiguration().interval;
+  if (checkpointInterval != 0 && simulationState->GetTimeStep() % checkpointInterval == 0)
+  {
+    WriteCheckpoint();
+  }
+
+  if (loadBalancer != NULL && simulationState->GetTimeStep() % simConfig->GetRebalanceConfiguration().interval == 0
+      && simulationState->GetTimeStep() < simulationState->GetTotalTimeSteps()
+      && IsImbalanced())
+  {
+    // This restores the state at the start of the next time step.
+    Rebalance();
+    return;
+  }
   simulationState->Increment();
 }
 
+bool SimulationMaster::IsImbalanced()
+{
+  return loadBalancer->IsImbalanced(timings[hemelb::reporting::Timers::lb_calc].Get());
+}
+
+void SimulationMaster::Rebalance()
+{
+  hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Rebalancing the load between processes.");
+  loadBalancer->UpdateBlockWeightScales(*latticeData);
+
+  // Carry the state across the new decomposition through a checkpoint, which also serves as an
+  // ordinary restart point.
+  const std::string path = WriteCheckpoint();
+
+  if (IsCurrentProcTheIOProc())
+  {
+    reporter->RemoveReportable(latticeData);
+    reporter->RemoveReportable(incompressibilityChecker);
+  }
+  // Images in progress were being made by the old visualisation controller.
+  writtenImagesCompleted.clear();
+  networkImagesCompleted.clear();
+
+  DeleteSimulationObjects();
+  CreateSimulationObjects(loadBalancer->GetBlockWeightScales());
+  RestoreFromCheckpoint(path);
+
+  if (IsCurrentProcTheIOProc())
+  {
+    if (monitoringConfig->doIncompressibilityCheck)
+    {
+      reporter->AddReportable(incompressibilityChecker);
+    }
+    reporter->AddReportable(latticeData);
+  }
+}
+
+std::string SimulationMaster::WriteCheckpoint()
+{
+  hemelb::lb::CheckpointData checkpoint;
+  // All actors have finished this time step, so a restart resumes at the next one.
+  checkpoint.timeStep = simulationState->GetTimeStep() + 1;
+
+  latticeBoltzmannModel->SaveToCheckpoint(checkpoint);
+  inletValues->SaveToCheckpoint(checkpoint.ioletState);
+  outletValues->SaveToCheckpoint(checkpoint.ioletState);
+  checkpoint.valuesPerParticle = hemelb::colloids::Particle::CheckpointRecordLength;
+  if (colloidController != NULL)
+  {
+    colloidController->SaveToCheckpoint(checkpoint.particleValues);
+  }
+
+  const std::string path = fileManager->GetCheckpointPath(checkpoint.timeStep);
+  hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Writing checkpoint %s.", path.c_str());
+  hemelb::lb::Checkpointer(ioComms).Write(path, checkpoint);
+  return path;
+}
+
+void SimulationMaster::RestoreFromCheckpoint(const std::string& path)
+{
+  hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Restarting from checkpoint %s.",
+                                                                      path.c_str());
+  hemelb::lb::CheckpointData checkpoint;
+  latticeBoltzmannModel->PrepareToRestoreFromCheckpoint(checkpoint);
+  hemelb::lb::Checkpointer(ioComms).Read(path, checkpoint);
+
+  latticeBoltzmannModel->RestoreFromCheckpoint(checkpoint);
+
+  std::vector<hemelb::distribn_t>::const_iterator ioletState = checkpoint.ioletState.begin();
+  inletValues->RestoreFromCheckpoint(ioletState);
+  outletValues->RestoreFromCheckpoint(ioletState);
+  if (ioletState != checkpoint.ioletState.end())
+  {
+    throw hemelb::Exception() << "Checkpoint " << path << " does not match the inlets and outlets configured";
+  }
+
+  if (colloidController != NULL)
+  {
+    if (!checkpoint.particleValues.empty()
+        && checkpoint.valuesPerParticle != hemelb::colloids::Particle::CheckpointRecordLength)
+    {
+      throw hemelb::Exception() << "Checkpoint " << path << " has " << checkpoint.valuesPerParticle
+          << " values per particle but expected " << hemelb::colloids::Particle::CheckpointRecordLength;
+    }
+    colloidController->RestoreFromCheckpoint(checkpoint.particleValues);
+  }
+
+  simulationState->SetTimeStep(checkpoint.timeStep);
+}
+
 void SimulationMaster::RecalculatePropertyRequirements()
 {
   // Get the property cache & reset its list of properties to get.
@@ -599,10 +816,13 @@ void SimulationMaster::RecalculatePropertyRequirements()
     }
   }
 
-  if (monitoringConfig->doIncompressibilityCheck)
+  // The stability tester (and the incompressibility checker, if any) read the reductions the
+  // streamers accumulate, rather than sweeping the lattice themselves. They only do so on the
+  // iterations when they pass their local results up the tree.
+  if (stabilityTester->IsSendingToParent()
+      || (incompressibilityChecker != NULL && incompressibilityChecker->IsSendingToParent()))
   {
-    propertyCache.densityCache.SetRefreshFlag();
-    propertyCache.velocityCache.SetRefreshFlag();
+    propertyCache.monitoringAccumulator.SetRefreshFlag();
   }
 
   // If extracting property results, check what's required by them.
@@ -611,6 +831,12 @@ void SimulationMaster::RecalculatePropertyRequirements()
     propertyExtractor->SetRequiredProperties(propertyCache);
   }
 
+  // The Windkessel iolets need the velocity for the flow rate through them.
+  if (inletValues->IsFlowRateRequired() || outletValues->IsFlowRateRequired())
+  {
+    propertyCache.velocityCache.SetRefreshFlag();
+  }
+
   // If using streaklines, the velocity will be needed.
 #ifndef NO_STREAKLINES
   propertyCache.velocityCache.SetRefreshFlag();
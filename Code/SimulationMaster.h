@@ -29,6 +29,7 @@
 #include "net/phased/StepManager.h"
 #include "net/phased/NetConcern.h"
 #include "geometry/neighbouring/NeighbouringDataManager.h"
+#include "geometry/decomposition/LoadBalancer.h"
 
 class SimulationMaster
 {
@@ -61,8 +62,17 @@ class SimulationMaster
     hemelb::geometry::neighbouring::NeighbouringDataManager *neighbouringDataManager;
     const hemelb::net::IOCommunicator& ioComms;
 
+    /**
+     * Whether the load balancer finds the time spent on the LB calculation imbalanced enough to
+     * rebalance. Virtual so that tests can force an imbalance. Collective.
+     */
+    virtual bool IsImbalanced();
+    hemelb::geometry::decomposition::LoadBalancer* loadBalancer;
+
   private:
     void Initialise();
+    void CreateSimulationObjects(const std::vector<float>& blockWeightScales);
+    void DeleteSimulationObjects();
     void SetupReporting(); // set up the reporting file
     unsigned int OutputPeriod(unsigned int frequency);
     void HandleActors();
@@ -80,6 +90,31 @@ class SimulationMaster
      */
     void LogStabilityReport();
 
+    /**
+     * Write a checkpoint from which the simulation can be restarted at the next time step.
+     * @return the path of the checkpoint file
+     */
+    std::string WriteCheckpoint();
+
+    /**
+     * Decompose the geometry again, weighted by the load measured on each process, and carry
+     * the simulation on from the next time step on the new decomposition.
+     */
+    void Rebalance();
+
+    /**
+     * Replace the initial conditions with the state saved in a checkpoint.
+     * @param path the checkpoint file
+     */
+    void RestoreFromCheckpoint(const std::string& path);
+
+    /**
+     * Write decomposition weights in proportion to the time taken per site of each collision
+     * type, over all processes, since the LBM was last built.
+     * @param path the site weights file
+     */
+    void WriteSiteWeights(const std::string& path);
+
     hemelb::configuration::SimConfig *simConfig;
     hemelb::io::PathManager* fileManager;
     hemelb::reporting::Timers timings;
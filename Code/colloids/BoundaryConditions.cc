@@ -62,6 +62,11 @@ namespace hemelb
       }
     }
 
+    void BoundaryConditions::SetLatticeData(const geometry::LatticeData* const latticeData)
+    {
+      BoundaryConditions::latticeData = latticeData;
+    }
+
     const bool BoundaryConditions::DoSomeThingsToParticle(
                  const LatticeTimeStep currentTimestep,
                  Particle& particle)
@@ -55,6 +55,9 @@ namespace hemelb
                             const geometry::LatticeData* const latticeData,
                             io::xml::Document& xml);
 
+        /** points the boundary conditions at a new lattice, after the domain is decomposed again */
+        static void SetLatticeData(const geometry::LatticeData* const latticeData);
+
         static const void AddBoundaryCondition(
                             const std::string name,
                             const BoundaryCondition* const);
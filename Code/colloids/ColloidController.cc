@@ -23,6 +23,16 @@ namespace hemelb
       timers[reporting::Timers::colloidOutput].Stop();
     }
 
+    const void ColloidController::SaveToCheckpoint(std::vector<distribn_t>& state) const
+    {
+      particleSet->SaveToCheckpoint(state);
+    }
+
+    const void ColloidController::RestoreFromCheckpoint(const std::vector<distribn_t>& state)
+    {
+      particleSet->RestoreFromCheckpoint(state);
+    }
+
     // destructor
     ColloidController::~ColloidController()
     {
@@ -51,6 +51,12 @@ namespace hemelb
 
         const void OutputInformation(const LatticeTimeStep timestep) const;
 
+        /** appends the records of the locally owned particles to a checkpoint */
+        const void SaveToCheckpoint(std::vector<distribn_t>& state) const;
+
+        /** replaces the particles with those in a checkpoint */
+        const void RestoreFromCheckpoint(const std::vector<distribn_t>& state);
+
       private:
         /** Main code communicator */
         const net::IOCommunicator& ioComms;
@@ -38,6 +38,38 @@ namespace hemelb
           globalPosition.x, globalPosition.y, globalPosition.z);
     }
 
+    Particle::Particle(const geometry::LatticeData& latDatLBM,
+                       const hemelb::lb::LbmParameters *lbmParams,
+                       const distribn_t* checkpointRecord) :
+      PersistedParticle((unsigned long) checkpointRecord[0],
+                        checkpointRecord[1], checkpointRecord[2],
+                        checkpointRecord[5],
+                        LatticePosition(checkpointRecord[6], checkpointRecord[7], checkpointRecord[8])),
+      lbmParams(lbmParams)
+    {
+      lastCheckpointTimestep = (LatticeTimeStep) checkpointRecord[3];
+      markedForDeletionTimestep = (LatticeTimeStep) checkpointRecord[4];
+
+      // as for the xml constructor, this sets the owner rank from the position
+      ownerRank = BIG_NUMBER2;
+      velocity *= 0.0;
+      bodyForces *= 0.0;
+      UpdatePosition(latDatLBM);
+    }
+
+    const void Particle::SaveToCheckpoint(std::vector<distribn_t>& state) const
+    {
+      state.push_back(particleId);
+      state.push_back(smallRadius_a0);
+      state.push_back(largeRadius_ah);
+      state.push_back(lastCheckpointTimestep);
+      state.push_back(markedForDeletionTimestep);
+      state.push_back(mass);
+      state.push_back(globalPosition.x);
+      state.push_back(globalPosition.y);
+      state.push_back(globalPosition.z);
+    }
+
 //    const bool Particle::operator<(const Particle& other) const
 //    {
 //      // ORDER BY isLocal, ownerRank, particleId
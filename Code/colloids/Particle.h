@@ -38,9 +38,20 @@ namespace hemelb
                  const hemelb::lb::LbmParameters *lbmParams,
                  io::xml::Element& xml);
 
+        /** constructor - gets initial values from a record saved by SaveToCheckpoint */
+        Particle(const geometry::LatticeData& latDatLBM,
+                 const hemelb::lb::LbmParameters *lbmParams,
+                 const distribn_t* checkpointRecord);
+
         /** constructor - gets an invalid particle for making MPI data types */
         Particle() {};
 
+        /** the number of values in the record saved by SaveToCheckpoint */
+        static const unsigned CheckpointRecordLength = 9;
+
+        /** for checkpointing - appends all persisted properties to state */
+        const void SaveToCheckpoint(std::vector<distribn_t>& state) const;
+
         /** property getter for particleId */
         const unsigned long GetParticleId() const { return particleId; }
         const LatticePosition& GetGlobalPosition() const { return globalPosition; }
@@ -48,7 +48,8 @@ namespace hemelb
                              std::vector<proc_t>& neighbourProcessors,
                              const net::IOCommunicator& ioComms_,
                              const std::string& outputPath) :
-        ioComms(ioComms_), localRank(ioComms.Rank()), latDatLBM(latDatLBM), propertyCache(propertyCache), path(outputPath), net(ioComms)
+        ioComms(ioComms_), localRank(ioComms.Rank()), latDatLBM(latDatLBM), lbmParams(lbmParams),
+        propertyCache(propertyCache), path(outputPath), net(ioComms)
     {
       /**
        * Open the file, unless it already exists, for writing only, creating it if it doesn't exist.
@@ -107,6 +108,37 @@ namespace hemelb
       particles.clear();
     }
 
+    const void ParticleSet::SaveToCheckpoint(std::vector<distribn_t>& state) const
+    {
+      for (std::vector<Particle>::const_iterator iter = particles.begin(); iter != particles.end(); iter++)
+      {
+        if (iter->GetOwnerRank() == localRank)
+        {
+          iter->SaveToCheckpoint(state);
+        }
+      }
+    }
+
+    const void ParticleSet::RestoreFromCheckpoint(const std::vector<distribn_t>& state)
+    {
+      particles.clear();
+      for (scanMapIterType iterMap = scanMap.begin(); iterMap != scanMap.end(); iterMap++)
+        iterMap->second = scanMapElementType(0, 0);
+
+      // every process is given every record and keeps the particles it owns
+      for (size_t record = 0; record + Particle::CheckpointRecordLength <= state.size();
+           record += Particle::CheckpointRecordLength)
+      {
+        Particle nextParticle(latDatLBM, lbmParams, &state[record]);
+        if (nextParticle.IsValid() && nextParticle.GetOwnerRank() == localRank)
+        {
+          particles.push_back(nextParticle);
+          scanMap[localRank].first++;
+        }
+      }
+      propertyCache.velocityCache.SetRefreshFlag();
+    }
+
     const void ParticleSet::OutputInformation(const LatticeTimeStep timestep)
     {
       // Ensure the buffer is large enough.
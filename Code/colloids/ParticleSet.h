@@ -63,6 +63,12 @@ namespace hemelb
 
         const void OutputInformation(const LatticeTimeStep timestep);
 
+        /** appends the records of the locally owned particles to state */
+        const void SaveToCheckpoint(std::vector<distribn_t>& state) const;
+
+        /** replaces all particles with those from the records in state that are locally owned */
+        const void RestoreFromCheckpoint(const std::vector<distribn_t>& state);
+
       private:
         const net::IOCommunicator& ioComms;
         /** cached copy of local rank (obtained from topology) */
@@ -90,6 +96,9 @@ namespace hemelb
         /** contains useful geometry manipulation functions */
         const geometry::LatticeData& latDatLBM;
 
+        /** supplies the value of tau for new particles */
+        const hemelb::lb::LbmParameters *lbmParams;
+
         /**
          * primary mechanism for interacting with the LB simulation
          * - the velocity cache  : is used for velocity interpolation
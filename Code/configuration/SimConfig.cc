@@ -98,6 +98,16 @@ namespace hemelb
       if (monitoringEl != io::xml::Element::Missing())
         DoIOForMonitoring(monitoringEl);
 
+      // Optional element <checkpoint>
+      io::xml::Element checkpointEl = topNode.GetChildOrNull("checkpoint");
+      if (checkpointEl != io::xml::Element::Missing())
+        DoIOForCheckpoint(checkpointEl);
+
+      // Optional element <rebalance>
+      io::xml::Element rebalanceEl = topNode.GetChildOrNull("rebalance");
+      if (rebalanceEl != io::xml::Element::Missing())
+        DoIOForRebalance(rebalanceEl);
+
     }
 
     void SimConfig::DoIOForSimulation(const io::xml::Element simEl)
@@ -156,11 +166,91 @@ namespace hemelb
       // Required element
       // <geometry>
       //  <datafile path="relative path to GMY" />
+      //  <reading ... /> (optional)
+      //  <decomposition_cache ... /> (optional)
+      //  <decomposition ... /> (optional)
+      //  <site_weights ... /> (optional)
+      //  <site_weights_calibration ... /> (optional)
       // </geometry>
       dataFilePath = geometryEl.GetChildOrThrow("datafile").GetAttributeOrThrow("path");
       // Convert to a full path
       dataFilePath = util::NormalizePathRelativeToPath(dataFilePath, xmlFilePath);
 
+      // Optional element
+      // <reading group_size="unsigned" mode="collective|blockwise" />
+      const io::xml::Element readingEl = geometryEl.GetChildOrNull("reading");
+      if (readingEl != io::xml::Element::Missing())
+      {
+        if (readingEl.GetAttributeOrNull("group_size", geometryReadingConfig.readingGroupSize)
+            && geometryReadingConfig.readingGroupSize < 1)
+        {
+          throw Exception() << "Reading group size must be at least one in " << readingEl.GetPath();
+        }
+
+        const std::string* mode = readingEl.GetAttributeOrNull("mode");
+        if (mode != NULL)
+        {
+          if (*mode != "collective" && *mode != "blockwise")
+          {
+            throw Exception() << "Unrecognised geometry reading mode '" << *mode << "' in "
+                << readingEl.GetPath();
+          }
+          geometryReadingConfig.collective = (*mode == "collective");
+        }
+      }
+
+      // Optional element
+      // <decomposition_cache path="relative path to decomposition file" />
+      const io::xml::Element cacheEl = geometryEl.GetChildOrNull("decomposition_cache");
+      if (cacheEl != io::xml::Element::Missing())
+      {
+        geometryReadingConfig.decompositionCachePath
+            = util::NormalizePathRelativeToPath(cacheEl.GetAttributeOrThrow("path"), xmlFilePath);
+      }
+
+      // Optional element
+      // <decomposition method="parmetis|morton|hilbert" />
+      const io::xml::Element decompositionEl = geometryEl.GetChildOrNull("decomposition");
+      if (decompositionEl != io::xml::Element::Missing())
+      {
+        const std::string& method = decompositionEl.GetAttributeOrThrow("method");
+        if (method == "parmetis")
+        {
+          geometryReadingConfig.decompositionMethod = geometry::decomposition::PARMETIS;
+        }
+        else if (method == "morton")
+        {
+          geometryReadingConfig.decompositionMethod = geometry::decomposition::MORTON_CURVE;
+        }
+        else if (method == "hilbert")
+        {
+          geometryReadingConfig.decompositionMethod = geometry::decomposition::HILBERT_CURVE;
+        }
+        else
+        {
+          throw Exception() << "Unrecognised decomposition method '" << method << "' in "
+              << decompositionEl.GetPath();
+        }
+      }
+
+      // Optional element
+      // <site_weights path="relative path to weights file" />
+      const io::xml::Element weightsEl = geometryEl.GetChildOrNull("site_weights");
+      if (weightsEl != io::xml::Element::Missing())
+      {
+        geometryReadingConfig.siteWeightsPath
+            = util::NormalizePathRelativeToPath(weightsEl.GetAttributeOrThrow("path"), xmlFilePath);
+      }
+
+      // Optional element
+      // <site_weights_calibration path="relative path to write the measured weights to" />
+      const io::xml::Element calibrationEl = geometryEl.GetChildOrNull("site_weights_calibration");
+      if (calibrationEl != io::xml::Element::Missing())
+      {
+        geometryReadingConfig.siteWeightsCalibrationPath
+            = util::NormalizePathRelativeToPath(calibrationEl.GetAttributeOrThrow("path"),
+                                                xmlFilePath);
+      }
     }
 
     void SimConfig::CreateUnitConverter()
@@ -255,6 +345,10 @@ namespace hemelb
       {
         newIolet = DoIOForMultiscalePressureInOutlet(ioletEl);
       }
+      else if (conditionSubtype == "windkessel")
+      {
+        newIolet = DoIOForWindkesselPressureInOutlet(ioletEl);
+      }
       else
       {
         throw Exception() << "Invalid boundary condition subtype '" << conditionSubtype << "' in "
@@ -561,6 +655,41 @@ namespace hemelb
       return newIolet;
     }
 
+    lb::iolets::InOutLetWindkessel* SimConfig::DoIOForWindkesselPressureInOutlet(
+        const io::xml::Element& ioletEl)
+    {
+      lb::iolets::InOutLetWindkessel* newIolet = new lb::iolets::InOutLetWindkessel();
+      DoIOForBaseInOutlet(ioletEl, newIolet);
+
+      const io::xml::Element conditionEl = ioletEl.GetChildOrThrow("condition");
+
+      const io::xml::Element proximalEl = conditionEl.GetChildOrThrow("proximal_resistance");
+      newIolet->SetProximalResistance(GetDimensionalValueInLatticeUnits<LatticeResistance>(proximalEl,
+                                                                                           "Pa*s/m^3"));
+
+      const io::xml::Element distalEl = conditionEl.GetChildOrThrow("distal_resistance");
+      newIolet->SetDistalResistance(GetDimensionalValueInLatticeUnits<LatticeResistance>(distalEl,
+                                                                                         "Pa*s/m^3"));
+
+      const io::xml::Element complianceEl = conditionEl.GetChildOrThrow("compliance");
+      newIolet->SetCompliance(GetDimensionalValueInLatticeUnits<LatticeCompliance>(complianceEl,
+                                                                                   "m^3/Pa"));
+
+      if (newIolet->GetProximalResistance() < 0.0 || newIolet->GetDistalResistance() <= 0.0
+          || newIolet->GetCompliance() <= 0.0)
+      {
+        throw Exception() << "Windkessel resistances and compliance must be positive in "
+            << conditionEl.GetPath();
+      }
+
+      // The distal pressure is an absolute pressure
+      PhysicalPressure distalPressure;
+      GetDimensionalValue(conditionEl.GetChildOrThrow("distal_pressure"), "mmHg", distalPressure);
+      newIolet->SetDistalPressure(unitConverter->ConvertPressureToLatticeUnits(distalPressure));
+
+      return newIolet;
+    }
+
     lb::iolets::InOutLetParabolicVelocity* SimConfig::DoIOForParabolicVelocityInOutlet(
         const io::xml::Element& ioletEl)
     {
@@ -688,6 +817,46 @@ namespace hemelb
           GetDimensionalValueInLatticeUnits<LatticeSpeed>(criterionEl, "m/s");
     }
 
+    void SimConfig::DoIOForCheckpoint(const io::xml::Element& checkpointEl)
+    {
+      // Optional element
+      // <interval value="unsigned" units="lattice" />
+      const io::xml::Element intervalEl = checkpointEl.GetChildOrNull("interval");
+      if (intervalEl != io::xml::Element::Missing())
+      {
+        GetDimensionalValue(intervalEl, "lattice", checkpointConfig.interval);
+      }
+
+      // Optional element
+      // <restart path="relative or absolute path" />
+      const io::xml::Element restartEl = checkpointEl.GetChildOrNull("restart");
+      if (restartEl != io::xml::Element::Missing())
+      {
+        checkpointConfig.restartPath = util::NormalizePathRelativeToPath(restartEl.GetAttributeOrThrow("path"),
+                                                                         xmlFilePath);
+      }
+    }
+
+    void SimConfig::DoIOForRebalance(const io::xml::Element& rebalanceEl)
+    {
+      // Required element
+      // <interval value="unsigned" units="lattice" />
+      GetDimensionalValue(rebalanceEl.GetChildOrThrow("interval"), "lattice", rebalanceConfig.interval);
+
+      // Optional element
+      // <threshold value="float" />
+      const io::xml::Element thresholdEl = rebalanceEl.GetChildOrNull("threshold");
+      if (thresholdEl != io::xml::Element::Missing())
+      {
+        thresholdEl.GetAttributeOrThrow("value", rebalanceConfig.threshold);
+        if (rebalanceConfig.threshold < 1.0)
+        {
+          throw Exception() << "Invalid rebalance threshold " << rebalanceConfig.threshold
+              << ": it must be at least 1";
+        }
+      }
+    }
+
     const SimConfig::MonitoringConfig* SimConfig::GetMonitoringConfiguration() const
     {
       return &monitoringConfig;
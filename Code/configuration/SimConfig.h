@@ -17,6 +17,7 @@
 #include "extraction/PropertyOutputFile.h"
 #include "extraction/GeometrySelectors.h"
 #include "io/xml/XmlAbstractionLayer.h"
+#include "geometry/decomposition/DecompositionMethod.h"
 
 namespace hemelb
 {
@@ -56,6 +57,51 @@ namespace hemelb
             bool doIncompressibilityCheck; ///< Whether to turn on the IncompressibilityChecker or not
         };
 
+        /**
+         * Bundles together the configuration parameters concerning checkpointing and restarting
+         */
+        struct CheckpointConfig
+        {
+            CheckpointConfig() :
+                interval(0)
+            {
+            }
+            LatticeTimeStep interval; ///< Number of time steps between checkpoints (0 for never)
+            std::string restartPath; ///< Checkpoint to restart from (empty to start afresh)
+        };
+
+        /**
+         * Bundles together the configuration parameters concerning rebalancing the load between
+         * processes during a run
+         */
+        struct RebalanceConfig
+        {
+            RebalanceConfig() :
+                interval(0), threshold(1.1)
+            {
+            }
+            LatticeTimeStep interval; ///< Number of time steps between checks of the load balance (0 for never)
+            double threshold; ///< Rebalance when the slowest process takes longer than this multiple of the mean
+        };
+
+        /**
+         * Bundles together the configuration parameters concerning reading the geometry file
+         */
+        struct GeometryReadingConfig
+        {
+            GeometryReadingConfig() :
+                readingGroupSize(HEMELB_READING_GROUP_SIZE), collective(true),
+                    decompositionMethod(geometry::decomposition::PARMETIS)
+            {
+            }
+            proc_t readingGroupSize; ///< Number of ranks that read the geometry file
+            bool collective; ///< Read large byte ranges collectively, rather than block by block
+            std::string decompositionCachePath; ///< File to save the decomposition to and reuse it from (empty for none)
+            geometry::decomposition::DecompositionMethod decompositionMethod; ///< How to improve on the basic decomposition
+            std::string siteWeightsPath; ///< File to read the decomposition weight of each site type from (empty for the compiled-in weights)
+            std::string siteWeightsCalibrationPath; ///< File to write the measured weight of each site type to at the end of the run (empty for none)
+        };
+
         static SimConfig* New(const std::string& path);
 
       protected:
@@ -168,6 +214,33 @@ namespace hemelb
          */
         const MonitoringConfig* GetMonitoringConfiguration() const;
 
+        /**
+         * Return the configuration of checkpointing and restarting
+         * @return checkpoint configuration
+         */
+        const CheckpointConfig& GetCheckpointConfiguration() const
+        {
+          return checkpointConfig;
+        }
+
+        /**
+         * Return the configuration of rebalancing the load during the run
+         * @return rebalancing configuration
+         */
+        const RebalanceConfig& GetRebalanceConfiguration() const
+        {
+          return rebalanceConfig;
+        }
+
+        /**
+         * Return the configuration of reading the geometry file
+         * @return geometry reading configuration
+         */
+        const GeometryReadingConfig& GetGeometryReadingConfiguration() const
+        {
+          return geometryReadingConfig;
+        }
+
       protected:
         /**
          * Create the unit converter - virtual so that mocks can override it.
@@ -212,6 +285,15 @@ namespace hemelb
         lb::iolets::InOutLetFile* DoIOForFilePressureInOutlet(const io::xml::Element& ioletEl);
         lb::iolets::InOutLetMultiscale* DoIOForMultiscalePressureInOutlet(
             const io::xml::Element& ioletEl);
+        /**
+         * Reads a Windkessel pressure iolet definition from the XML config file and returns
+         * an InOutLetWindkessel object
+         *
+         * @param ioletEl in memory representation of <inlet> or <outlet> xml element
+         * @return InOutLetWindkessel object
+         */
+        lb::iolets::InOutLetWindkessel* DoIOForWindkesselPressureInOutlet(
+            const io::xml::Element& ioletEl);
 
         lb::iolets::InOutLet* DoIOForVelocityInOutlet(const io::xml::Element& ioletEl);
         lb::iolets::InOutLetParabolicVelocity* DoIOForParabolicVelocityInOutlet(
@@ -270,6 +352,20 @@ namespace hemelb
          */
         void DoIOForConvergenceCriterion(const io::xml::Element& criterionEl);
 
+        /**
+         * Reads checkpoint configuration from XML file
+         *
+         * @param checkpointEl in memory representation of the <checkpoint> XML element
+         */
+        void DoIOForCheckpoint(const io::xml::Element& checkpointEl);
+
+        /**
+         * Reads load rebalancing configuration from XML file
+         *
+         * @param rebalanceEl in memory representation of the <rebalance> XML element
+         */
+        void DoIOForRebalance(const io::xml::Element& rebalanceEl);
+
         const std::string& xmlFilePath;
         io::xml::Document* rawXmlDoc;
         std::string dataFilePath;
@@ -290,6 +386,9 @@ namespace hemelb
         bool hasColloidSection;
         PhysicalPressure initialPressure_mmHg; ///< Pressure used to initialise the domain
         MonitoringConfig monitoringConfig; ///< Configuration of various checks/tests
+        CheckpointConfig checkpointConfig; ///< Configuration of checkpointing and restarting
+        RebalanceConfig rebalanceConfig; ///< Configuration of rebalancing the load during the run
+        GeometryReadingConfig geometryReadingConfig; ///< Configuration of reading the geometry file
 
       protected:
         // These have to contain pointers because there are multiple derived types that might be
@@ -21,13 +21,28 @@ namespace hemelb
   {
     LocalPropertyOutput::LocalPropertyOutput(IterableDataSource& dataSource,
                                              const PropertyOutputFile* outputSpec,
-                                             const net::IOCommunicator& ioComms) :
+                                             const net::IOCommunicator& ioComms,
+                                             bool append) :
       comms(ioComms), dataSource(dataSource), outputSpec(outputSpec)
     {
+      // Hint that the file is written collectively, so the MPI library can aggregate the data
+      // onto a few cores before it goes to disk. See Chapter 13, page 400 of the MPI 2.2 spec.
+      MPI_Info fileInfo;
+      HEMELB_MPI_CALL(MPI_Info_create, (&fileInfo));
+      std::string buffering = "collective_buffering";
+      std::string bufferingValue = "true";
+      HEMELB_MPI_CALL(MPI_Info_set, (fileInfo,
+          const_cast<char*> (buffering.c_str()),
+          const_cast<char*> (bufferingValue.c_str()))
+      );
+
       // Open the file as write-only, create it if it doesn't exist, don't create if the file
-      // already exists.
-      outputFile = net::MpiFile::Open(comms, outputSpec->filename,
-                                      MPI_MODE_WRONLY | MPI_MODE_CREATE | MPI_MODE_EXCL);
+      // already exists. When appending, the file must already exist.
+      const int mode = append ?
+        MPI_MODE_WRONLY :
+        MPI_MODE_WRONLY | MPI_MODE_CREATE | MPI_MODE_EXCL;
+      outputFile = net::MpiFile::Open(comms, outputSpec->filename, mode, fileInfo);
+      HEMELB_MPI_CALL(MPI_Info_free, (&fileInfo));
       // Count sites on this task
       uint64_t siteCount = 0;
       dataSource.Reset();
@@ -61,38 +76,42 @@ namespace hemelb
         writeLength += 8;
       }
 
-      //! @TODO: These two MPI calls can be replaced with one
-
-      // Everyone needs to know the total length written during one iteration.
-      allCoresWriteLength = comms.AllReduce(writeLength, MPI_SUM);
-
-      // Only the root process needs to know the total number of sites written
-      // Note this has a garbage value on other procs.
-      uint64_t allSiteCount = comms.Reduce(siteCount, MPI_SUM,
-                                           comms.GetIORank());
-
-      unsigned totalHeaderLength = 0;
+      // Everyone needs to know the total length written during one iteration, and the IO proc
+      // needs the total number of sites written, so sum both at once.
+      std::vector<uint64_t> localCounts(2);
+      localCounts[0] = writeLength;
+      localCounts[1] = siteCount;
+      const std::vector<uint64_t> allCounts = comms.AllReduce(localCounts, MPI_SUM);
+      allCoresWriteLength = allCounts[0];
+      const uint64_t allSiteCount = allCounts[1];
+
+      // Compute the length of the field header
+      unsigned fieldHeaderLength = 0;
+      for (unsigned outputNumber = 0; outputNumber < outputSpec->fields.size(); ++outputNumber)
+      {
+        // Name
+        fieldHeaderLength
+            += io::formats::extraction::GetStoredLengthOfString(outputSpec->fields[outputNumber].name);
+        // Uint32 for number of fields
+        fieldHeaderLength += 4;
+        // Double for the offset in each field
+        fieldHeaderLength += 8;
+      }
+      const unsigned totalHeaderLength = io::formats::extraction::MainHeaderLength + fieldHeaderLength;
 
+      // Each iteration is a self-contained record of (position, fields) tuples, so a file begun
+      // under one decomposition can be continued under another: the record length depends only
+      // on the total site count.
+      uint64_t dataStart = totalHeaderLength;
+      if (append)
+      {
+        dataStart = outputFile.GetSize();
+      }
       // Write the header information on the IO proc.
-      if (comms.OnIORank())
+      else if (comms.OnIORank())
       {
-        // Compute the length of the field header
-        unsigned fieldHeaderLength = 0;
-        for (unsigned outputNumber = 0; outputNumber < outputSpec->fields.size(); ++outputNumber)
-        {
-          // Name
-          fieldHeaderLength
-              += io::formats::extraction::GetStoredLengthOfString(outputSpec->fields[outputNumber].name);
-          // Uint32 for number of fields
-          fieldHeaderLength += 4;
-          // Double for the offset in each field
-          fieldHeaderLength += 8;
-        }
-
         // Create a header buffer
-        totalHeaderLength = io::formats::extraction::MainHeaderLength + fieldHeaderLength;
         std::vector<char> headerBuffer(totalHeaderLength);
-
         {
           // Encoder for ONLY the main header (note shorter length)
           io::writers::xdr::XdrMemWriter
@@ -131,28 +150,9 @@ namespace hemelb
         outputFile.WriteAt(0, headerBuffer);
       }
 
-      // Calculate where each core should start writing
-      if (comms.OnIORank())
-      {
-        // For core 0 this is easy: it passes the value for core 1 to the core.
-        localDataOffsetIntoFile = totalHeaderLength;
-
-        if (comms.Size() > 1)
-        {
-          comms.Send(localDataOffsetIntoFile+writeLength, 1, 1);
-        }
-      }
-      else
-      {
-        // Receive the writing start position from the previous core.
-        comms.Receive(localDataOffsetIntoFile, comms.Rank()-1, 1);
-
-        // Send the next core its start position.
-        if (comms.Rank() != (comms.Size() - 1))
-        {
-          comms.Send(localDataOffsetIntoFile+writeLength, comms.Rank() + 1, 1);
-        }
-      }
+      // Each core starts writing after the header and the data of all lower ranks (the IO
+      // proc is the first rank).
+      localDataOffsetIntoFile = dataStart + comms.ExclusiveScan(writeLength, MPI_SUM);
 
       // Create the buffer that we'll write each iteration's data into.
       buffer.resize(writeLength);
@@ -181,9 +181,12 @@ namespace hemelb
         return;
       }
 
-      // Don't write if this core doesn't do anything.
+      // Don't fill the buffer if this core doesn't do anything, but still take part in the
+      // collective write.
       if (writeLength <= 0)
       {
+        outputFile.WriteAtAll(localDataOffsetIntoFile, buffer);
+        localDataOffsetIntoFile += allCoresWriteLength;
         return;
       }
 
@@ -266,8 +269,9 @@ namespace hemelb
         }
       }
 
-      // Actually do the MPI writing.
-      outputFile.WriteAt(localDataOffsetIntoFile, buffer);
+      // Actually do the MPI writing, collectively so that the MPI library can gather the data
+      // into a few large writes.
+      outputFile.WriteAtAll(localDataOffsetIntoFile, buffer);
 
       // Set the offset to the right place for writing on the next iteration.
       localDataOffsetIntoFile += allCoresWriteLength;
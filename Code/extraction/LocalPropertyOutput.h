@@ -33,9 +33,11 @@ namespace hemelb
          * Initialises a LocalPropertyOutput. Required so we can use const reference types.
          * @param file
          * @param offset
+         * @param append if true, the file already holds a header and some iterations (written
+         * under a different decomposition) and new iterations are written after them.
          * @return
          */
-        LocalPropertyOutput(IterableDataSource& dataSource, const PropertyOutputFile* outputSpec, const net::IOCommunicator& ioComms);
+        LocalPropertyOutput(IterableDataSource& dataSource, const PropertyOutputFile* outputSpec, const net::IOCommunicator& ioComms, bool append = false);
 
         /**
          * Tidies up the LocalPropertyOutput (close files etc).
@@ -17,10 +17,11 @@ namespace hemelb
                                  const std::vector<PropertyOutputFile*>& propertyOutputs,
                                  IterableDataSource& dataSource,
                                  reporting::Timers& timers,
-                                 const net::IOCommunicator& ioComms) :
+                                 const net::IOCommunicator& ioComms,
+                                 bool append) :
         simulationState(simulationState), timers(timers)
     {
-      propertyWriter = new PropertyWriter(dataSource, propertyOutputs, ioComms);
+      propertyWriter = new PropertyWriter(dataSource, propertyOutputs, ioComms, append);
     }
 
     PropertyActor::~PropertyActor()
@@ -28,13 +28,16 @@ namespace hemelb
          * @param simulationState
          * @param propertyOutputs
          * @param dataSource
+         * @param append whether to continue files written by an earlier PropertyActor (e.g. before
+         * a rebalance) rather than create them
          * @return
          */
         PropertyActor(const lb::SimulationState& simulationState,
                       const std::vector<PropertyOutputFile*>& propertyOutputs,
                       IterableDataSource& dataSource,
                       reporting::Timers& timers,
-                      const net::IOCommunicator& ioComms);
+                      const net::IOCommunicator& ioComms,
+                      bool append = false);
 
         ~PropertyActor();
 
@@ -15,11 +15,12 @@ namespace hemelb
   {
     PropertyWriter::PropertyWriter(IterableDataSource& dataSource,
                                    const std::vector<PropertyOutputFile*>& propertyOutputs,
-                                   const net::IOCommunicator& ioComms)
+                                   const net::IOCommunicator& ioComms,
+                                   bool append)
     {
       for (unsigned outputNumber = 0; outputNumber < propertyOutputs.size(); ++outputNumber)
       {
-        localPropertyOutputs.push_back(new LocalPropertyOutput(dataSource, propertyOutputs[outputNumber], ioComms));
+        localPropertyOutputs.push_back(new LocalPropertyOutput(dataSource, propertyOutputs[outputNumber], ioComms, append));
       }
     }
 
@@ -24,9 +24,10 @@ namespace hemelb
         /**
          * Constructor, takes a vector of the output files to create.
          * @param propertyOutputs
+         * @param append whether to append to existing output files instead of creating them
          * @return
          */
-        PropertyWriter(IterableDataSource& dataSource, const std::vector<PropertyOutputFile*>& propertyOutputs, const net::IOCommunicator& ioComms);
+        PropertyWriter(IterableDataSource& dataSource, const std::vector<PropertyOutputFile*>& propertyOutputs, const net::IOCommunicator& ioComms, bool append = false);
 
         /**
          * Destructor; deallocates memory used to store property info.
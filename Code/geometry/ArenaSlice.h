@@ -0,0 +1,100 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+
+#ifndef HEMELB_GEOMETRY_ARENASLICE_H
+#define HEMELB_GEOMETRY_ARENASLICE_H
+
+#include <cstddef>
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    /**
+     * A run of consecutive elements in storage owned by someone else (for the geometry read
+     * from file, one of the Geometry's arenas). Copying a slice doesn't copy the elements, so
+     * the owner has to rebase its slices whenever it moves the storage.
+     */
+    template<typename T>
+    class ArenaSlice
+    {
+      public:
+        //! An empty slice.
+        ArenaSlice() :
+            first(NULL), count(0)
+        {
+        }
+
+        ArenaSlice(T* first, size_t count) :
+            first(first), count(count)
+        {
+        }
+
+        size_t size() const
+        {
+          return count;
+        }
+
+        bool empty() const
+        {
+          return count == 0;
+        }
+
+        T& operator[](size_t index)
+        {
+          return first[index];
+        }
+
+        const T& operator[](size_t index) const
+        {
+          return first[index];
+        }
+
+        T* begin()
+        {
+          return first;
+        }
+
+        const T* begin() const
+        {
+          return first;
+        }
+
+        T* end()
+        {
+          return first + count;
+        }
+
+        const T* end() const
+        {
+          return first + count;
+        }
+
+        /**
+         * Point the slice at the same position in a copy of the storage it is in.
+         * @param oldBase Start of the storage the slice is in at the moment
+         * @param newBase Start of the copy
+         */
+        void Rebase(const T* oldBase, T* newBase)
+        {
+          if (first != NULL)
+          {
+            first = newBase + (first - oldBase);
+          }
+        }
+
+      private:
+        T* first;
+        size_t count;
+    };
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_ARENASLICE_H */
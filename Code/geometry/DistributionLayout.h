@@ -0,0 +1,122 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#ifndef HEMELB_GEOMETRY_DISTRIBUTIONLAYOUT_H
+#define HEMELB_GEOMETRY_DISTRIBUTIONLAYOUT_H
+
+#include "units.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    /**
+     * The following classes describe how the distributions of the local fluid sites are laid
+     * out in the fOld / fNew arrays of LatticeData. Their names must correspond to the options
+     * given for the CMake HEMELB_DISTRIBUTION_LAYOUT parameter.
+     *
+     * Each provides
+     *  - SiteContiguous, true if all the distributions of one site are adjacent in memory,
+     *  - GetPaddedSiteCount(siteCount), the number of site slots to allocate for siteCount sites,
+     *  - GetIndex(siteIndex, direction, numVectors, paddedSiteCount), the position in the array
+     *      of the distribution of site siteIndex in the given direction.
+     *
+     * Whatever the layout, the rubbish site and the distributions shared with neighbouring ranks
+     * follow the paddedSiteCount * numVectors site distributions contiguously, so the halo
+     * exchange is unaffected by the choice.
+     */
+
+    /**
+     * Array-of-structures: f[site * NUMVECTORS + direction]. This is the traditional layout.
+     */
+    struct AOS
+    {
+        static const bool SiteContiguous = true;
+
+        inline static site_t GetPaddedSiteCount(site_t siteCount)
+        {
+          return siteCount;
+        }
+
+        inline static site_t GetIndex(site_t siteIndex,
+                                      Direction direction,
+                                      unsigned numVectors,
+                                      site_t paddedSiteCount)
+        {
+          return siteIndex * numVectors + direction;
+        }
+    };
+
+    /**
+     * Structure-of-arrays: f[direction * paddedSiteCount + site]. Consecutive sites have
+     * consecutive distributions in each direction, so streaming along a range of sites writes
+     * to a handful of streams rather than a different cache line per link.
+     */
+    struct SOA
+    {
+        static const bool SiteContiguous = false;
+
+        inline static site_t GetPaddedSiteCount(site_t siteCount)
+        {
+          return siteCount;
+        }
+
+        inline static site_t GetIndex(site_t siteIndex,
+                                      Direction direction,
+                                      unsigned numVectors,
+                                      site_t paddedSiteCount)
+        {
+          return direction * paddedSiteCount + siteIndex;
+        }
+    };
+
+    /**
+     * Array-of-structures-of-arrays: sites are grouped into blocks of
+     * HEMELB_DISTRIBUTION_BLOCK_SIZE, within each of which the layout is SOA. This keeps the
+     * vector-friendly access pattern of SOA while keeping the distributions of one site within a
+     * few cache lines of each other.
+     */
+    struct AOSOA
+    {
+        static const bool SiteContiguous = false;
+        static const site_t BlockSize = HEMELB_DISTRIBUTION_BLOCK_SIZE;
+
+        inline static site_t GetPaddedSiteCount(site_t siteCount)
+        {
+          return ( (siteCount + BlockSize - 1) / BlockSize) * BlockSize;
+        }
+
+        inline static site_t GetIndex(site_t siteIndex,
+                                      Direction direction,
+                                      unsigned numVectors,
+                                      site_t paddedSiteCount)
+        {
+          return (siteIndex / BlockSize) * BlockSize * numVectors + direction * BlockSize + siteIndex % BlockSize;
+        }
+    };
+
+    // Use the layout specified through the build system.
+    typedef HEMELB_DISTRIBUTION_LAYOUT DistributionLayout;
+
+    /**
+     * Whether the distributions a site reads at the start of a step can be pointed at directly.
+     * Streaming in place (the AA pattern) leaves half of them in the neighbours' slots after
+     * every other step, so they must always be gathered. So must distributions stored at a
+     * lower precision than the arithmetic, which are converted as they are gathered.
+     */
+#ifdef HEMELB_USE_AA_PATTERN
+    const bool SiteFOldContiguous = false;
+#else
+    const bool SiteFOldContiguous = DistributionLayout::SiteContiguous
+        && DistributionPrecision::StorageIsArithmetic;
+#endif
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_DISTRIBUTIONLAYOUT_H */
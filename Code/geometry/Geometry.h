@@ -13,6 +13,7 @@
 #include <vector>
 #include "units.h"
 #include "constants.h"
+#include "Exception.h"
 #include "geometry/GeometryBlock.h"
 #include "util/utilityFunctions.h"
 #include "util/Vector3D.h"
@@ -22,7 +23,11 @@ namespace hemelb
   namespace geometry
   {
     /***
-     * Model of the information in a geometry file
+     * Model of the information in a geometry file.
+     *
+     * The sites of all blocks read in, and the links of all their fluid sites, are kept in two
+     * flat arenas sized up front by ReserveSiteStorage, so loading doesn't make an allocation per
+     * site and the whole lot is freed in one go with the Geometry.
      */
     class Geometry
     {
@@ -34,11 +39,86 @@ namespace hemelb
                  site_t blockSize) :
             dimensionsInBlocks(dimensionsInBlocks), blockSize(blockSize), blockCount(dimensionsInBlocks.x
                 * dimensionsInBlocks.y * dimensionsInBlocks.z), sitesPerBlock(util::NumericalFunctions::IntegerPower(blockSize,
-                                                                                                                     3)), Blocks(blockCount)
+                                                                                                                     3)), Blocks(blockCount),
+            sitesUsed(0), linksUsed(0)
         {
 
         }
 
+        /**
+         * Copy constructor. The arenas are copied, so the slices are pointed at the copies.
+         */
+        Geometry(const Geometry& other) :
+            dimensionsInBlocks(other.dimensionsInBlocks), blockSize(other.blockSize),
+                blockCount(other.blockCount), sitesPerBlock(other.sitesPerBlock), Blocks(other.Blocks),
+                siteArena(other.siteArena), linkArena(other.linkArena), sitesUsed(other.sitesUsed),
+                linksUsed(other.linksUsed)
+        {
+          for (site_t block = 0; block < blockCount; ++block)
+          {
+            Blocks[block].Sites.Rebase(other.siteArena.empty() ? NULL : &other.siteArena.front(),
+                                       siteArena.empty() ? NULL : &siteArena.front());
+          }
+          for (size_t site = 0; site < sitesUsed; ++site)
+          {
+            siteArena[site].links.Rebase(other.linkArena.empty() ? NULL : &other.linkArena.front(),
+                                         linkArena.empty() ? NULL : &linkArena.front());
+          }
+        }
+
+        /**
+         * Discard the sites of every block, and make room for the sites of the given number of
+         * blocks, of which the given number are fluid.
+         *
+         * @param blocksToStore The number of blocks that will be given sites
+         * @param fluidSites The total number of fluid sites on those blocks
+         * @param linksPerSite The number of links stored for each fluid site
+         */
+        void ReserveSiteStorage(site_t blocksToStore, site_t fluidSites, Direction linksPerSite)
+        {
+          for (site_t block = 0; block < blockCount; ++block)
+          {
+            Blocks[block].Sites = ArenaSlice<GeometrySite>();
+          }
+
+          // Swap with new vectors, to give back the memory of the previous read.
+          std::vector<GeometrySite>(blocksToStore * sitesPerBlock, GeometrySite(false)).swap(siteArena);
+          std::vector<GeometrySiteLink>(fluidSites * linksPerSite).swap(linkArena);
+          sitesUsed = 0;
+          linksUsed = 0;
+        }
+
+        /**
+         * Give a block its sites from the site arena, initially all solid.
+         * @param block
+         */
+        void AllocateBlockSites(site_t block)
+        {
+          if (sitesUsed + size_t(sitesPerBlock) > siteArena.size())
+          {
+            throw Exception() << "More blocks read in than there is storage reserved for";
+          }
+          Blocks[block].Sites = ArenaSlice<GeometrySite>(&siteArena[sitesUsed], sitesPerBlock);
+          sitesUsed += sitesPerBlock;
+        }
+
+        /**
+         * Take links from the link arena, initially without intersections, for one or more fluid
+         * sites.
+         * @param linkCount
+         * @return The links
+         */
+        ArenaSlice<GeometrySiteLink> AllocateLinks(size_t linkCount)
+        {
+          if (linksUsed + linkCount > linkArena.size())
+          {
+            throw Exception() << "More fluid sites read in than there is storage reserved for";
+          }
+          ArenaSlice<GeometrySiteLink> links(linkCount == 0 ? NULL : &linkArena[linksUsed], linkCount);
+          linksUsed += linkCount;
+          return links;
+        }
+
         /***
          * Returns the total count of blocks in the bounding box of the geometry.
          * @return count of blocks in the geometry.
@@ -123,6 +203,13 @@ namespace hemelb
         }
 
       private:
+        /**
+         * Not assignable: the slices would have to be rebased as in the copy constructor, and the
+         * dimensions are fixed at construction. Declared but not defined so assignment fails to
+         * compile.
+         */
+        Geometry& operator=(const Geometry& other);
+
         const util::Vector3D<site_t> dimensionsInBlocks; //! The count of blocks in each direction
         const site_t blockSize; //! Size of a block, in sites.
 
@@ -132,6 +219,12 @@ namespace hemelb
       public:
         std::vector<BlockReadResult> Blocks; //! Array of Block models
 
+      private:
+        std::vector<GeometrySite> siteArena; //! The sites of every block read in
+        std::vector<GeometrySiteLink> linkArena; //! The links of every fluid site read in
+        size_t sitesUsed; //! Number of sites in the arena given to blocks so far
+        size_t linksUsed; //! Number of links in the arena given to sites so far
+
     };
 
   }
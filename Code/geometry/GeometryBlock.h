@@ -10,7 +10,7 @@
 #ifndef HEMELB_GEOMETRY_GEOMETRYBLOCK_H
 #define HEMELB_GEOMETRY_GEOMETRYBLOCK_H
 
-#include <vector>
+#include "geometry/ArenaSlice.h"
 #include "geometry/GeometrySite.h"
 
 namespace hemelb
@@ -19,12 +19,13 @@ namespace hemelb
   {
     /***
      * Model of the information stored for a block in a geometry file.
-     * Just gives the array of sites
+     * Just gives the array of sites, which lives in the site arena of the Geometry. Empty unless
+     * the block has been read in on this core.
      */
     struct BlockReadResult
     {
       public:
-        std::vector<GeometrySite> Sites;
+        ArenaSlice<GeometrySite> Sites;
     };
   }
 }
@@ -11,12 +11,21 @@
 #include <list>
 #include <map>
 #include <algorithm>
+#include <cstring>
+#include <sstream>
 #include <zlib.h>
+#ifdef HEMELB_USE_OPENMP
+#include <omp.h>
+#endif
+#ifdef HEMELB_USE_LZ4
+#include <lz4.h>
+#endif
 
 #include "debug/Debugger.h"
 #include "io/formats/geometry.h"
 #include "io/writers/xdr/XdrMemReader.h"
 #include "geometry/decomposition/BasicDecomposition.h"
+#include "geometry/decomposition/DecompositionCache.h"
 #include "geometry/decomposition/OptimisedDecomposition.h"
 #include "geometry/GeometryReader.h"
 #include "lb/lattices/D3Q27.h"
@@ -29,12 +38,111 @@ namespace hemelb
 {
   namespace geometry
   {
+    namespace
+    {
+      /**
+       * Fold some bytes into a 64-bit FNV-1a hash.
+       */
+      uint64_t HashBytes(const std::vector<char>& bytes, uint64_t hash)
+      {
+        for (std::vector<char>::const_iterator it = bytes.begin(); it != bytes.end(); ++it)
+        {
+          hash ^= (unsigned char) *it;
+          hash *= 1099511628211ULL;
+        }
+        return hash;
+      }
+
+      /**
+       * Copies the little-endian arrays making up a block of a columnar format geometry file out
+       * of the decompressed data, checking that they fit.
+       */
+      class ColumnarBlockReader
+      {
+        public:
+          ColumnarBlockReader(const std::vector<char>& data) :
+              next(data.empty() ?
+                NULL :
+                &data.front()), end(next + data.size())
+          {
+          }
+
+          const unsigned char* ReadBytes(size_t count)
+          {
+            CheckRemaining(count);
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(next);
+            next += count;
+            return bytes;
+          }
+
+          template<typename T>
+          void ReadArray(std::vector<T>& values, size_t count)
+          {
+            CheckRemaining(count * sizeof(T));
+            values.resize(count);
+            if (count > 0)
+            {
+              std::memcpy(&values.front(), next, count * sizeof(T));
+              next += count * sizeof(T);
+            }
+
+            // Nothing more to do on little-endian hosts.
+            const uint16_t one = 1;
+            if (*reinterpret_cast<const unsigned char*>(&one) != 1)
+            {
+              for (size_t ii = 0; ii < count; ++ii)
+              {
+                unsigned char* bytes = reinterpret_cast<unsigned char*>(&values[ii]);
+                std::reverse(bytes, bytes + sizeof(T));
+              }
+            }
+          }
+
+          bool AtEnd() const
+          {
+            return next == end;
+          }
+
+        private:
+          void CheckRemaining(size_t bytes) const
+          {
+            if (size_t(end - next) < bytes)
+            {
+              throw Exception() << "Malformed GMY file, a block is shorter than its contents.";
+            }
+          }
+
+          const char* next;
+          const char* end;
+      };
+    }
 
     GeometryReader::GeometryReader(const bool reserveSteeringCore,
                                    const lb::lattices::LatticeInfo& latticeInfo,
-                                   reporting::Timers &atimings, const net::IOCommunicator& ioComm) :
-      latticeInfo(latticeInfo), hemeLbComms(ioComm), timings(atimings)
+                                   reporting::Timers &atimings, const net::IOCommunicator& ioComm,
+                                   const configuration::SimConfig::GeometryReadingConfig& readingConfig) :
+      readingConfig(readingConfig), siteWeights(readingConfig.siteWeightsPath), latticeInfo(latticeInfo),
+          formatVersion(io::formats::geometry::VersionNumber),
+          codec(io::formats::geometry::CODEC_ZLIB), geometryHash(0), hemeLbComms(ioComm),
+          timings(atimings)
     {
+      // Match each displacement in the file's neighbourhood to a direction of the lattice in use,
+      // once, rather than for every link of every site.
+      const io::formats::geometry::DisplacementVector& neighbourhood =
+          io::formats::geometry::Get().GetNeighbourhood();
+      latticeDirectionForFileDirection.resize(neighbourhood.size(), 0);
+      for (Direction readDirection = 0; readDirection < neighbourhood.size(); readDirection++)
+      {
+        for (Direction usedLatticeDirection = 1; usedLatticeDirection < latticeInfo.GetNumVectors(); usedLatticeDirection++)
+        {
+          if (latticeInfo.GetVector(usedLatticeDirection) == neighbourhood[readDirection])
+          {
+            latticeDirectionForFileDirection[readDirection] = usedLatticeDirection;
+            break;
+          }
+        }
+      }
+
       // This rank should participate in the domain decomposition if
       //  - there's no steering core (then all ranks are involved)
       //  - we're not on core 0 (the only core that might ever not participate)
@@ -64,7 +172,8 @@ namespace hemelb
     {
     }
 
-    Geometry GeometryReader::LoadAndDecompose(const std::string& dataFilePath)
+    Geometry GeometryReader::LoadAndDecompose(const std::string& dataFilePath,
+                                              const std::vector<float>& blockWeightScales)
     {
       log::Logger::Log<log::Debug, log::OnePerCore>("Starting file read timer");
       timings[hemelb::reporting::Timers::fileRead].Start();
@@ -108,6 +217,12 @@ namespace hemelb
       log::Logger::Log<log::Debug, log::OnePerCore>("Beginning initial decomposition");
       principalProcForEachBlock.resize(geometry.GetBlockCount());
 
+      // A decomposition saved by an earlier run on the same geometry stands in for both the basic
+      // decomposition and its optimisation.
+      bool haveCachedDecomposition = false;
+      std::vector<idx_t> cachedMovesPerProc;
+      std::vector<idx_t> cachedMovesList;
+
       if (!participateInTopology)
       {
         // If we are the steering core, mark them all as unknown.
@@ -118,17 +233,33 @@ namespace hemelb
       }
       else
       {
-        // Get an initial base-level decomposition of the domain macro-blocks over processors.
-        // This will later be improved upon by ParMetis.
-        decomposition::BasicDecomposition basicDecomposer(geometry,
-                                                          latticeInfo,
-                                                          computeComms,
-                                                          fluidSitesOnEachBlock);
-        basicDecomposer.Decompose(principalProcForEachBlock);
+        if (!readingConfig.decompositionCachePath.empty() && blockWeightScales.empty())
+        {
+          decomposition::DecompositionCache cache(computeComms,
+                                                  readingConfig.decompositionCachePath,
+                                                  latticeInfo.GetNumVectors(),
+                                                  readingConfig.decompositionMethod,
+                                                  geometryHash,
+                                                  geometry.GetBlockCount());
+          haveCachedDecomposition = cache.Read(principalProcForEachBlock,
+                                               cachedMovesPerProc,
+                                               cachedMovesList);
+        }
 
-        if (ShouldValidate())
+        if (!haveCachedDecomposition)
         {
-          basicDecomposer.Validate(principalProcForEachBlock);
+          // Get an initial base-level decomposition of the domain macro-blocks over processors.
+          // This will later be improved upon by ParMetis.
+          decomposition::BasicDecomposition basicDecomposer(geometry,
+                                                            latticeInfo,
+                                                            computeComms,
+                                                            fluidSitesOnEachBlock);
+          basicDecomposer.Decompose(principalProcForEachBlock);
+
+          if (ShouldValidate())
+          {
+            basicDecomposer.Validate(principalProcForEachBlock);
+          }
         }
       }
       timings[hemelb::reporting::Timers::initialDecomposition].Stop();
@@ -141,11 +272,15 @@ namespace hemelb
         // local to this node.
         file = net::MpiFile::Open(computeComms, dataFilePath, MPI_MODE_RDONLY, fileInfo);
 
-        ReadInBlocksWithHalo(geometry, principalProcForEachBlock, computeComms.Rank());
-
-        if (ShouldValidate())
+        // With a cached decomposition, we only need to read the blocks once, after applying it.
+        if (!haveCachedDecomposition)
         {
-          ValidateGeometry(geometry);
+          ReadInBlocksWithHalo(geometry, principalProcForEachBlock, computeComms.Rank());
+
+          if (ShouldValidate())
+          {
+            ValidateGeometry(geometry);
+          }
         }
       }
 
@@ -158,9 +293,22 @@ namespace hemelb
       // domain decomposition.
       if (participateInTopology)
       {
-        log::Logger::Log<log::Debug, log::OnePerCore>("Beginning domain decomposition optimisation");
-        OptimiseDomainDecomposition(geometry, principalProcForEachBlock);
-        log::Logger::Log<log::Debug, log::OnePerCore>("Ending domain decomposition optimisation");
+        if (haveCachedDecomposition)
+        {
+          log::Logger::Log<log::Debug, log::OnePerCore>("Applying cached domain decomposition");
+          ApplyDecomposition(geometry,
+                             principalProcForEachBlock,
+                             cachedMovesPerProc,
+                             cachedMovesList);
+        }
+        else
+        {
+          log::Logger::Log<log::Debug, log::OnePerCore>("Beginning domain decomposition optimisation");
+          OptimiseDomainDecomposition(geometry, principalProcForEachBlock, blockWeightScales);
+          log::Logger::Log<log::Debug, log::OnePerCore>("Ending domain decomposition optimisation");
+        }
+
+        ReportEdgeCut(geometry);
 
         if (ShouldValidate())
         {
@@ -196,6 +344,7 @@ namespace hemelb
     {
       const unsigned preambleBytes = io::formats::geometry::PreambleLength;
       std::vector<char> preambleBuffer = ReadOnAllTasks(preambleBytes);
+      geometryHash = HashBytes(preambleBuffer, 14695981039346656037ULL);
 
       // Create an Xdr translator based on the read-in data.
       io::writers::xdr::XdrReader preambleReader = io::writers::xdr::XdrMemReader(&preambleBuffer[0],
@@ -223,34 +372,46 @@ namespace hemelb
             << " Actual: " << gmyMagicNumber;
       }
 
-      if (version != io::formats::geometry::VersionNumber)
+      if (version != io::formats::geometry::VersionNumber
+          && version != io::formats::geometry::ColumnarVersionNumber)
       {
         throw Exception() << "Version number incorrect."
             << " Supported: " << unsigned(io::formats::geometry::VersionNumber)
+            << " and " << unsigned(io::formats::geometry::ColumnarVersionNumber)
             << " Input: " << version;
       }
+      formatVersion = version;
 
       // Variables we'll read.
       // We use temporary vars here, as they must be the same size as the type in the file
       // regardless of the internal type used.
       unsigned int blocksX, blocksY, blocksZ, blockSize;
-      double voxelSize;
-      util::Vector3D<double> origin;
 
       // Read in the values.
       preambleReader.readUnsignedInt(blocksX);
       preambleReader.readUnsignedInt(blocksY);
       preambleReader.readUnsignedInt(blocksZ);
       preambleReader.readUnsignedInt(blockSize);
-      preambleReader.readDouble(voxelSize);
-      for (unsigned int i = 0; i < 3; ++i)
-      {
-        preambleReader.readDouble(origin[i]);
-      }
 
-      // Read the padding unsigned int.
+      // Read the padding unsigned int, which gives the codec in columnar files.
       unsigned paddingValue;
       preambleReader.readUnsignedInt(paddingValue);
+      codec = io::formats::geometry::CODEC_ZLIB;
+      if (formatVersion == io::formats::geometry::ColumnarVersionNumber)
+      {
+        codec = paddingValue;
+        if (codec != io::formats::geometry::CODEC_ZLIB && codec != io::formats::geometry::CODEC_LZ4)
+        {
+          throw Exception() << "Unknown geometry block codec " << codec;
+        }
+#ifndef HEMELB_USE_LZ4
+        if (codec == io::formats::geometry::CODEC_LZ4)
+        {
+          throw Exception() << "The geometry file is LZ4 compressed, but HemeLB was built without "
+              << "LZ4 support (HEMELB_USE_LZ4)";
+        }
+#endif
+      }
 
       return Geometry(util::Vector3D<site_t>(blocksX, blocksY, blocksZ),
                       blockSize);
@@ -266,6 +427,16 @@ namespace hemelb
     {
       site_t headerByteCount = GetHeaderLength(blockCount);
       std::vector<char> headerBuffer = ReadOnAllTasks(headerByteCount);
+      geometryHash = HashBytes(headerBuffer, geometryHash);
+
+      // A decomposition made with different site weights mustn't be reused from the cache.
+      std::ostringstream weights;
+      for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+      {
+        weights << siteWeights[collisionType] << ' ';
+      }
+      const std::string weightsString = weights.str();
+      geometryHash = HashBytes(std::vector<char>(weightsString.begin(), weightsString.end()), geometryHash);
 
       // Create a Xdr translation object to translate from binary
       hemelb::io::writers::xdr::XdrReader preambleReader =
@@ -309,25 +480,51 @@ namespace hemelb
         // Validate the uncompressed length of the block on disk fits out expectations.
         for (site_t block = 0; block < geometry.GetBlockCount(); ++block)
         {
-          if (bytesPerUncompressedBlock[block]
-              > io::formats::geometry::GetMaxBlockRecordLength(geometry.GetBlockSize(),
-                                                               fluidSitesOnEachBlock[block]))
+          const unsigned maxBlockLength = formatVersion == io::formats::geometry::ColumnarVersionNumber ?
+            io::formats::geometry::GetMaxColumnarBlockLength(geometry.GetBlockSize(),
+                                                             fluidSitesOnEachBlock[block]) :
+            io::formats::geometry::GetMaxBlockRecordLength(geometry.GetBlockSize(),
+                                                           fluidSitesOnEachBlock[block]);
+          if (bytesPerUncompressedBlock[block] > maxBlockLength)
           {
             log::Logger::Log<log::Critical, log::OnePerCore>("Block %i is %i bytes when the longest possible block should be %i bytes",
                                                              block,
                                                              bytesPerUncompressedBlock[block],
-                                                             io::formats::geometry::GetMaxBlockRecordLength(geometry.GetBlockSize(),
-                                                                                                            fluidSitesOnEachBlock[block]));
+                                                             maxBlockLength);
           }
         }
       }
 
+      // Make room for all the blocks we're going to read in one go. This discards anything read
+      // before, and the blocks we no longer need are left empty.
+      site_t blocksToStore = 0;
+      site_t fluidSitesToStore = 0;
+      for (site_t block = 0; block < geometry.GetBlockCount(); ++block)
+      {
+        if (readBlock[block] && fluidSitesOnEachBlock[block] > 0)
+        {
+          ++blocksToStore;
+          fluidSitesToStore += fluidSitesOnEachBlock[block];
+        }
+      }
+      geometry.ReserveSiteStorage(blocksToStore, fluidSitesToStore, latticeInfo.GetNumVectors() - 1);
+
+      if (readingConfig.collective)
+      {
+        timings[hemelb::reporting::Timers::readBlocksPrelim].Stop();
+        log::Logger::Log<log::Debug, log::OnePerCore>("Reading blocks collectively");
+        timings[hemelb::reporting::Timers::readBlocksAll].Start();
+        ReadInBlocksCollectively(geometry, readBlock);
+        timings[hemelb::reporting::Timers::readBlocksAll].Stop();
+        return;
+      }
+
       // Next we spread round the lists of which blocks each core needs access to.
       log::Logger::Log<log::Debug, log::OnePerCore>("Informing reading cores of block needs");
       net::Net net = net::Net(computeComms);
       Needs needs(geometry.GetBlockCount(),
                   readBlock,
-                  util::NumericalFunctions::min(READING_GROUP_SIZE, computeComms.Size()),
+                  GetReadingGroupSize(),
                   net,
                   ShouldValidate());
 
@@ -357,6 +554,179 @@ namespace hemelb
       timings[hemelb::reporting::Timers::readBlocksAll].Stop();
     }
 
+    void GeometryReader::ReadInBlocksCollectively(Geometry& geometry,
+                                                  const std::vector<bool>& readBlock)
+    {
+      const site_t blockCount = geometry.GetBlockCount();
+      const proc_t readingGroupSize = GetReadingGroupSize();
+      const proc_t localRank = computeComms.Rank();
+
+      // Find the offset of each block in the file, and split the blocks into chunks of
+      // consecutive blocks no bigger than the chunk size (unless a single block is bigger).
+      std::vector<MPI_Offset> blockOffsets(blockCount + 1);
+      blockOffsets[0] = io::formats::geometry::PreambleLength + GetHeaderLength(blockCount);
+      std::vector<site_t> firstBlockOfChunk(1, 0);
+      for (site_t block = 0; block < blockCount; ++block)
+      {
+        if (block > firstBlockOfChunk.back()
+            && blockOffsets[block] + bytesPerCompressedBlock[block]
+                - blockOffsets[firstBlockOfChunk.back()] > COLLECTIVE_READ_CHUNK_BYTES)
+        {
+          firstBlockOfChunk.push_back(block);
+        }
+        blockOffsets[block + 1] = blockOffsets[block] + bytesPerCompressedBlock[block];
+      }
+      firstBlockOfChunk.push_back(blockCount);
+      const site_t chunkCount = firstBlockOfChunk.size() - 1;
+
+      // Tell each reading core which of the blocks in its chunks we need, in ascending order.
+      // Chunk c is read by core c % readingGroupSize in round c / readingGroupSize.
+      log::Logger::Log<log::Debug, log::OnePerCore>("Informing reading cores of block needs");
+      timings[hemelb::reporting::Timers::readNet].Start();
+      std::vector<std::vector<site_t> > neededFromReader(readingGroupSize);
+      for (site_t chunk = 0; chunk < chunkCount; ++chunk)
+      {
+        for (site_t block = firstBlockOfChunk[chunk]; block < firstBlockOfChunk[chunk + 1]; ++block)
+        {
+          if (readBlock[block] && fluidSitesOnEachBlock[block] > 0)
+          {
+            neededFromReader[chunk % readingGroupSize].push_back(block);
+          }
+        }
+      }
+      std::vector<site_t> neededBlocks;
+      std::vector<int> needCounts(computeComms.Size(), 0);
+      for (proc_t reader = 0; reader < readingGroupSize; ++reader)
+      {
+        neededBlocks.insert(neededBlocks.end(),
+                            neededFromReader[reader].begin(),
+                            neededFromReader[reader].end());
+        needCounts[reader] = neededFromReader[reader].size();
+      }
+      std::vector<int> wantedCounts;
+      const std::vector<site_t> wantedBlocks = computeComms.AllToAllV(neededBlocks,
+                                                                      needCounts,
+                                                                      wantedCounts);
+      timings[hemelb::reporting::Timers::readNet].Stop();
+
+      // For each core, the position in wantedBlocks of the next block it wants from us and the
+      // end of its list.
+      std::vector<size_t> nextWanted(computeComms.Size(), 0);
+      std::vector<size_t> endOfWanted(computeComms.Size(), wantedCounts[0]);
+      for (proc_t rank = 1; rank < computeComms.Size(); ++rank)
+      {
+        nextWanted[rank] = endOfWanted[rank - 1];
+        endOfWanted[rank] = nextWanted[rank] + wantedCounts[rank];
+      }
+
+      // With OpenMP, the blocks are inflated and parsed by tasks on the other threads while the
+      // master thread (the only one allowed to make MPI calls) reads and exchanges the next
+      // round. The data received in each round is kept until the round after next, by when all
+      // of its blocks are sure to have been parsed.
+      std::vector<char> receivedData[2];
+      std::string parseError;
+
+      const site_t roundCount = (chunkCount + readingGroupSize - 1) / readingGroupSize;
+#ifdef HEMELB_USE_OPENMP
+#pragma omp parallel
+#pragma omp master
+#endif
+      for (site_t round = 0; round < roundCount; ++round)
+      {
+        // Every core takes part in the collective read, even those with nothing to read.
+        timings[hemelb::reporting::Timers::readBlock].Start();
+        const site_t myChunk = round * readingGroupSize + localRank;
+        const bool readingThisRound = localRank < readingGroupSize && myChunk < chunkCount;
+        std::vector<char> chunkData;
+        MPI_Offset chunkOffset = 0;
+        site_t chunkEnd = 0;
+        if (readingThisRound)
+        {
+          chunkOffset = blockOffsets[firstBlockOfChunk[myChunk]];
+          chunkEnd = firstBlockOfChunk[myChunk + 1];
+          chunkData.resize(blockOffsets[chunkEnd] - chunkOffset);
+        }
+        file.ReadAtAll(chunkOffset, chunkData);
+
+        // Gather up the blocks each core wants from this chunk.
+        std::vector<char> sendData;
+        std::vector<int> sendCounts(computeComms.Size(), 0);
+        if (readingThisRound)
+        {
+          for (proc_t rank = 0; rank < computeComms.Size(); ++rank)
+          {
+            const size_t sizeBefore = sendData.size();
+            for (; nextWanted[rank] < endOfWanted[rank] && wantedBlocks[nextWanted[rank]] < chunkEnd;
+                ++nextWanted[rank])
+            {
+              const site_t block = wantedBlocks[nextWanted[rank]];
+              std::vector<char>::const_iterator blockStart = chunkData.begin()
+                  + (blockOffsets[block] - chunkOffset);
+              sendData.insert(sendData.end(), blockStart, blockStart + bytesPerCompressedBlock[block]);
+            }
+            sendCounts[rank] = sendData.size() - sizeBefore;
+          }
+        }
+        timings[hemelb::reporting::Timers::readBlock].Stop();
+
+        timings[hemelb::reporting::Timers::readNet].Start();
+        std::vector<int> receiveCounts;
+        std::vector<char>& roundData = receivedData[round % 2];
+        roundData = computeComms.AllToAllV(sendData, sendCounts, receiveCounts);
+        timings[hemelb::reporting::Timers::readNet].Stop();
+
+        // Wait for the previous round's blocks, then hand out this round's. The blocks arrive
+        // grouped by reading core, and so in ascending order.
+        timings[hemelb::reporting::Timers::readParse].Start();
+#ifdef HEMELB_USE_OPENMP
+#pragma omp taskwait
+#endif
+        const char* nextBlockData = roundData.empty() ? NULL : &roundData.front();
+        for (proc_t reader = 0; reader < readingGroupSize; ++reader)
+        {
+          const site_t chunk = round * readingGroupSize + reader;
+          if (chunk >= chunkCount)
+          {
+            break;
+          }
+          for (site_t block = firstBlockOfChunk[chunk]; block < firstBlockOfChunk[chunk + 1]; ++block)
+          {
+            if (readBlock[block] && fluidSitesOnEachBlock[block] > 0)
+            {
+              ArenaSlice<GeometrySiteLink> blockLinks = AllocateBlock(geometry, block);
+#ifdef HEMELB_USE_OPENMP
+#pragma omp task firstprivate(block, nextBlockData, blockLinks) shared(geometry, parseError)
+#endif
+              {
+                // Exceptions mustn't escape a task, so keep the first for the master to rethrow.
+                try
+                {
+                  ParseCompressedBlock(geometry, block, nextBlockData, blockLinks);
+                }
+                catch (const std::exception& e)
+                {
+#ifdef HEMELB_USE_OPENMP
+#pragma omp critical(GeometryReaderParseError)
+#endif
+                  if (parseError.empty())
+                  {
+                    parseError = e.what();
+                  }
+                }
+              }
+              nextBlockData += bytesPerCompressedBlock[block];
+            }
+          }
+        }
+        timings[hemelb::reporting::Timers::readParse].Stop();
+      }
+
+      if (!parseError.empty())
+      {
+        throw Exception() << parseError;
+      }
+    }
+
     void GeometryReader::ReadInBlock(MPI_Offset offsetSoFar, Geometry& geometry,
                                      const std::vector<proc_t>& procsWantingThisBlock,
                                      const site_t blockNumber, const bool neededOnThisRank)
@@ -406,95 +776,278 @@ namespace hemelb
       timings[hemelb::reporting::Timers::readNet].Stop();
       timings[hemelb::reporting::Timers::readParse].Start();
       if (neededOnThisRank)
+      {
+        ParseCompressedBlock(geometry,
+                             blockNumber,
+                             &compressedBlockData.front(),
+                             AllocateBlock(geometry, blockNumber));
+      }
+      timings[hemelb::reporting::Timers::readParse].Stop();
+    }
+
+    ArenaSlice<GeometrySiteLink> GeometryReader::AllocateBlock(Geometry& geometry,
+                                                               const site_t blockNumber)
+    {
+      // The storage was reserved (and emptied of anything from a previous read) before reading.
+      geometry.AllocateBlockSites(blockNumber);
+      return geometry.AllocateLinks(fluidSitesOnEachBlock[blockNumber]
+          * (latticeInfo.GetNumVectors() - 1));
+    }
+
+    void GeometryReader::ParseCompressedBlock(Geometry& geometry, const site_t blockNumber,
+                                              const char* compressedBlockData,
+                                              ArenaSlice<GeometrySiteLink> blockLinks)
+    {
+      std::vector<char> blockData = DecompressBlockData(compressedBlockData,
+                                                        bytesPerCompressedBlock[blockNumber],
+                                                        bytesPerUncompressedBlock[blockNumber]);
+      if (formatVersion == io::formats::geometry::ColumnarVersionNumber)
+      {
+        ParseColumnarBlock(geometry, blockNumber, blockData, blockLinks);
+      }
+      else
       {
         // Create an Xdr interpreter.
-        std::vector<char> blockData = DecompressBlockData(compressedBlockData,
-                                                          bytesPerUncompressedBlock[blockNumber]);
         io::writers::xdr::XdrMemReader lReader(&blockData.front(), blockData.size());
 
-        ParseBlock(geometry, blockNumber, lReader);
+        ParseBlock(geometry, blockNumber, lReader, blockLinks);
+      }
 
-        // If debug-level logging, check that we've read in as many sites as anticipated.
-        if (ShouldValidate())
+      // If debug-level logging, check that we've read in as many sites as anticipated.
+      if (ShouldValidate())
+      {
+        // Count the sites read,
+        site_t numSitesRead = 0;
+        for (site_t site = 0; site < geometry.GetSitesPerBlock(); ++site)
         {
-          // Count the sites read,
-          site_t numSitesRead = 0;
-          for (site_t site = 0; site < geometry.GetSitesPerBlock(); ++site)
-          {
-            if (geometry.Blocks[blockNumber].Sites[site].targetProcessor != BIG_NUMBER2)
-            {
-              ++numSitesRead;
-            }
-          }
-          // Compare with the sites we expected to read.
-          if (numSitesRead != fluidSitesOnEachBlock[blockNumber])
+          if (geometry.Blocks[blockNumber].Sites[site].targetProcessor != BIG_NUMBER2)
           {
-            log::Logger::Log<log::Error, log::OnePerCore>("Was expecting %i fluid sites on block %i but actually read %i",
-                                                          fluidSitesOnEachBlock[blockNumber],
-                                                          blockNumber,
-                                                          numSitesRead);
+            ++numSitesRead;
           }
         }
+        // Compare with the sites we expected to read.
+        if (numSitesRead != fluidSitesOnEachBlock[blockNumber])
+        {
+          log::Logger::Log<log::Error, log::OnePerCore>("Was expecting %i fluid sites on block %i but actually read %i",
+                                                        fluidSitesOnEachBlock[blockNumber],
+                                                        blockNumber,
+                                                        numSitesRead);
+        }
       }
-      else if (!geometry.Blocks[blockNumber].Sites.empty())
-      {
-        geometry.Blocks[blockNumber].Sites = std::vector<GeometrySite>(0, GeometrySite(false));
-      }
-      timings[hemelb::reporting::Timers::readParse].Stop();
     }
 
-    std::vector<char> GeometryReader::DecompressBlockData(const std::vector<char>& compressed,
+    std::vector<char> GeometryReader::DecompressBlockData(const char* compressed,
+                                                          const unsigned int compressedBytes,
                                                           const unsigned int uncompressedBytes)
     {
-      timings[hemelb::reporting::Timers::unzip].Start();
-      // For zlib return codes.
-      int ret;
-
+      // Worker threads mustn't touch the timers, so only time inflation outside parallel regions.
+#ifdef HEMELB_USE_OPENMP
+      const bool timed = !omp_in_parallel();
+#else
+      const bool timed = true;
+#endif
+      if (timed)
+      {
+        timings[hemelb::reporting::Timers::unzip].Start();
+      }
       // Set up the buffer for decompressed data. We know how long the the data is
       std::vector<char> uncompressed(uncompressedBytes);
 
-      // Set up the inflator
-      z_stream stream;
-      stream.zalloc = Z_NULL;
-      stream.zfree = Z_NULL;
-      stream.opaque = Z_NULL;
-      stream.avail_in = compressed.size();
-      stream.next_in = reinterpret_cast<unsigned char*> (const_cast<char*> (&compressed.front()));
-
-      ret = inflateInit(&stream);
-      if (ret != Z_OK)
-        throw Exception() << "Decompression error for block";
-
-      stream.avail_out = uncompressed.size();
-      stream.next_out = reinterpret_cast<unsigned char*> (&uncompressed.front());
-
-      ret = inflate(&stream, Z_FINISH);
-      if (ret != Z_STREAM_END)
-        throw Exception() << "Decompression error for block";
-
-      uncompressed.resize(uncompressed.size() - stream.avail_out);
-      ret = inflateEnd(&stream);
-      if (ret != Z_OK)
-        throw Exception() << "Decompression error for block";
+#ifdef HEMELB_USE_LZ4
+      if (codec == io::formats::geometry::CODEC_LZ4)
+      {
+        int decompressedBytes = LZ4_decompress_safe(compressed,
+                                                    &uncompressed.front(),
+                                                    compressedBytes,
+                                                    uncompressedBytes);
+        if (decompressedBytes < 0)
+          throw Exception() << "Decompression error for block";
+
+        uncompressed.resize(decompressedBytes);
+      }
+      else
+#endif
+      {
+        // For zlib return codes.
+        int ret;
+
+        // Set up the inflator
+        z_stream stream;
+        stream.zalloc = Z_NULL;
+        stream.zfree = Z_NULL;
+        stream.opaque = Z_NULL;
+        stream.avail_in = compressedBytes;
+        stream.next_in = reinterpret_cast<unsigned char*> (const_cast<char*> (compressed));
+
+        ret = inflateInit(&stream);
+        if (ret != Z_OK)
+          throw Exception() << "Decompression error for block";
+
+        stream.avail_out = uncompressed.size();
+        stream.next_out = reinterpret_cast<unsigned char*> (&uncompressed.front());
+
+        ret = inflate(&stream, Z_FINISH);
+        if (ret != Z_STREAM_END)
+          throw Exception() << "Decompression error for block";
+
+        uncompressed.resize(uncompressed.size() - stream.avail_out);
+        ret = inflateEnd(&stream);
+        if (ret != Z_OK)
+          throw Exception() << "Decompression error for block";
+      }
 
-      timings[hemelb::reporting::Timers::unzip].Stop();
+      if (timed)
+      {
+        timings[hemelb::reporting::Timers::unzip].Stop();
+      }
       return uncompressed;
     }
 
     void GeometryReader::ParseBlock(Geometry& geometry, const site_t block,
-                                    io::writers::xdr::XdrReader& reader)
+                                    io::writers::xdr::XdrReader& reader,
+                                    ArenaSlice<GeometrySiteLink> blockLinks)
     {
-      // We start by clearing the sites on the block. We read the blocks twice (once before
-      // optimisation and once after), so there can be sites on the block from the previous read.
-      geometry.Blocks[block].Sites.clear();
+      const Direction linksPerSite = latticeInfo.GetNumVectors() - 1;
+      GeometrySiteLink* nextLinks = blockLinks.begin();
 
       for (site_t localSiteIndex = 0; localSiteIndex < geometry.GetSitesPerBlock(); ++localSiteIndex)
       {
-        geometry.Blocks[block].Sites.push_back(ParseSite(reader));
+        GeometrySite& site = geometry.Blocks[block].Sites[localSiteIndex];
+        ParseSite(reader, site, nextLinks == blockLinks.end() ? NULL : nextLinks);
+
+        if (site.isFluid)
+        {
+          nextLinks += linksPerSite;
+        }
       }
     }
 
-    GeometrySite GeometryReader::ParseSite(io::writers::xdr::XdrReader& reader)
+    void GeometryReader::ParseColumnarBlock(Geometry& geometry, const site_t block,
+                                            const std::vector<char>& blockData,
+                                            ArenaSlice<GeometrySiteLink> blockLinks)
+    {
+      const site_t sitesPerBlock = geometry.GetSitesPerBlock();
+      const unsigned displacements = io::formats::geometry::NumberOfDisplacements;
+      ColumnarBlockReader columns(blockData);
+
+      // Copy out the arrays, the lengths of the later ones depending on the earlier ones.
+      const unsigned char* siteTypes = columns.ReadBytes(sitesPerBlock);
+      site_t fluidSites = 0;
+      for (site_t site = 0; site < sitesPerBlock; ++site)
+      {
+        if (siteTypes[site] == io::formats::geometry::FLUID)
+        {
+          ++fluidSites;
+        }
+      }
+      if (fluidSites != fluidSitesOnEachBlock[block])
+      {
+        throw Exception() << "Malformed GMY file, block " << block << " has " << fluidSites
+            << " fluid sites when the header gives " << fluidSitesOnEachBlock[block];
+      }
+
+      const unsigned char* cutTypes = columns.ReadBytes(fluidSites * displacements);
+      const unsigned char* normalAvailable = columns.ReadBytes(fluidSites);
+
+      size_t cuts = 0, ioletCuts = 0, normals = 0;
+      for (site_t link = 0; link < fluidSites * displacements; ++link)
+      {
+        if (cutTypes[link] != io::formats::geometry::CUT_NONE)
+        {
+          ++cuts;
+          if (cutTypes[link] != io::formats::geometry::CUT_WALL)
+          {
+            ++ioletCuts;
+          }
+        }
+      }
+      for (site_t fluidSite = 0; fluidSite < fluidSites; ++fluidSite)
+      {
+        if (normalAvailable[fluidSite] == io::formats::geometry::WALL_NORMAL_AVAILABLE)
+        {
+          ++normals;
+        }
+      }
+
+      std::vector<float> distances;
+      std::vector<uint32_t> ioletIds;
+      std::vector<float> wallNormals;
+      columns.ReadArray(distances, cuts);
+      columns.ReadArray(ioletIds, ioletCuts);
+      columns.ReadArray(wallNormals, 3 * normals);
+      if (!columns.AtEnd())
+      {
+        throw Exception() << "Malformed GMY file, block " << block << " is longer than its contents.";
+      }
+
+      // Now fill in the sites.
+      const Direction linksPerSite = latticeInfo.GetNumVectors() - 1;
+      GeometrySiteLink* nextLinks = blockLinks.begin();
+      const unsigned char* nextCutType = cutTypes;
+      const unsigned char* nextNormalAvailable = normalAvailable;
+      std::vector<float>::const_iterator nextDistance = distances.begin();
+      std::vector<uint32_t>::const_iterator nextIoletId = ioletIds.begin();
+      std::vector<float>::const_iterator nextNormal = wallNormals.begin();
+
+      for (site_t localSiteIndex = 0; localSiteIndex < sitesPerBlock; ++localSiteIndex)
+      {
+        GeometrySite& site = geometry.Blocks[block].Sites[localSiteIndex];
+        site = GeometrySite(siteTypes[localSiteIndex] == io::formats::geometry::FLUID);
+        if (!site.isFluid)
+        {
+          continue;
+        }
+
+        site.links = ArenaSlice<GeometrySiteLink>(nextLinks, linksPerSite);
+        nextLinks += linksPerSite;
+
+        bool isGmyWallSite = false;
+        for (unsigned readDirection = 0; readDirection < displacements; ++readDirection, ++nextCutType)
+        {
+          GeometrySiteLink link;
+          link.type = (GeometrySiteLink::IntersectionType) *nextCutType;
+          if (link.type != GeometrySiteLink::NO_INTERSECTION)
+          {
+            link.distanceToIntersection = *nextDistance++;
+            if (link.type == GeometrySiteLink::WALL_INTERSECTION)
+            {
+              isGmyWallSite = true;
+            }
+            else
+            {
+              link.ioletId = *nextIoletId++;
+            }
+          }
+
+          const Direction usedLatticeDirection = latticeDirectionForFileDirection[readDirection];
+          if (usedLatticeDirection != 0)
+          {
+            site.links[usedLatticeDirection - 1] = link;
+          }
+        }
+
+        site.wallNormalAvailable = (*nextNormalAvailable++
+            == io::formats::geometry::WALL_NORMAL_AVAILABLE);
+        if (site.wallNormalAvailable != isGmyWallSite)
+        {
+          std::string msg = isGmyWallSite
+            ? "wall fluid site without"
+            : "bulk fluid site with";
+          throw Exception() << "Malformed GMY file, "
+              << msg << " a defined wall normal currently not allowed.";
+        }
+
+        if (site.wallNormalAvailable)
+        {
+          site.wallNormal[0] = *nextNormal++;
+          site.wallNormal[1] = *nextNormal++;
+          site.wallNormal[2] = *nextNormal++;
+        }
+      }
+    }
+
+    void GeometryReader::ParseSite(io::writers::xdr::XdrReader& reader, GeometrySite& readInSite,
+                                   GeometrySiteLink* links)
     {
       // Read the fluid property.
       unsigned isFluid;
@@ -506,18 +1059,22 @@ namespace hemelb
       }
 
       /// @todo #598 use constant in hemelb::io::formats::geometry
-      GeometrySite readInSite(isFluid != 0);
+      readInSite = GeometrySite(isFluid != 0);
 
       // If solid, there's nothing more to do.
       if (!readInSite.isFluid)
       {
-        return readInSite;
+        return;
       }
 
       const io::formats::geometry::DisplacementVector& neighbourhood =
           io::formats::geometry::Get().GetNeighbourhood();
-      // Prepare the links array to have enough space.
-      readInSite.links.resize(latticeInfo.GetNumVectors() - 1);
+      // Give the site its links.
+      if (links == NULL)
+      {
+        throw Exception() << "Malformed GMY file, more fluid sites on a block than given in the header.";
+      }
+      readInSite.links = ArenaSlice<GeometrySiteLink>(links, latticeInfo.GetNumVectors() - 1);
 
       bool isGmyWallSite = false;
 
@@ -552,17 +1109,11 @@ namespace hemelb
           link.distanceToIntersection = distance;
         }
 
-        // Now, attempt to match the direction read from the local neighbourhood to one in the
-        // lattice being used for simulation. If a match is found, assign the link to the read
-        // site.
-        for (Direction usedLatticeDirection = 1; usedLatticeDirection < latticeInfo.GetNumVectors(); usedLatticeDirection++)
+        // If this link direction is necessary to the lattice in use, keep the link data.
+        const Direction usedLatticeDirection = latticeDirectionForFileDirection[readDirection];
+        if (usedLatticeDirection != 0)
         {
-          if (latticeInfo.GetVector(usedLatticeDirection) == neighbourhood[readDirection])
-          {
-            // If this link direction is necessary to the lattice in use, keep the link data.
-            readInSite.links[usedLatticeDirection - 1] = link;
-            break;
-          }
+          readInSite.links[usedLatticeDirection - 1] = link;
         }
       }
 
@@ -586,14 +1137,16 @@ namespace hemelb
         reader.readFloat(readInSite.wallNormal[1]);
         reader.readFloat(readInSite.wallNormal[2]);
       }
-
-      return readInSite;
     }
 
     proc_t GeometryReader::GetReadingCoreForBlock(site_t blockNumber)
     {
-      return proc_t(blockNumber % util::NumericalFunctions::min(READING_GROUP_SIZE,
-                                                                computeComms.Size()));
+      return proc_t(blockNumber % GetReadingGroupSize());
+    }
+
+    proc_t GeometryReader::GetReadingGroupSize() const
+    {
+      return util::NumericalFunctions::min(readingConfig.readingGroupSize, computeComms.Size());
     }
 
     /**
@@ -757,31 +1310,61 @@ namespace hemelb
     }
 
     void GeometryReader::OptimiseDomainDecomposition(Geometry& geometry,
-                                                     const std::vector<proc_t>& procForEachBlock)
+                                                     const std::vector<proc_t>& procForEachBlock,
+                                                     const std::vector<float>& blockWeightScales)
     {
       decomposition::OptimisedDecomposition optimiser(timings,
                                                       computeComms,
                                                       geometry,
                                                       latticeInfo,
                                                       procForEachBlock,
-                                                      fluidSitesOnEachBlock);
+                                                      fluidSitesOnEachBlock,
+                                                      blockWeightScales,
+                                                      siteWeights,
+                                                      readingConfig.decompositionMethod);
 
+      if (!readingConfig.decompositionCachePath.empty() && blockWeightScales.empty())
+      {
+        // Failing to save the decomposition shouldn't stop the run.
+        try
+        {
+          decomposition::DecompositionCache cache(computeComms,
+                                                  readingConfig.decompositionCachePath,
+                                                  latticeInfo.GetNumVectors(),
+                                                  readingConfig.decompositionMethod,
+                                                  geometryHash,
+                                                  geometry.GetBlockCount());
+          cache.Write(procForEachBlock, optimiser.GetLocalMoves());
+        }
+        catch (const Exception& e)
+        {
+          log::Logger::Log<log::Warning, log::OnePerCore>("Could not write the decomposition to %s: %s",
+                                                          readingConfig.decompositionCachePath.c_str(),
+                                                          e.what());
+        }
+      }
+
+      ApplyDecomposition(geometry,
+                         procForEachBlock,
+                         optimiser.GetMovesCountPerCore(),
+                         optimiser.GetMovesList());
+    }
+
+    void GeometryReader::ApplyDecomposition(Geometry& geometry,
+                                            const std::vector<proc_t>& procForEachBlock,
+                                            const std::vector<idx_t>& movesPerProc,
+                                            const std::vector<idx_t>& movesList)
+    {
       timings[hemelb::reporting::Timers::reRead].Start();
       log::Logger::Log<log::Debug, log::OnePerCore>("Rereading blocks");
       // Reread the blocks based on the ParMetis decomposition.
-      RereadBlocks(geometry,
-                   optimiser.GetMovesCountPerCore(),
-                   optimiser.GetMovesList(),
-                   procForEachBlock);
+      RereadBlocks(geometry, movesPerProc, movesList, procForEachBlock);
       timings[hemelb::reporting::Timers::reRead].Stop();
 
       timings[hemelb::reporting::Timers::moves].Start();
       // Implement the decomposition now that we have read the necessary data.
       log::Logger::Log<log::Debug, log::OnePerCore>("Implementing moves");
-      ImplementMoves(geometry,
-                     procForEachBlock,
-                     optimiser.GetMovesCountPerCore(),
-                     optimiser.GetMovesList());
+      ImplementMoves(geometry, procForEachBlock, movesPerProc, movesList);
       timings[hemelb::reporting::Timers::moves].Stop();
     }
 
@@ -898,6 +1481,82 @@ namespace hemelb
       }
     }
 
+    void GeometryReader::ReportEdgeCut(const Geometry& geometry) const
+    {
+      // Every rank has read the blocks around its own sites, so it can count the links from its
+      // sites to sites on other ranks. Each cut link is counted once from either end.
+      const proc_t localRank = ConvertTopologyRankToGlobalRank(computeComms.Rank());
+      const site_t blockSize = geometry.GetBlockSize();
+      const util::Vector3D<site_t> sitesInGeometry = geometry.GetBlockDimensions() * blockSize;
+      site_t localCutLinks = 0;
+
+      for (site_t block = 0; block < geometry.GetBlockCount(); ++block)
+      {
+        const BlockReadResult& blockReadResult = geometry.Blocks[block];
+        if (blockReadResult.Sites.empty())
+        {
+          continue;
+        }
+
+        const util::Vector3D<site_t> blockOrigin = geometry.GetBlockCoordinatesFromBlockId(block)
+            * blockSize;
+        site_t site = 0;
+        for (site_t localSiteI = 0; localSiteI < blockSize; localSiteI++)
+        {
+          for (site_t localSiteJ = 0; localSiteJ < blockSize; localSiteJ++)
+          {
+            for (site_t localSiteK = 0; localSiteK < blockSize; localSiteK++, site++)
+            {
+              if (blockReadResult.Sites[site].targetProcessor != localRank)
+              {
+                continue;
+              }
+
+              for (Direction direction = 1; direction < latticeInfo.GetNumVectors(); direction++)
+              {
+                const util::Vector3D<site_t> neighbour = blockOrigin
+                    + util::Vector3D<site_t>(localSiteI, localSiteJ, localSiteK)
+                    + util::Vector3D<site_t>(latticeInfo.GetVector(direction));
+                if (neighbour.x < 0 || neighbour.y < 0 || neighbour.z < 0
+                    || neighbour.x >= sitesInGeometry.x || neighbour.y >= sitesInGeometry.y
+                    || neighbour.z >= sitesInGeometry.z)
+                {
+                  continue;
+                }
+
+                const util::Vector3D<site_t> neighbourBlock = neighbour / blockSize;
+                const BlockReadResult& neighbourBlockReadResult =
+                    geometry.Blocks[geometry.GetBlockIdFromBlockCoordinates(neighbourBlock.x,
+                                                                            neighbourBlock.y,
+                                                                            neighbourBlock.z)];
+                if (neighbourBlockReadResult.Sites.empty())
+                {
+                  continue;
+                }
+
+                const util::Vector3D<site_t> neighbourSite = neighbour % blockSize;
+                const proc_t neighbourRank =
+                    neighbourBlockReadResult.Sites[geometry.GetSiteIdFromSiteCoordinates(neighbourSite.x,
+                                                                                       neighbourSite.y,
+                                                                                       neighbourSite.z)].targetProcessor;
+                if (neighbourRank != localRank && neighbourRank != BIG_NUMBER2)
+                {
+                  ++localCutLinks;
+                }
+              }
+            }
+          }
+        }
+      }
+
+      const site_t cutLinks = computeComms.AllReduce(localCutLinks, MPI_SUM) / 2;
+      if (computeComms.Rank() == 0)
+      {
+        log::Logger::Log<log::Info, log::OnePerCore>("The decomposition cuts %ld links between ranks.",
+                                                     (long) cutLinks);
+      }
+    }
+
     proc_t GeometryReader::ConvertTopologyRankToGlobalRank(proc_t topologyRankIn) const
     {
       // If the global rank is not equal to the topology rank, we are not using rank 0 for
@@ -23,8 +23,10 @@
 #include "units.h"
 #include "geometry/Geometry.h"
 #include "geometry/needs/Needs.h"
+#include "geometry/decomposition/SiteWeights.h"
 
 #include "net/MpiFile.h"
+#include "configuration/SimConfig.h"
 
 namespace hemelb
 {
@@ -37,10 +39,20 @@ namespace hemelb
         typedef util::Vector3D<site_t> BlockLocation;
 
         GeometryReader(const bool reserveSteeringCore, const lb::lattices::LatticeInfo&,
-                       reporting::Timers &timings, const net::IOCommunicator& ioComm);
+                       reporting::Timers &timings, const net::IOCommunicator& ioComm,
+                       const configuration::SimConfig::GeometryReadingConfig& readingConfig);
         ~GeometryReader();
 
-        Geometry LoadAndDecompose(const std::string& dataFilePath);
+        /**
+         * Read the geometry file and decompose it between the processes.
+         * @param dataFilePath
+         * @param blockWeightScales A factor for the decomposition weight of the sites on each
+         *   block, as measured by a LoadBalancer, or empty to use the usual site weights. Scaled
+         *   decompositions are neither read from nor written to the decomposition cache.
+         * @return
+         */
+        Geometry LoadAndDecompose(const std::string& dataFilePath,
+                                  const std::vector<float>& blockWeightScales = std::vector<float>());
 
       private:
         /**
@@ -79,6 +91,17 @@ namespace hemelb
                                                                const std::vector<proc_t>& unitForEachBlock,
                                                                const proc_t localRank);
 
+        /**
+         * Read in the blocks in a few large collective reads. The blocks are divided into chunks
+         * of consecutive blocks, which are shared round-robin between the reading cores. In each
+         * round every reading core reads one chunk with a collective MPI-IO call and the blocks
+         * are then delivered to the cores that need them with a single all-to-all exchange.
+         *
+         * @param geometry [out] The geometry object to populate with the blocks read.
+         * @param readBlock [in] True for each block needed on this core.
+         */
+        void ReadInBlocksCollectively(Geometry& geometry, const std::vector<bool>& readBlock);
+
         /**
          * Reads in a single block and ensures it is distributed to all cores that need it.
          *
@@ -94,25 +117,64 @@ namespace hemelb
                          const site_t blockNumber,
                          const bool neededOnThisRank);
 
+        /**
+         * Give a block storage for its sites, and take the links for its fluid sites, from the
+         * geometry's arenas. Only ever called from one thread at a time.
+         *
+         * @param geometry [in,out] The geometry object whose arenas to use.
+         * @param blockNumber [in] The id of the block.
+         * @return The links for all the fluid sites on the block.
+         */
+        ArenaSlice<GeometrySiteLink> AllocateBlock(Geometry& geometry, const site_t blockNumber);
+
+        /**
+         * Decompress, parse and (if validating) check a block read from the file. This only
+         * touches the block's own storage, so different blocks can be parsed concurrently.
+         *
+         * @param geometry [out] The geometry object to populate with info about the block.
+         * @param blockNumber [in] The id of the block.
+         * @param compressedBlockData [in] The block exactly as stored in the file.
+         * @param blockLinks [in] The links for the fluid sites on the block, from AllocateBlock.
+         */
+        void ParseCompressedBlock(Geometry& geometry, const site_t blockNumber,
+                                  const char* compressedBlockData,
+                                  ArenaSlice<GeometrySiteLink> blockLinks);
+
         /**
          * Decompress the block data. Uses the known number of sites to get an
          * upper bound on the uncompressed data to simplify the code and avoid
          * reallocation.
          * @param compressed
-         * @param sites
+         * @param compressedBytes
+         * @param uncompressedBytes
          * @return
          */
-        std::vector<char> DecompressBlockData(const std::vector<char>& compressed,
+        std::vector<char> DecompressBlockData(const char* compressed,
+                                              const unsigned int compressedBytes,
                                               const unsigned int uncompressedBytes);
 
-        void ParseBlock(Geometry& geometry, const site_t block, io::writers::xdr::XdrReader& reader);
+        void ParseBlock(Geometry& geometry, const site_t block, io::writers::xdr::XdrReader& reader,
+                        ArenaSlice<GeometrySiteLink> blockLinks);
 
         /**
-         * Parse the next site from the XDR reader. Note that we return by copy here.
+         * Parse a decompressed block of a columnar format file. The arrays making up the block
+         * are copied out in bulk and then used to fill in the sites.
+         * @param geometry [out] The geometry object to populate with info about the block.
+         * @param block [in] The id of the block.
+         * @param blockData [in] The decompressed block.
+         * @param blockLinks [in] The links for the fluid sites on the block.
+         */
+        void ParseColumnarBlock(Geometry& geometry, const site_t block,
+                                const std::vector<char>& blockData,
+                                ArenaSlice<GeometrySiteLink> blockLinks);
+
+        /**
+         * Parse the next site from the XDR reader into its place in the block.
          * @param reader
-         * @return
+         * @param site
+         * @param links Space for the links, used only if the site is fluid (NULL if there is none left)
          */
-        GeometrySite ParseSite(io::writers::xdr::XdrReader& reader);
+        void ParseSite(io::writers::xdr::XdrReader& reader, GeometrySite& site, GeometrySiteLink* links);
 
         /**
          * Calculates the number of the rank used to read in a given block.
@@ -123,13 +185,35 @@ namespace hemelb
          */
         proc_t GetReadingCoreForBlock(site_t blockNumber);
 
+        /**
+         * The number of cores (0 to this value - 1) that read the file in parallel.
+         * @return
+         */
+        proc_t GetReadingGroupSize() const;
+
         /**
          * Optimise the domain decomposition using ParMetis. We take this approach because ParMetis
-         * is more efficient when given an initial decomposition to start with.
+         * is more efficient when given an initial decomposition to start with. The result is saved
+         * to the decomposition cache, if there is one and the weights are unscaled.
          * @param geometry
          * @param procForEachBlock
+         * @param blockWeightScales
          */
-        void OptimiseDomainDecomposition(Geometry& geometry, const std::vector<proc_t>& procForEachBlock);
+        void OptimiseDomainDecomposition(Geometry& geometry,
+                                         const std::vector<proc_t>& procForEachBlock,
+                                         const std::vector<float>& blockWeightScales);
+
+        /**
+         * Reread the blocks needed by this rank under the optimised decomposition and set the
+         * rank of each site.
+         * @param geometry
+         * @param procForEachBlock The basic decomposition of the blocks.
+         * @param movesPerProc The number of sites moved from each rank.
+         * @param movesList The moves, as (block, site, rank) triples.
+         */
+        void ApplyDecomposition(Geometry& geometry, const std::vector<proc_t>& procForEachBlock,
+                                const std::vector<idx_t>& movesPerProc,
+                                const std::vector<idx_t>& movesList);
 
         void ValidateGeometry(const Geometry& geometry);
 
@@ -151,6 +235,13 @@ namespace hemelb
                             const std::vector<idx_t>& movesFromEachProc,
                             const std::vector<idx_t>& movesList) const;
 
+        /**
+         * Count the lattice links between sites on different ranks (the edge cut of the
+         * decomposition) and log it. Collective on the compute ranks.
+         * @param geometry The geometry once the decomposition has been applied.
+         */
+        void ReportEdgeCut(const Geometry& geometry) const;
+
         proc_t ConvertTopologyRankToGlobalRank(proc_t topologyRank) const;
 
         /**
@@ -161,11 +252,26 @@ namespace hemelb
 
         //! The rank which reads in the header information.
         static const proc_t HEADER_READING_RANK = 0;
-        //! The number of cores (0-READING_GROUP_SIZE-1) that read files in parallel
-        static const proc_t READING_GROUP_SIZE = HEMELB_READING_GROUP_SIZE;
+        //! The largest number of bytes one core reads in a single collective read.
+        static const MPI_Offset COLLECTIVE_READ_CHUNK_BYTES = 64 << 20;
+
+        //! How to read the blocks, and the number of cores that read the file in parallel.
+        const configuration::SimConfig::GeometryReadingConfig readingConfig;
+        //! The weight of a site of each collision type, for the decomposition.
+        const decomposition::SiteWeights siteWeights;
 
         //! Info about the connectivity of the lattice.
         const lb::lattices::LatticeInfo& latticeInfo;
+        //! For each displacement in the file's neighbourhood, the matching direction of the
+        //! lattice, or 0 if the lattice doesn't use it.
+        std::vector<Direction> latticeDirectionForFileDirection;
+        //! The version of the geometry format the file is in.
+        unsigned formatVersion;
+        //! The codec the blocks are compressed with (io::formats::geometry::Codec).
+        unsigned codec;
+        //! Hash of the preamble and header of the file and the site weights, to identify the
+        //! decomposition in the decomposition cache.
+        uint64_t geometryHash;
         //! File accessed to read in the geometry data.
         net::MpiFile file;
         //! Information about the file, to give cues and hints to MPI.
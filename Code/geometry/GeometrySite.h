@@ -10,9 +10,9 @@
 #ifndef HEMELB_GEOMETRY_GEOMETRYSITE_H
 #define HEMELB_GEOMETRY_GEOMETRYSITE_H
 
-#include <vector>
 #include "constants.h"
 #include "units.h"
+#include "geometry/ArenaSlice.h"
 #include "geometry/GeometrySiteLink.h"
 #include "util/Vector3D.h"
 
@@ -24,8 +24,8 @@ namespace hemelb
      * Model of the data for a site, as contained within a geometry file.
      * this data will be broken up and placed in various arrays in hemelb::Geometry::LatticeData
      *
-     * Note that this should be able to be returned by copy (as we sometimes do) so be careful about
-     * using heap-allocated data in this struct.
+     * Note that this is copied around freely, so be careful about using heap-allocated data in this
+     * struct. The links live in the link arena of the Geometry holding the site.
      */
     struct GeometrySite
     {
@@ -45,9 +45,9 @@ namespace hemelb
         //! lattice-Boltzmann with it.
         bool isFluid;
 
-        //! A vector of the link data for each direction in the lattice currently being used
-        //! (NOT necessarily the same as the lattice used by the geometry file).
-        std::vector<GeometrySiteLink> links;
+        //! The link data for each direction in the lattice currently being used
+        //! (NOT necessarily the same as the lattice used by the geometry file). Empty for solid sites.
+        ArenaSlice<GeometrySiteLink> links;
 
         //! Whether there's a approximation of the wall normal available in this fluid site.
         bool wallNormalAvailable;
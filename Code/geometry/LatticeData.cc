@@ -11,10 +11,12 @@
 #include <limits>
 
 #include "debug/Debugger.h"
+#include "Exception.h"
 #include "log/Logger.h"
 #include "net/IOCommunicator.h"
 #include "geometry/BlockTraverser.h"
 #include "geometry/LatticeData.h"
+#include "geometry/SiteOrdering.h"
 #include "geometry/neighbouring/NeighbouringLatticeData.h"
 #include "util/utilityFunctions.h"
 
@@ -22,6 +24,27 @@ namespace hemelb
 {
   namespace geometry
   {
+    namespace
+    {
+      /**
+       * Rearrange values, which hold valuesPerSite entries for each site, so that the ith site's
+       * entries are those of site order[i].
+       */
+      template<typename T>
+      void Permute(std::vector<T>& values, const std::vector<site_t>& order, size_t valuesPerSite)
+      {
+        std::vector<T> permuted;
+        permuted.reserve(values.size());
+        for (std::vector<site_t>::const_iterator site = order.begin(); site != order.end(); ++site)
+        {
+          permuted.insert(permuted.end(),
+                          values.begin() + *site * valuesPerSite,
+                          values.begin() + (*site + 1) * valuesPerSite);
+        }
+        values.swap(permuted);
+      }
+    }
+
     LatticeData::LatticeData(const lb::lattices::LatticeInfo& latticeInfo, const net::IOCommunicator& comms_) :
         latticeInfo(latticeInfo), neighbouringData(new neighbouring::NeighbouringLatticeData(latticeInfo)), comms(comms_)
     {
@@ -30,6 +53,24 @@ namespace hemelb
     LatticeData::~LatticeData()
     {
       delete neighbouringData;
+      // Before the types the requests were set up with.
+      for (std::map<const distribn_storage_t*, net::PersistentRequests*>::iterator it = haloRequests.begin();
+          it != haloRequests.end(); ++it)
+      {
+        delete it->second;
+      }
+
+      // Only free MPI objects that still exist: the lattice may outlive MPI_Finalize.
+      int finalized;
+      MPI_Finalized(&finalized);
+      if (!finalized)
+      {
+        for (std::vector<MPI_Datatype>::iterator it = receivedDistributionTypes.begin();
+            it != receivedDistributionTypes.end(); ++it)
+        {
+          HEMELB_MPI_CALL(MPI_Type_free, (&*it));
+        }
+      }
     }
 
     LatticeData::LatticeData(const lb::lattices::LatticeInfo& latticeInfo, const Geometry& readResult, const net::IOCommunicator& comms_) :
@@ -263,6 +304,23 @@ namespace hemelb
 
       }
 
+      if (SiteOrdering::ChangesOrder)
+      {
+        for (unsigned l = 0; l < COLLISION_TYPES; l++)
+        {
+          OrderSites(midDomainBlockNumber[l],
+                     midDomainSiteNumber[l],
+                     midDomainSiteData[l],
+                     midDomainWallNormals[l],
+                     midDomainWallDistance[l]);
+          OrderSites(domainEdgeBlockNumber[l],
+                     domainEdgeSiteNumber[l],
+                     domainEdgeSiteData[l],
+                     domainEdgeWallNormals[l],
+                     domainEdgeWallDistance[l]);
+        }
+      }
+
       PopulateWithReadData(midDomainBlockNumber,
                            midDomainSiteNumber,
                            midDomainSiteData,
@@ -275,6 +333,28 @@ namespace hemelb
                            domainEdgeWallDistance);
     }
 
+    void LatticeData::OrderSites(std::vector<site_t>& blockNumbers,
+                                 std::vector<site_t>& siteNumbers,
+                                 std::vector<SiteData>& siteDataForRange,
+                                 std::vector<util::Vector3D<float> >& wallNormals,
+                                 std::vector<float>& wallDistance) const
+    {
+      std::vector<util::Vector3D<site_t> > locations(blockNumbers.size());
+      for (size_t site = 0; site < blockNumbers.size(); ++site)
+      {
+        locations[site] = GetGlobalCoords(blockNumbers[site], GetSiteCoordsFromSiteId(siteNumbers[site]));
+      }
+
+      std::vector<site_t> order;
+      SiteOrdering::GetOrder(locations, latticeInfo, order);
+
+      Permute(blockNumbers, order, 1);
+      Permute(siteNumbers, order, 1);
+      Permute(siteDataForRange, order, 1);
+      Permute(wallNormals, order, 1);
+      Permute(wallDistance, order, latticeInfo.GetNumVectors() - 1);
+    }
+
     void LatticeData::CollectFluidSiteDistribution()
     {
       hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::Singleton>("Gathering lattice info.");
@@ -345,8 +425,8 @@ namespace hemelb
       {
         // Pointing to a few things, but not setting any variables.
         // FirstSharedF points to start of shared_fs.
-        neighbouringProcs[neighbourId].FirstSharedDistribution = GetLocalFluidSiteCount() * latticeInfo.GetNumVectors()
-            + 1 + totalSharedDistributionsSoFar;
+        neighbouringProcs[neighbourId].FirstSharedDistribution = GetLocalDistributionCount() + 1
+            + totalSharedDistributionsSoFar;
         totalSharedDistributionsSoFar += neighbouringProcs[neighbourId].SharedDistributionCount;
       }
       InitialiseNeighbourLookup(sharedDistributionLocationForEachProc);
@@ -357,6 +437,12 @@ namespace hemelb
     void LatticeData::InitialiseNeighbourLookup(std::vector<std::vector<site_t> >& sharedFLocationForEachProc)
     {
       const proc_t localRank = comms.Rank();
+      // The largest index stored is that of the last shared distribution.
+      if (GetLocalDistributionCount() + totalSharedFs > (site_t) std::numeric_limits<NeighbourIndex>::max())
+      {
+        throw Exception() << "Rank " << localRank << " has too many distributions for a " << 8 * sizeof(NeighbourIndex)
+            << "-bit neighbour index table";
+      }
       neighbourIndices.resize(latticeInfo.GetNumVectors() * localFluidSites);
       for (BlockTraverser blockTraverser(*this); blockTraverser.CurrentLocationValid(); blockTraverser.TraverseOne())
       {
@@ -376,7 +462,7 @@ namespace hemelb
           site_t localIndex = map_block_p.GetLocalContiguousIndexForSite(siteTraverser.GetCurrentIndex());
           // Set neighbour location for the distribution component at the centre of
           // this site.
-          SetNeighbourLocation(localIndex, 0, localIndex * latticeInfo.GetNumVectors() + 0);
+          SetNeighbourLocation(localIndex, 0, GetDistributionIndex(localIndex, 0));
           for (Direction direction = 1; direction < latticeInfo.GetNumVectors(); direction++)
           {
             util::Vector3D<site_t> currentLocationCoords = blockTraverser.GetCurrentLocation() * blockSize
@@ -387,7 +473,7 @@ namespace hemelb
             if (!IsValidLatticeSite(neighbourCoords))
             {
               // Set the neighbour location to the rubbish site.
-              SetNeighbourLocation(localIndex, direction, GetLocalFluidSiteCount() * latticeInfo.GetNumVectors());
+              SetNeighbourLocation(localIndex, direction, GetLocalDistributionCount());
               continue;
             }
             // Get the id of the processor which the neighbouring site lies on.
@@ -395,7 +481,7 @@ namespace hemelb
             if (proc_id_p == BIG_NUMBER2)
             {
               // initialize f_id to the rubbish site.
-              SetNeighbourLocation(localIndex, direction, GetLocalFluidSiteCount() * latticeInfo.GetNumVectors());
+              SetNeighbourLocation(localIndex, direction, GetLocalDistributionCount());
               continue;
             }
             else
@@ -409,7 +495,7 @@ namespace hemelb
             {
               // Pointer to the neighbour.
               site_t contigSiteId = GetContiguousSiteId(neighbourCoords);
-              SetNeighbourLocation(localIndex, direction, contigSiteId * latticeInfo.GetNumVectors() + direction);
+              SetNeighbourLocation(localIndex, direction, GetDistributionIndex(contigSiteId, direction));
               continue;
             }
             else
@@ -470,7 +556,7 @@ namespace hemelb
     {
       proc_t localRank = comms.Rank();
       streamingIndicesForReceivedDistributions.resize(totalSharedFs);
-      site_t f_count = GetLocalFluidSiteCount() * latticeInfo.GetNumVectors();
+      site_t f_count = GetLocalDistributionCount();
       site_t sharedSitesSeen = 0;
       for (size_t neighbourId = 0; neighbourId < neighbouringProcs.size(); neighbourId++)
       {
@@ -500,13 +586,40 @@ namespace hemelb
           SetNeighbourLocation(contigSiteId, (unsigned int) ( (l)), ++f_count);
           // Set the place where we put the received distribution functions, which is
           // f_new[number of fluid site that sends, inverse direction].
-          streamingIndicesForReceivedDistributions[sharedSitesSeen] = contigSiteId * latticeInfo.GetNumVectors()
-              + latticeInfo.GetInverseIndex(l);
+          streamingIndicesForReceivedDistributions[sharedSitesSeen] =
+              GetDistributionIndex(contigSiteId, latticeInfo.GetInverseIndex(l));
           ++sharedSitesSeen;
         }
 
       }
 
+#ifndef HEMELB_USE_AA_PATTERN
+      // Describe where each neighbour's distributions go in fNew, so that they are received
+      // straight into place. The neighbour sends them as a contiguous range of its fNew, so the
+      // two ends use different types with the same signature. That is all MPI needs, and packed
+      // persistent requests (HEMELB_PACK_POINTPOINT) cope too, because they always go through
+      // MPI_Pack and MPI_Unpack rather than copying raw bytes.
+      if (GetLocalDistributionCount() > (site_t) std::numeric_limits<int>::max())
+      {
+        throw Exception() << "Rank " << localRank << " has too many distributions to receive them in place";
+      }
+      receivedDistributionTypes.resize(neighbouringProcs.size());
+      for (size_t neighbourId = 0; neighbourId < neighbouringProcs.size(); neighbourId++)
+      {
+        const NeighbouringProcessor& neighbour = neighbouringProcs[neighbourId];
+        site_t firstReceived = neighbour.FirstSharedDistribution - neighbouringProcs[0].FirstSharedDistribution;
+        std::vector<int> displacements(streamingIndicesForReceivedDistributions.begin() + firstReceived,
+                                       streamingIndicesForReceivedDistributions.begin() + firstReceived
+                                           + neighbour.SharedDistributionCount);
+        HEMELB_MPI_CALL(MPI_Type_create_indexed_block,
+                        ((int) displacements.size(),
+                         1,
+                         &displacements.front(),
+                         net::MpiDataType<distribn_storage_t>(),
+                         &receivedDistributionTypes[neighbourId]));
+        HEMELB_MPI_CALL(MPI_Type_commit, (&receivedDistributionTypes[neighbourId]));
+      }
+#endif
     }
 
     proc_t LatticeData::GetProcIdFromGlobalCoords(const util::Vector3D<site_t>& globalSiteCoords) const
@@ -657,31 +770,88 @@ namespace hemelb
     }
 
     void LatticeData::SendAndReceive(hemelb::net::Net* net)
+    {
+      RequestHalo(*net);
+    }
+
+    template<typename Requests>
+    void LatticeData::RequestHalo(Requests& requests)
     {
       for (std::vector<NeighbouringProcessor>::const_iterator it = neighbouringProcs.begin();
           it != neighbouringProcs.end(); ++it)
       {
-        // Request the receive into the appropriate bit of FOld.
-        net->RequestReceive<distribn_t>(GetFOld( (*it).FirstSharedDistribution),
-                                        (int) ( ( (*it).SharedDistributionCount)),
-                                        (*it).Rank);
+#ifdef HEMELB_USE_AA_PATTERN
+        // Request the receive into the appropriate bit of the receive area, from where it is
+        // copied into place once the rest of this rank has been streamed (see CopyReceived).
+        requests.template RequestReceive<distribn_storage_t>(GetFOld( (*it).FirstSharedDistribution
+                                                                 + GetReceivedDistributionsOffset()),
+                                                             (int) ( ( (*it).SharedDistributionCount)),
+                                                             (*it).Rank);
+#else
+        // Request the receive straight into the positions in FNew the distributions stream to.
+        requests.RequestReceive(GetFNew(0), 1, (*it).Rank, receivedDistributionTypes[it - neighbouringProcs.begin()]);
+#endif
         // Request the send from the right bit of FNew.
-        net->RequestSend<distribn_t>(GetFNew( (*it).FirstSharedDistribution),
-                                     (int) ( ( (*it).SharedDistributionCount)),
-                                     (*it).Rank);
+        requests.template RequestSend<distribn_storage_t>(GetFNew( (*it).FirstSharedDistribution),
+                                                          (int) ( ( (*it).SharedDistributionCount)),
+                                                          (*it).Rank);
+
+      }
+    }
 
+    net::PersistentRequests& LatticeData::GetHaloRequests()
+    {
+      // Without the AA pattern fOld and fNew swap every step, so there is a set of requests for
+      // each of the two arrays.
+      net::PersistentRequests*& requests = haloRequests[GetFNew(0)];
+      if (requests == NULL)
+      {
+        // The net's point-to-point messages use tag 10.
+        requests = new net::PersistentRequests(comms, 11);
+        RequestHalo(*requests);
       }
+      return *requests;
+    }
+
+    void LatticeData::StartHaloReceives()
+    {
+      GetHaloRequests().StartReceives();
+    }
+
+    void LatticeData::StartHaloSends()
+    {
+      GetHaloRequests().StartSends();
+    }
+
+    void LatticeData::WaitForHalo()
+    {
+      GetHaloRequests().Wait();
     }
 
     void LatticeData::CopyReceived()
     {
+#ifdef HEMELB_USE_AA_PATTERN
       // Copy the distribution functions received from the neighbouring
-      // processors into the destination buffer "f_new".
+      // processors into the destination buffer "f_new". (Without the AA pattern they are
+      // received there directly; with it the slots they go to are still being read while the
+      // receive is in progress.)
       for (site_t i = 0; i < totalSharedFs; i++)
       {
         *GetFNew(streamingIndicesForReceivedDistributions[i]) = *GetFOld(neighbouringProcs[0].FirstSharedDistribution
-            + i);
+            + GetReceivedDistributionsOffset() + i);
       }
+#endif
+    }
+
+    site_t LatticeData::GetReceivedDistributionsOffset() const
+    {
+#ifdef HEMELB_USE_AA_PATTERN
+      // With a single array, received distributions can't overwrite the ones we're sending, so
+      // they go in a second area straight after it.
+      return totalSharedFs;
+#else
+      return 0;
+#endif
     }
 
     void LatticeData::Report(ctemplate::TemplateDictionary& dictionary)
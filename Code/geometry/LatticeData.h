@@ -11,12 +11,15 @@
 #define HEMELB_GEOMETRY_LATTICEDATA_H
 
 #include <cstdio>
+#include <map>
 #include <vector>
 
 #include "net/net.h"
+#include "net/PersistentRequests.h"
 #include "constants.h"
 #include "configuration/SimConfig.h"
 #include "geometry/Block.h"
+#include "geometry/DistributionLayout.h"
 #include "geometry/GeometryReader.h"
 #include "geometry/NeighbouringProcessor.h"
 #include "geometry/Site.h"
@@ -39,6 +42,17 @@ namespace hemelb
     class LatticeData : public reporting::Reportable
     {
       public:
+        /**
+         * The type of the entries in the neighbour index table. With 32-bit entries the table is
+         * half the size, so streaming reads half as much index data, but a process can then hold
+         * no more than 2^32 - 1 distributions (including the rubbish site and shared ones).
+         */
+#ifdef HEMELB_USE_32BIT_NEIGHBOUR_INDICES
+        typedef uint32_t NeighbourIndex;
+#else
+        typedef site_t NeighbourIndex;
+#endif
+
         template<class Lattice> friend class lb::LBM; //! Let the LBM have access to internals so it can initialise the distribution arrays.
         template<class LatticeData> friend class Site; //! Let the inner classes have access to site-related data that's otherwise private.
 
@@ -47,14 +61,41 @@ namespace hemelb
         virtual ~LatticeData();
 
         /**
-         * Swap the fOld and fNew arrays around.
+         * Swap the fOld and fNew arrays around. When streaming in place (the AA pattern) there is
+         * only one array, so instead flip between the even and odd step access patterns.
          */
         inline void SwapOldAndNew()
         {
+#ifdef HEMELB_USE_AA_PATTERN
+          evenStep = !evenStep;
+#else
           oldDistributions.swap(newDistributions);
+#endif
         }
 
         void SendAndReceive(net::Net* net);
+
+        /**
+         * Start receiving the halo through persistent requests of the lattice's own, rather than
+         * through the net as SendAndReceive does. The requests are set up the first time each
+         * distribution array is fNew and restarted on later steps.
+         */
+        void StartHaloReceives();
+
+        /**
+         * Start sending the halo, once the domain edge sites have been streamed.
+         */
+        void StartHaloSends();
+
+        /**
+         * Wait for the halo exchange started this step, before CopyReceived.
+         */
+        void WaitForHalo();
+
+        /**
+         * Put the distributions received from other processors in place in fNew. Without the AA
+         * pattern they are received straight into place, so there is nothing to do.
+         */
         void CopyReceived();
 
         /**
@@ -150,9 +191,13 @@ namespace hemelb
          * @param distributionIndex
          * @return
          */
-        inline distribn_t* GetFNew(site_t distributionIndex)
+        inline distribn_storage_t* GetFNew(site_t distributionIndex)
         {
+#ifdef HEMELB_USE_AA_PATTERN
+          return &oldDistributions[distributionIndex];
+#else
           return &newDistributions[distributionIndex];
+#endif
         }
 
         /**
@@ -161,9 +206,102 @@ namespace hemelb
          * @param distributionIndex
          * @return
          */
-        inline const distribn_t* GetFNew(site_t siteNumber) const
+        inline const distribn_storage_t* GetFNew(site_t siteNumber) const
         {
+#ifdef HEMELB_USE_AA_PATTERN
+          return &oldDistributions[siteNumber];
+#else
           return &newDistributions[siteNumber];
+#endif
+        }
+
+        /**
+         * Get the fNew distribution at the given index, converted from the storage precision.
+         * Distributions are stored as distribn_storage_t, possibly relative to the rest
+         * equilibrium, so single values must be read and written through this and WriteFNew
+         * rather than through the pointer from GetFNew, which is only for moving stored values
+         * around unchanged.
+         * @param distributionIndex
+         * @param direction The direction of the distribution stored at that index.
+         * @return
+         */
+        inline distribn_t ReadFNew(site_t distributionIndex, Direction direction) const
+        {
+          return DistributionPrecision::Load(*GetFNew(distributionIndex), latticeInfo.GetWeight(direction));
+        }
+
+        /**
+         * Set the fNew distribution at the given index, converting it to the storage precision.
+         * @param distributionIndex
+         * @param direction The direction of the distribution being stored.
+         * @param value
+         */
+        inline void WriteFNew(site_t distributionIndex, Direction direction, distribn_t value)
+        {
+          *GetFNew(distributionIndex) = DistributionPrecision::Store(value, latticeInfo.GetWeight(direction));
+        }
+
+        /**
+         * Get the index into the fOld / fNew arrays of the distribution of the given site in the
+         * given direction, according to the distribution layout selected at build time.
+         * @param siteIndex
+         * @param direction
+         * @return
+         */
+        template<typename LatticeType>
+        inline site_t GetDistributionIndex(site_t siteIndex, Direction direction) const
+        {
+          return DistributionLayout::GetIndex(siteIndex, direction, LatticeType::NUMVECTORS, paddedLocalFluidSites);
+        }
+
+        /**
+         * Version of the above for when you haven't got a lattice type handy.
+         * @param siteIndex
+         * @param direction
+         * @return
+         */
+        inline site_t GetDistributionIndex(site_t siteIndex, Direction direction) const
+        {
+          return DistributionLayout::GetIndex(siteIndex,
+                                              direction,
+                                              latticeInfo.GetNumVectors(),
+                                              paddedLocalFluidSites);
+        }
+
+        /**
+         * Get the index into the fNew array of the distribution that has arrived at the given site
+         * in the given direction during the current time step. Only valid once streaming (and
+         * CopyReceived) is complete, and before SwapOldAndNew.
+         * @param siteIndex
+         * @param direction
+         * @return
+         */
+        template<typename LatticeType>
+        inline site_t GetIncomingIndex(site_t siteIndex, Direction direction) const
+        {
+#ifdef HEMELB_USE_AA_PATTERN
+          return GetIncomingIndexAfterStep<LatticeType>(siteIndex, direction, evenStep);
+#else
+          return GetDistributionIndex<LatticeType>(siteIndex, direction);
+#endif
+        }
+
+        /**
+         * Get the fNew distributions of a site as a contiguous array. If the layout stores each
+         * site's distributions contiguously, this points straight into fNew; otherwise they are
+         * gathered into buffer, which must have room for LatticeType::NUMVECTORS values.
+         * @param siteIndex
+         * @param buffer
+         * @return
+         */
+        template<typename LatticeType>
+        inline const distribn_t* GetSiteFNew(site_t siteIndex, distribn_t* buffer) const
+        {
+#ifdef HEMELB_USE_AA_PATTERN
+          return GatherIncomingDistributions<LatticeType>(siteIndex, evenStep, buffer);
+#else
+          return GatherSiteDistributions(newDistributions, siteIndex, LatticeType::NUMVECTORS, buffer);
+#endif
         }
 
         proc_t GetProcIdFromGlobalCoords(const util::Vector3D<site_t>& globalSiteCoords) const;
@@ -347,6 +485,15 @@ namespace hemelb
 
         void ProcessReadSites(const Geometry& readResult);
 
+        /**
+         * Request the halo's sends and receives of the current fNew, from a net or persistent
+         * requests.
+         */
+        template<typename Requests>
+        void RequestHalo(Requests& requests);
+
+        net::PersistentRequests& GetHaloRequests();
+
         void PopulateWithReadData(const std::vector<site_t> midDomainBlockNumbers[COLLISION_TYPES],
                                   const std::vector<site_t> midDomainSiteNumbers[COLLISION_TYPES],
                                   const std::vector<SiteData> midDomainSiteData[COLLISION_TYPES],
@@ -407,9 +554,27 @@ namespace hemelb
 
           }
 
-          oldDistributions.resize(localFluidSites * latticeInfo.GetNumVectors() + 1 + totalSharedFs);
-          newDistributions.resize(localFluidSites * latticeInfo.GetNumVectors() + 1 + totalSharedFs);
+          paddedLocalFluidSites = DistributionLayout::GetPaddedSiteCount(localFluidSites);
+#ifdef HEMELB_USE_AA_PATTERN
+          // A single array, with separate areas for the shared distributions we send and receive.
+          evenStep = true;
+          oldDistributions.resize(GetLocalDistributionCount() + 1 + 2 * totalSharedFs);
+#else
+          oldDistributions.resize(GetLocalDistributionCount() + 1 + totalSharedFs);
+          newDistributions.resize(GetLocalDistributionCount() + 1 + totalSharedFs);
+#endif
         }
+
+        /**
+         * Put the sites of one range, sharing a collision type and all mid-domain or all at the
+         * domain edge, into the order given by the SiteOrdering chosen at build time.
+         */
+        void OrderSites(std::vector<site_t>& blockNumbers,
+                        std::vector<site_t>& siteNumbers,
+                        std::vector<SiteData>& siteDataForRange,
+                        std::vector<util::Vector3D<float> >& wallNormals,
+                        std::vector<float>& wallDistance) const;
+
         void CollectFluidSiteDistribution();
         void CollectGlobalSiteExtrema();
 
@@ -432,9 +597,154 @@ namespace hemelb
                                          const unsigned int direction,
                                          const site_t distributionIndex)
         {
-          neighbourIndices[siteIndex * latticeInfo.GetNumVectors() + direction] = distributionIndex;
+          neighbourIndices[siteIndex * latticeInfo.GetNumVectors() + direction] = (NeighbourIndex) distributionIndex;
         }
 
+        /**
+         * Get the number of distributions belonging to local sites, including any padding
+         * required by the layout. The rubbish site lives at this index, followed by the
+         * distributions shared with neighbouring processors.
+         * @return
+         */
+        inline site_t GetLocalDistributionCount() const
+        {
+          return paddedLocalFluidSites * latticeInfo.GetNumVectors();
+        }
+
+        /**
+         * Get the offset from the start of the shared distributions at which distributions
+         * received from neighbouring processors are stored.
+         * @return
+         */
+        site_t GetReceivedDistributionsOffset() const;
+
+        /**
+         * Copy the distributions of one site out of the given array into buffer, unless the
+         * layout already stores them contiguously at the precision of the arithmetic, in which
+         * case point straight at them.
+         * @param distributions
+         * @param siteIndex
+         * @param numVectors
+         * @param buffer
+         * @return
+         */
+        inline const distribn_t* GatherSiteDistributions(const std::vector<distribn_storage_t>& distributions,
+                                                         site_t siteIndex,
+                                                         unsigned numVectors,
+                                                         distribn_t* buffer) const
+        {
+          if (DistributionLayout::SiteContiguous && DistributionPrecision::StorageIsArithmetic)
+          {
+            // Only reached when the two types are the same.
+            return reinterpret_cast<const distribn_t*>(&distributions[siteIndex * numVectors]);
+          }
+
+          for (Direction direction = 0; direction < numVectors; ++direction)
+          {
+            buffer[direction] = DistributionPrecision::Load(distributions[DistributionLayout::GetIndex(siteIndex,
+                                                                                                       direction,
+                                                                                                       numVectors,
+                                                                                                       paddedLocalFluidSites)],
+                                                            latticeInfo.GetWeight(direction));
+          }
+          return buffer;
+        }
+
+#ifdef HEMELB_USE_AA_PATTERN
+        /**
+         * Get the index of the distribution that arrived at the given site in the given direction
+         * during a step of the given parity.
+         *
+         * An even step leaves each site's post-collision distributions in its own slots, in the
+         * opposite direction. So after one, the distribution arriving from a local fluid neighbour
+         * is still in that neighbour's slots. Everything else (bounce-back and iolet values, and
+         * values received from other ranks) is written to the site's own slot, as is
+         * everything after an odd step.
+         * @param siteIndex
+         * @param direction
+         * @param afterEvenStep
+         * @return
+         */
+        template<typename LatticeType>
+        inline site_t GetIncomingIndexAfterStep(site_t siteIndex, Direction direction, bool afterEvenStep) const
+        {
+          if (afterEvenStep)
+          {
+            site_t sourceIndex = neighbourIndices[siteIndex * LatticeType::NUMVECTORS
+                + LatticeType::INVERSEDIRECTIONS[direction]];
+            if (sourceIndex < GetLocalDistributionCount())
+            {
+              return sourceIndex;
+            }
+          }
+          return GetDistributionIndex<LatticeType>(siteIndex, direction);
+        }
+
+        // Non-templated version of GetIncomingIndexAfterStep, for when you haven't got a lattice type handy
+        inline site_t GetIncomingIndexAfterStep(site_t siteIndex, Direction direction, bool afterEvenStep) const
+        {
+          if (afterEvenStep)
+          {
+            site_t sourceIndex = neighbourIndices[siteIndex * latticeInfo.GetNumVectors()
+                + latticeInfo.GetInverseIndex(direction)];
+            if (sourceIndex < GetLocalDistributionCount())
+            {
+              return sourceIndex;
+            }
+          }
+          return GetDistributionIndex(siteIndex, direction);
+        }
+
+        /**
+         * Gather the distributions that arrived at a site during a step of the given parity into
+         * buffer. After an odd step they are all in the site's own slots, so if the layout keeps
+         * those together, point straight at them instead.
+         * @param siteIndex
+         * @param afterEvenStep
+         * @param buffer
+         * @return
+         */
+        template<typename LatticeType>
+        inline const distribn_t* GatherIncomingDistributions(site_t siteIndex,
+                                                             bool afterEvenStep,
+                                                             distribn_t* buffer) const
+        {
+          if (!afterEvenStep)
+          {
+            return GatherSiteDistributions(oldDistributions, siteIndex, LatticeType::NUMVECTORS, buffer);
+          }
+
+          for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+          {
+            buffer[direction] =
+                DistributionPrecision::Load(oldDistributions[GetIncomingIndexAfterStep<LatticeType>(siteIndex,
+                                                                                                    direction,
+                                                                                                    true)],
+                                            LatticeType::EQMWEIGHTS[direction]);
+          }
+          return buffer;
+        }
+
+        // Non-templated version of GatherIncomingDistributions, for when you haven't got a lattice type handy
+        inline const distribn_t* GatherIncomingDistributions(site_t siteIndex,
+                                                             bool afterEvenStep,
+                                                             distribn_t* buffer) const
+        {
+          if (!afterEvenStep)
+          {
+            return GatherSiteDistributions(oldDistributions, siteIndex, latticeInfo.GetNumVectors(), buffer);
+          }
+
+          for (Direction direction = 0; direction < latticeInfo.GetNumVectors(); ++direction)
+          {
+            buffer[direction] =
+                DistributionPrecision::Load(oldDistributions[GetIncomingIndexAfterStep(siteIndex, direction, true)],
+                                            latticeInfo.GetWeight(direction));
+          }
+          return buffer;
+        }
+#endif
+
         void GetBlockIJK(site_t block, util::Vector3D<site_t>& blockCoords) const;
 
         // Method should remain protected, intent is to access this information via Site
@@ -461,7 +771,7 @@ namespace hemelb
          * @return
          */
         // Method should remain protected, intent is to access this information via Site
-        distribn_t* GetFOld(site_t distributionIndex)
+        distribn_storage_t* GetFOld(site_t distributionIndex)
         {
           return &oldDistributions[distributionIndex];
         }
@@ -474,22 +784,76 @@ namespace hemelb
          * @return
          */
         // Method should remain protected, intent is to access this information via Site
-        const distribn_t* GetFOld(site_t distributionIndex) const
+        const distribn_storage_t* GetFOld(site_t distributionIndex) const
         {
           return &oldDistributions[distributionIndex];
         }
 
+        /**
+         * Set the fOld distribution at the given index, converting it to the storage precision.
+         * @param distributionIndex
+         * @param direction The direction of the distribution being stored.
+         * @param value
+         */
+        // Method should remain protected, intent is to access this information via Site
+        void WriteFOld(site_t distributionIndex, Direction direction, distribn_t value)
+        {
+          *GetFOld(distributionIndex) = DistributionPrecision::Store(value, latticeInfo.GetWeight(direction));
+        }
+
+        /**
+         * Get the fOld distributions of a site as a contiguous array, gathering them into buffer
+         * (which must have room for LatticeType::NUMVECTORS values) if the layout requires it.
+         * @param siteIndex
+         * @param buffer
+         * @return
+         */
+        // Method should remain protected, intent is to access this information via Site
+        template<typename LatticeType>
+        const distribn_t* GetSiteFOld(site_t siteIndex, distribn_t* buffer) const
+        {
+#ifdef HEMELB_USE_AA_PATTERN
+          // The distributions this step reads are those the previous step streamed in.
+          return GatherIncomingDistributions<LatticeType>(siteIndex, !evenStep, buffer);
+#else
+          return GatherSiteDistributions(oldDistributions, siteIndex, LatticeType::NUMVECTORS, buffer);
+#endif
+        }
+
+        // Non-templated version of GetSiteFOld, for when you haven't got a lattice type handy
+        const distribn_t* GetSiteFOld(site_t siteIndex, distribn_t* buffer) const
+        {
+#ifdef HEMELB_USE_AA_PATTERN
+          return GatherIncomingDistributions(siteIndex, !evenStep, buffer);
+#else
+          return GatherSiteDistributions(oldDistributions, siteIndex, latticeInfo.GetNumVectors(), buffer);
+#endif
+        }
+
         /*
          * This returns the index of the distribution to stream to.
          *
          * NOTE: If streaming would take the distribution out of the geometry, we instead stream
          * to the 'rubbish site', an extra position in the array that doesn't correspond to any
          * site in the geometry.
+         *
+         * When streaming in place, even steps leave distributions heading for local sites in the
+         * site's own slot for the opposite direction, where the neighbour reads them on the odd
+         * step. Distributions for other ranks still go to the shared area to be sent.
          */
         template<typename LatticeType>
         site_t GetStreamedIndex(site_t iSiteIndex, unsigned int iDirectionIndex) const
         {
+#ifdef HEMELB_USE_AA_PATTERN
+          site_t streamedIndex = neighbourIndices[iSiteIndex * LatticeType::NUMVECTORS + iDirectionIndex];
+          if (evenStep && streamedIndex < GetLocalDistributionCount())
+          {
+            return GetDistributionIndex<LatticeType>(iSiteIndex, LatticeType::INVERSEDIRECTIONS[iDirectionIndex]);
+          }
+          return streamedIndex;
+#else
           return neighbourIndices[iSiteIndex * LatticeType::NUMVECTORS + iDirectionIndex];
+#endif
         }
 
         /**
@@ -563,8 +927,10 @@ namespace hemelb
         site_t midDomainProcCollisions[COLLISION_TYPES]; //! Number of fluid sites with all fluid neighbours on this rank, for each collision type.
         site_t domainEdgeProcCollisions[COLLISION_TYPES]; //! Number of fluid sites with at least one fluid neighbour on another rank, for each collision type.
         site_t localFluidSites; //! The number of local fluid sites.
-        std::vector<distribn_t> oldDistributions; //! The distribution values for the previous time step.
-        std::vector<distribn_t> newDistributions; //! The distribution values for the next time step.
+        site_t paddedLocalFluidSites; //! The number of site slots in the distribution arrays, as required by the DistributionLayout.
+        std::vector<distribn_storage_t> oldDistributions; //! The distribution values for the previous time step (all distribution values, when streaming in place).
+        std::vector<distribn_storage_t> newDistributions; //! The distribution values for the next time step (unused when streaming in place).
+        bool evenStep; //! Whether the current step uses the even access pattern, when streaming in place.
         std::vector<Block> blocks; //! Data where local fluid sites are stored contiguously.
 
         std::vector<distribn_t> distanceToWall; //! Hold the distance to the wall for each fluid site.
@@ -574,8 +940,10 @@ namespace hemelb
         std::vector<site_t> fluidSitesOnEachProcessor; //! Array containing numbers of fluid sites on each processor.
         site_t totalFluidSites; //! The total number of fluid sites in the geometry.
         util::Vector3D<site_t> globalSiteMins, globalSiteMaxes; //! The minimal and maximal coordinates of any fluid sites.
-        std::vector<site_t> neighbourIndices; //! Data about neighbouring fluid sites.
+        std::vector<NeighbourIndex> neighbourIndices; //! Data about neighbouring fluid sites.
         std::vector<site_t> streamingIndicesForReceivedDistributions; //! The indices to stream to for distributions received from other processors.
+        std::vector<MPI_Datatype> receivedDistributionTypes; //! For each neighbouring processor, the MPI type scattering its distributions into fNew.
+        std::map<const distribn_storage_t*, net::PersistentRequests*> haloRequests; //! Persistent halo requests for each distribution array, by the start of the array.
         neighbouring::NeighbouringLatticeData *neighbouringData;
         const net::IOCommunicator& comms;
     };
@@ -11,7 +11,9 @@
 #define HEMELB_GEOMETRY_SITE_H
 
 #include "units.h"
+#include "geometry/DistributionLayout.h"
 #include "geometry/SiteData.h"
+#include "util/static_assert.h"
 #include "util/Vector3D.h"
 
 namespace hemelb
@@ -106,16 +108,53 @@ namespace hemelb
           return latticeData.template GetStreamedIndex<LatticeType>(index, direction);
         }
 
+        /**
+         * Get a pointer to this site's distributions from the previous time step. Only available
+         * when the distribution layout stores each site's distributions contiguously, at the
+         * precision of the arithmetic, and we're not streaming in place; code that must work with
+         * any layout should use the buffered version below.
+         *
+         * @return
+         */
         template<typename LatticeType>
         inline const distribn_t* GetFOld() const
         {
-          return latticeData.GetFOld(index * LatticeType::NUMVECTORS);
+          // Made dependent on LatticeType so that it only fires if this is actually used.
+          HEMELB_STATIC_ASSERT(SiteFOldContiguous || sizeof(LatticeType) == 0);
+          return reinterpret_cast<const distribn_t*>(latticeData.GetFOld(index * LatticeType::NUMVECTORS));
         }
 
-        // Non-templated version of GetFOld, for when you haven't got a lattice type handy
-        inline const distribn_t* GetFOld(int numvectors) const
+        /**
+         * Get this site's distributions from the previous time step as a contiguous array. For
+         * layouts that don't keep a site's distributions together they are gathered into buffer,
+         * which must hold LatticeType::NUMVECTORS values and outlive the returned pointer.
+         *
+         * @param buffer
+         * @return
+         */
+        template<typename LatticeType>
+        inline const distribn_t* GetFOld(distribn_t* buffer) const
+        {
+          return latticeData.template GetSiteFOld<LatticeType>(index, buffer);
+        }
+
+        // Non-templated version of the buffered GetFOld, for when you haven't got a lattice type handy
+        inline const distribn_t* GetFOld(distribn_t* buffer) const
+        {
+          return latticeData.GetSiteFOld(index, buffer);
+        }
+
+        /**
+         * Get the index into the distribution arrays of this site's distribution in the given
+         * direction.
+         *
+         * @param direction
+         * @return
+         */
+        template<typename LatticeType>
+        inline site_t GetDistributionIndex(Direction direction) const
         {
-          return latticeData.GetFOld(index * numvectors);
+          return latticeData.template GetDistributionIndex<LatticeType>(index, direction);
         }
 
         inline const SiteData& GetSiteData() const
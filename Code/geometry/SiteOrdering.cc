@@ -0,0 +1,218 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#include <algorithm>
+#include <utility>
+
+#include "geometry/SiteOrdering.h"
+#include "geometry/decomposition/SpaceFillingCurveDecomposition.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace
+    {
+      typedef std::pair<uint64_t, site_t> KeyAndIndex;
+
+      uint64_t GetKey(const util::Vector3D<site_t>& location)
+      {
+        return ((uint64_t) location.x << 42) | ((uint64_t) location.y << 21) | (uint64_t) location.z;
+      }
+
+      /**
+       * Sets up, for each site, the sites among locations it is linked to, as a compressed row
+       * list.
+       */
+      void GetLinks(const std::vector<util::Vector3D<site_t> >& locations,
+                    const lb::lattices::LatticeInfo& latticeInfo,
+                    std::vector<site_t>& firstLink,
+                    std::vector<site_t>& links)
+      {
+        std::vector<KeyAndIndex> sitesByKey(locations.size());
+        for (site_t site = 0; site < (site_t) locations.size(); ++site)
+        {
+          sitesByKey[site] = KeyAndIndex(GetKey(locations[site]), site);
+        }
+        std::sort(sitesByKey.begin(), sitesByKey.end());
+
+        firstLink.resize(locations.size() + 1);
+        links.clear();
+        for (site_t site = 0; site < (site_t) locations.size(); ++site)
+        {
+          firstLink[site] = links.size();
+          for (Direction direction = 1; direction < latticeInfo.GetNumVectors(); ++direction)
+          {
+            util::Vector3D<site_t> neighbour = locations[site]
+                + util::Vector3D<site_t>(latticeInfo.GetVector(direction));
+            if (neighbour.x < 0 || neighbour.y < 0 || neighbour.z < 0)
+            {
+              continue;
+            }
+            std::vector<KeyAndIndex>::const_iterator found =
+                std::lower_bound(sitesByKey.begin(), sitesByKey.end(), KeyAndIndex(GetKey(neighbour), 0));
+            if (found != sitesByKey.end() && found->first == GetKey(neighbour))
+            {
+              links.push_back(found->second);
+            }
+          }
+        }
+        firstLink[locations.size()] = links.size();
+      }
+
+      /**
+       * Compares sites by their number of links.
+       */
+      class DegreeLess
+      {
+        public:
+          DegreeLess(const std::vector<site_t>& firstLink) :
+              firstLink(firstLink)
+          {
+          }
+
+          bool operator()(site_t left, site_t right) const
+          {
+            site_t leftDegree = firstLink[left + 1] - firstLink[left];
+            site_t rightDegree = firstLink[right + 1] - firstLink[right];
+            return leftDegree < rightDegree || (leftDegree == rightDegree && left < right);
+          }
+
+        private:
+          const std::vector<site_t>& firstLink;
+      };
+
+      /**
+       * Appends the sites reachable from start and not yet placed to order, breadth first,
+       * visiting the neighbours of each site in order of increasing degree. Returns the number of
+       * levels of the search.
+       */
+      site_t AppendBreadthFirst(site_t start,
+                                const std::vector<site_t>& firstLink,
+                                const std::vector<site_t>& links,
+                                std::vector<bool>& placed,
+                                std::vector<site_t>& order)
+      {
+        const DegreeLess degreeLess(firstLink);
+        std::vector<site_t> neighbours;
+        site_t levels = 0;
+        size_t levelEnd = order.size();
+
+        placed[start] = true;
+        order.push_back(start);
+        for (size_t next = order.size() - 1; next < order.size(); ++next)
+        {
+          if (next == levelEnd)
+          {
+            ++levels;
+            levelEnd = order.size();
+          }
+          site_t site = order[next];
+          neighbours.clear();
+          for (site_t link = firstLink[site]; link < firstLink[site + 1]; ++link)
+          {
+            if (!placed[links[link]])
+            {
+              placed[links[link]] = true;
+              neighbours.push_back(links[link]);
+            }
+          }
+          std::sort(neighbours.begin(), neighbours.end(), degreeLess);
+          order.insert(order.end(), neighbours.begin(), neighbours.end());
+        }
+        return levels;
+      }
+    }
+
+    void RCM::GetOrder(const std::vector<util::Vector3D<site_t> >& locations,
+                       const lb::lattices::LatticeInfo& latticeInfo,
+                       std::vector<site_t>& order)
+    {
+      std::vector<site_t> firstLink, links;
+      GetLinks(locations, latticeInfo, firstLink, links);
+
+      // Start each connected piece from a site of lowest degree.
+      std::vector<site_t> sitesByDegree(locations.size());
+      for (site_t site = 0; site < (site_t) locations.size(); ++site)
+      {
+        sitesByDegree[site] = site;
+      }
+      std::sort(sitesByDegree.begin(), sitesByDegree.end(), DegreeLess(firstLink));
+
+      order.clear();
+      order.reserve(locations.size());
+      std::vector<bool> placed(locations.size(), false);
+      std::vector<site_t> trialOrder;
+      for (std::vector<site_t>::const_iterator candidate = sitesByDegree.begin(); candidate != sitesByDegree.end();
+          ++candidate)
+      {
+        if (placed[*candidate])
+        {
+          continue;
+        }
+
+        // Move the start out towards the periphery of its piece: a search from the far end of a
+        // deeper search gives a narrower band. A few tries are enough.
+        site_t start = *candidate;
+        site_t levels = 0;
+        for (unsigned attempt = 0; attempt < 4; ++attempt)
+        {
+          trialOrder.clear();
+          site_t trialLevels = AppendBreadthFirst(start, firstLink, links, placed, trialOrder);
+          for (std::vector<site_t>::const_iterator site = trialOrder.begin(); site != trialOrder.end(); ++site)
+          {
+            placed[*site] = false;
+          }
+          if (attempt > 0 && trialLevels <= levels)
+          {
+            break;
+          }
+          levels = trialLevels;
+          start = trialOrder.back();
+        }
+
+        AppendBreadthFirst(start, firstLink, links, placed, order);
+      }
+
+      std::reverse(order.begin(), order.end());
+    }
+
+    void HILBERT::GetOrder(const std::vector<util::Vector3D<site_t> >& locations,
+                           const lb::lattices::LatticeInfo& latticeInfo,
+                           std::vector<site_t>& order)
+    {
+      site_t maxCoordinate = 0;
+      for (site_t site = 0; site < (site_t) locations.size(); ++site)
+      {
+        maxCoordinate = std::max(maxCoordinate,
+                                 std::max(locations[site].x, std::max(locations[site].y, locations[site].z)));
+      }
+      unsigned bits = 1;
+      while ( ((site_t) 1 << bits) <= maxCoordinate)
+      {
+        ++bits;
+      }
+
+      std::vector<KeyAndIndex> sitesByKey(locations.size());
+      for (site_t site = 0; site < (site_t) locations.size(); ++site)
+      {
+        sitesByKey[site] = KeyAndIndex(decomposition::SpaceFillingCurveDecomposition::HilbertKey(locations[site],
+                                                                                                 bits),
+                                       site);
+      }
+      std::sort(sitesByKey.begin(), sitesByKey.end());
+
+      order.resize(locations.size());
+      for (site_t site = 0; site < (site_t) locations.size(); ++site)
+      {
+        order[site] = sitesByKey[site].second;
+      }
+    }
+  }
+}
@@ -0,0 +1,90 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#ifndef HEMELB_GEOMETRY_SITEORDERING_H
+#define HEMELB_GEOMETRY_SITEORDERING_H
+
+#include <vector>
+
+#include "units.h"
+#include "lb/lattices/LatticeInfo.h"
+#include "util/Vector3D.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    /**
+     * The following classes choose the order of the local fluid sites within each range of
+     * LatticeData that shares a collision type (and whether it is mid-domain or at the domain
+     * edge). Their names must correspond to the options given for the CMake
+     * HEMELB_SITE_ORDERING parameter.
+     *
+     * Each provides
+     *  - ChangesOrder, false if sites are left in the order they were read,
+     *  - GetOrder(locations, latticeInfo, order), which sets order[i] to the index in locations of
+     *      the site to put in position i.
+     *
+     * The neighbour index table and the shared distribution lookups are built after the sites are
+     * ordered, so they follow whichever order is chosen.
+     */
+
+    /**
+     * Block by block, and by site number within each block: the order in which sites are read.
+     */
+    struct BLOCK
+    {
+        static const bool ChangesOrder = false;
+
+        static void GetOrder(const std::vector<util::Vector3D<site_t> >& locations,
+                             const lb::lattices::LatticeInfo& latticeInfo,
+                             std::vector<site_t>& order)
+        {
+          order.resize(locations.size());
+          for (site_t site = 0; site < (site_t) locations.size(); ++site)
+          {
+            order[site] = site;
+          }
+        }
+    };
+
+    /**
+     * Reverse Cuthill-McKee: a breadth-first ordering of the graph of lattice links between the
+     * sites, which keeps the neighbours of each site close to it in memory.
+     */
+    struct RCM
+    {
+        static const bool ChangesOrder = true;
+
+        static void GetOrder(const std::vector<util::Vector3D<site_t> >& locations,
+                             const lb::lattices::LatticeInfo& latticeInfo,
+                             std::vector<site_t>& order);
+    };
+
+    /**
+     * The order of the sites along a Hilbert curve through the whole lattice.
+     */
+    struct HILBERT
+    {
+        static const bool ChangesOrder = true;
+
+        static void GetOrder(const std::vector<util::Vector3D<site_t> >& locations,
+                             const lb::lattices::LatticeInfo& latticeInfo,
+                             std::vector<site_t>& order);
+    };
+
+    // Use the ordering specified through the build system.
+#ifndef HEMELB_SITE_ORDERING
+#define HEMELB_SITE_ORDERING BLOCK
+#endif
+    typedef HEMELB_SITE_ORDERING SiteOrdering;
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_SITEORDERING_H */
@@ -0,0 +1,149 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#include "geometry/decomposition/DecompositionCache.h"
+#include "Exception.h"
+#include "io/formats/decomposition.h"
+#include "io/writers/xdr/XdrMemReader.h"
+#include "io/writers/xdr/XdrMemWriter.h"
+#include "log/Logger.h"
+#include "net/MpiFile.h"
+#include "util/fileutils.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      DecompositionCache::DecompositionCache(const net::MpiCommunicator& communicator,
+                                             const std::string& path, unsigned latticeVectors,
+                                             DecompositionMethod method, uint64_t geometryHash,
+                                             site_t blockCount) :
+          communicator(communicator), path(path), latticeVectors(latticeVectors), method(method),
+              geometryHash(geometryHash), blockCount(blockCount)
+      {
+      }
+
+      bool DecompositionCache::Read(std::vector<proc_t>& procForEachBlock,
+                                    std::vector<idx_t>& movesPerProc,
+                                    std::vector<idx_t>& movesList) const
+      {
+        // Opening a file that isn't there is an error, so check first.
+        int exists = 0;
+        if (communicator.Rank() == 0)
+        {
+          // "Does directory exist" works for files too.
+          exists = util::DoesDirectoryExist(path.c_str());
+        }
+        communicator.Broadcast(exists, 0);
+        if (!exists)
+        {
+          log::Logger::Log<log::Info, log::Singleton>("No decomposition file %s, decomposing the geometry",
+                                                      path.c_str());
+          return false;
+        }
+
+        net::MpiFile file = net::MpiFile::Open(communicator, path, MPI_MODE_RDONLY);
+
+        std::vector<char> header(io::formats::decomposition::HeaderLength);
+        file.ReadAtAll(0, header);
+
+        io::writers::xdr::XdrMemReader reader(&header[0], io::formats::decomposition::HeaderLength);
+        unsigned hemeLbMagic, decompositionMagic, version, ranks, vectors, indexBytes, methodUsed;
+        uint64_t hash, blocks, moves;
+        reader.readUnsignedInt(hemeLbMagic);
+        reader.readUnsignedInt(decompositionMagic);
+        reader.readUnsignedInt(version);
+        reader.readUnsignedInt(ranks);
+        reader.readUnsignedInt(vectors);
+        reader.readUnsignedInt(indexBytes);
+        reader.readUnsignedInt(methodUsed);
+        reader.readUnsignedLong(hash);
+        reader.readUnsignedLong(blocks);
+        reader.readUnsignedLong(moves);
+
+        if (hemeLbMagic != io::formats::HemeLbMagicNumber
+            || decompositionMagic != io::formats::decomposition::MagicNumber)
+        {
+          throw Exception() << "File " << path << " is not a HemeLB decomposition";
+        }
+
+        if (version != io::formats::decomposition::VersionNumber || ranks != (unsigned) communicator.Size()
+            || vectors != latticeVectors || indexBytes != sizeof(idx_t) || methodUsed != (unsigned) method
+            || hash != geometryHash || blocks != (uint64_t) blockCount)
+        {
+          log::Logger::Log<log::Info, log::Singleton>("Decomposition file %s was made for a different geometry, number of ranks, lattice or method, decomposing the geometry",
+                                                      path.c_str());
+          return false;
+        }
+
+        const MPI_Offset movesPerProcStart = io::formats::decomposition::HeaderLength
+            + blockCount * sizeof(proc_t);
+        const MPI_Offset movesStart = movesPerProcStart + ranks * sizeof(idx_t);
+
+        procForEachBlock.resize(blockCount);
+        file.ReadAtAll(io::formats::decomposition::HeaderLength, procForEachBlock);
+        movesPerProc.resize(ranks);
+        file.ReadAtAll(movesPerProcStart, movesPerProc);
+        movesList.resize(3 * moves);
+        file.ReadAtAll(movesStart, movesList);
+
+        log::Logger::Log<log::Info, log::Singleton>("Read the decomposition from %s", path.c_str());
+        return true;
+      }
+
+      void DecompositionCache::Write(const std::vector<proc_t>& procForEachBlock,
+                                     const std::vector<idx_t>& localMoves) const
+      {
+        // Every rank needs the number of moves from each rank, to know where its own go.
+        const std::vector<idx_t> movesPerProc = communicator.AllGather((idx_t) (localMoves.size() / 3));
+        uint64_t totalMoves = 0, movesBefore = 0;
+        for (proc_t rank = 0; rank < communicator.Size(); ++rank)
+        {
+          if (rank == communicator.Rank())
+          {
+            movesBefore = totalMoves;
+          }
+          totalMoves += movesPerProc[rank];
+        }
+
+        const MPI_Offset movesPerProcStart = io::formats::decomposition::HeaderLength
+            + blockCount * sizeof(proc_t);
+        const MPI_Offset movesStart = movesPerProcStart + movesPerProc.size() * sizeof(idx_t);
+
+        net::MpiFile file = net::MpiFile::Open(communicator, path, MPI_MODE_WRONLY | MPI_MODE_CREATE);
+
+        if (communicator.Rank() == 0)
+        {
+          std::vector<char> header(io::formats::decomposition::HeaderLength);
+          io::writers::xdr::XdrMemWriter writer(&header[0], io::formats::decomposition::HeaderLength);
+          writer << (uint32_t) io::formats::HemeLbMagicNumber;
+          writer << (uint32_t) io::formats::decomposition::MagicNumber;
+          writer << (uint32_t) io::formats::decomposition::VersionNumber;
+          writer << (uint32_t) communicator.Size();
+          writer << (uint32_t) latticeVectors;
+          writer << (uint32_t) sizeof(idx_t);
+          writer << (uint32_t) method;
+          writer << (uint64_t) geometryHash;
+          writer << (uint64_t) blockCount;
+          writer << totalMoves;
+          file.WriteAt(0, header);
+
+          file.WriteAt(io::formats::decomposition::HeaderLength, procForEachBlock);
+          file.WriteAt(movesPerProcStart, movesPerProc);
+        }
+
+        file.WriteAtAll(movesStart + movesBefore * 3 * sizeof(idx_t), localMoves);
+
+        log::Logger::Log<log::Info, log::Singleton>("Wrote the decomposition to %s", path.c_str());
+      }
+    } /* namespace decomposition */
+  } /* namespace geometry */
+} /* namespace hemelb */
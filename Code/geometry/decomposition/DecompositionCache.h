@@ -0,0 +1,85 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#ifndef HEMELB_GEOMETRY_DECOMPOSITION_DECOMPOSITIONCACHE_H
+#define HEMELB_GEOMETRY_DECOMPOSITION_DECOMPOSITIONCACHE_H
+
+#include <string>
+#include <vector>
+
+#include "geometry/ParmetisHeader.h"
+#include "geometry/decomposition/DecompositionMethod.h"
+#include "net/MpiCommunicator.h"
+#include "units.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      /**
+       * Stores an optimised domain decomposition in a file (see io/formats/decomposition.h), so
+       * that later runs with the same geometry, number of ranks, lattice and decomposition method
+       * can read it back instead of repeating the basic decomposition and its optimisation.
+       *
+       * The decomposition is stored as the basic decomposition of the blocks together with every
+       * site the optimisation moved, from all ranks, which is exactly what GeometryReader needs to
+       * reread the blocks and implement the moves on any rank.
+       */
+      class DecompositionCache
+      {
+        public:
+          /**
+           * @param communicator The ranks the geometry is decomposed over.
+           * @param path The file to use.
+           * @param latticeVectors The number of vectors of the lattice in use.
+           * @param method How the basic decomposition was optimised.
+           * @param geometryHash A hash of the geometry file's preamble and header.
+           * @param blockCount The number of blocks in the geometry.
+           */
+          DecompositionCache(const net::MpiCommunicator& communicator, const std::string& path,
+                             unsigned latticeVectors, DecompositionMethod method,
+                             uint64_t geometryHash, site_t blockCount);
+
+          /**
+           * Read the decomposition from the file, if there is one made for the same geometry,
+           * number of ranks, lattice and method. Collective on the communicator.
+           *
+           * @param procForEachBlock [out] The basic decomposition of the blocks.
+           * @param movesPerProc [out] The number of sites moved from each rank.
+           * @param movesList [out] The moves, as (block, site, rank) triples.
+           * @return true if the decomposition was read, false if there was no usable file.
+           */
+          bool Read(std::vector<proc_t>& procForEachBlock, std::vector<idx_t>& movesPerProc,
+                    std::vector<idx_t>& movesList) const;
+
+          /**
+           * Write the decomposition to the file, replacing any already there. Collective on the
+           * communicator: each rank writes the moves of its own sites, after those of the ranks
+           * before it.
+           *
+           * @param procForEachBlock [in] The basic decomposition of the blocks.
+           * @param localMoves [in] The moves of this rank's sites, as (block, site, rank) triples.
+           */
+          void Write(const std::vector<proc_t>& procForEachBlock,
+                     const std::vector<idx_t>& localMoves) const;
+
+        private:
+          const net::MpiCommunicator& communicator; //! The ranks the geometry is decomposed over.
+          const std::string path; //! The file to use.
+          const unsigned latticeVectors; //! The number of vectors of the lattice in use.
+          const DecompositionMethod method; //! How the basic decomposition was optimised.
+          const uint64_t geometryHash; //! Hash identifying the geometry file.
+          const site_t blockCount; //! The number of blocks in the geometry.
+      };
+    } /* namespace decomposition */
+  } /* namespace geometry */
+} /* namespace hemelb */
+#endif /* HEMELB_GEOMETRY_DECOMPOSITION_DECOMPOSITIONCACHE_H */
@@ -0,0 +1,32 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+#ifndef HEMELB_GEOMETRY_DECOMPOSITION_DECOMPOSITIONMETHOD_H
+#define HEMELB_GEOMETRY_DECOMPOSITION_DECOMPOSITIONMETHOD_H
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      /**
+       * How OptimisedDecomposition improves on the basic decomposition of the blocks.
+       */
+      enum DecompositionMethod
+      {
+        PARMETIS, //!< Partition the graph of fluid sites with ParMETIS
+        MORTON_CURVE, //!< Cut the fluid sites, in Morton (Z) order, into equally weighted chunks
+        HILBERT_CURVE
+      //!< Cut the fluid sites, in Hilbert order, into equally weighted chunks
+      };
+    }
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_DECOMPOSITION_DECOMPOSITIONMETHOD_H */
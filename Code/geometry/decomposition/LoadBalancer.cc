@@ -0,0 +1,136 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#include <algorithm>
+
+#include "geometry/decomposition/LoadBalancer.h"
+#include "log/Logger.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      namespace
+      {
+        // Keep the scales within bounds, so that a noisy measurement can't make the integer
+        // decomposition weights overflow or vanish.
+        const float MinimumScale = 0.1F;
+        const float MaximumScale = 10.0F;
+      }
+
+      LoadBalancer::LoadBalancer(const net::MpiCommunicator& communicator, site_t blockCount,
+                                 const SiteWeights& siteWeights, double threshold) :
+          communicator(communicator), blockCount(blockCount), siteWeights(siteWeights), threshold(threshold),
+              lastCalculationTime(0.0), intervalCalculationTime(0.0)
+      {
+      }
+
+      bool LoadBalancer::IsImbalanced(double calculationTime)
+      {
+        intervalCalculationTime = calculationTime - lastCalculationTime;
+        lastCalculationTime = calculationTime;
+
+        const double slowest = communicator.AllReduce(intervalCalculationTime, MPI_MAX);
+        const double mean = communicator.AllReduce(intervalCalculationTime, MPI_SUM) / communicator.Size();
+        if (mean <= 0.0)
+        {
+          return false;
+        }
+
+        log::Logger::Log<log::Info, log::Singleton>("The slowest rank took %.2f times the mean calculation time.",
+                                                    slowest / mean);
+        return slowest > threshold * mean;
+      }
+
+      void LoadBalancer::UpdateBlockWeightScales(const LatticeData& latticeData)
+      {
+        // The block and collision type of each local site, in the order they are stored: by
+        // collision type, mid-domain sites first.
+        std::vector<site_t> siteBlocks;
+        siteBlocks.reserve(latticeData.GetLocalFluidSiteCount());
+        std::vector<unsigned> siteCollisionTypes;
+        siteCollisionTypes.reserve(latticeData.GetLocalFluidSiteCount());
+        site_t siteIndex = 0;
+        for (unsigned edge = 0; edge < 2; ++edge)
+        {
+          for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+          {
+            const site_t count = edge ?
+              latticeData.GetDomainEdgeCollisionCount(collisionType) :
+              latticeData.GetMidDomainCollisionCount(collisionType);
+            for (site_t site = 0; site < count; ++site, ++siteIndex)
+            {
+              const site_t block =
+                  latticeData.GetBlockIdFromBlockCoords(latticeData.GetSite(siteIndex).GetGlobalSiteCoords()
+                      / latticeData.GetBlockSize());
+              siteBlocks.push_back(block);
+              siteCollisionTypes.push_back(collisionType);
+            }
+          }
+        }
+
+        UpdateBlockWeightScales(siteBlocks, siteCollisionTypes);
+      }
+
+      void LoadBalancer::UpdateBlockWeightScales(const std::vector<site_t>& siteBlocks,
+                                                 const std::vector<unsigned>& siteCollisionTypes)
+      {
+        if (blockWeightScales.empty())
+        {
+          blockWeightScales.resize(blockCount, 1.0F);
+        }
+
+        // The weight of each local site as last decomposed.
+        std::vector<double> localSiteWeights(siteBlocks.size());
+        for (size_t site = 0; site < siteBlocks.size(); ++site)
+        {
+          localSiteWeights[site] = siteWeights[siteCollisionTypes[site]] * blockWeightScales[siteBlocks[site]];
+        }
+
+        // How much more this rank's sites cost per unit weight than the average.
+        double localWeight = 0.0;
+        for (std::vector<double>::const_iterator weight = localSiteWeights.begin();
+            weight != localSiteWeights.end(); ++weight)
+        {
+          localWeight += *weight;
+        }
+        const double totalWeight = communicator.AllReduce(localWeight, MPI_SUM);
+        const double totalTime = communicator.AllReduce(intervalCalculationTime, MPI_SUM);
+        double relativeCost = 1.0;
+        if (localWeight > 0.0 && totalTime > 0.0)
+        {
+          relativeCost = (intervalCalculationTime / localWeight) / (totalTime / totalWeight);
+        }
+
+        // Blocks may be split between ranks, so average the relative cost over each block's
+        // sites, by weight.
+        std::vector<double> costOfEachBlock(blockCount, 0.0);
+        std::vector<double> weightOfEachBlock(blockCount, 0.0);
+        for (size_t site = 0; site < localSiteWeights.size(); ++site)
+        {
+          costOfEachBlock[siteBlocks[site]] += relativeCost * localSiteWeights[site];
+          weightOfEachBlock[siteBlocks[site]] += localSiteWeights[site];
+        }
+        costOfEachBlock = communicator.AllReduce(costOfEachBlock, MPI_SUM);
+        weightOfEachBlock = communicator.AllReduce(weightOfEachBlock, MPI_SUM);
+
+        for (site_t block = 0; block < blockCount; ++block)
+        {
+          if (weightOfEachBlock[block] > 0.0)
+          {
+            const float scale = blockWeightScales[block] * costOfEachBlock[block] / weightOfEachBlock[block];
+            blockWeightScales[block] = std::min(MaximumScale, std::max(MinimumScale, scale));
+          }
+        }
+      }
+    }
+  }
+}
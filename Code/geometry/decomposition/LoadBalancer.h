@@ -0,0 +1,96 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#ifndef HEMELB_GEOMETRY_DECOMPOSITION_LOADBALANCER_H
+#define HEMELB_GEOMETRY_DECOMPOSITION_LOADBALANCER_H
+
+#include <vector>
+#include "geometry/LatticeData.h"
+#include "geometry/decomposition/SiteWeights.h"
+#include "net/MpiCommunicator.h"
+#include "units.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      /**
+       * Watches how long each rank spends on the lattice Boltzmann calculation and, when the
+       * slowest rank falls too far behind the others, works out new decomposition weights.
+       *
+       * The site weights are only estimates: some iolet conditions,
+       * non-Newtonian kernels and colloids cost much more per site than they allow for. The
+       * balancer spreads the time each rank actually took over the weight of its sites. Every
+       * block then gets a factor for its site weights, which is the ratio of its ranks' cost per
+       * unit weight to the mean. Decomposing again with these factors (see
+       * GeometryReader::LoadAndDecompose) moves sites off the slow ranks.
+       */
+      class LoadBalancer
+      {
+        public:
+          /**
+           * @param communicator The ranks doing the lattice Boltzmann calculation.
+           * @param blockCount The number of blocks in the geometry.
+           * @param siteWeights The weight of a site of each collision type, as used to decompose.
+           * @param threshold The ratio of the slowest rank's time to the mean above which to
+           *   rebalance.
+           */
+          LoadBalancer(const net::MpiCommunicator& communicator, site_t blockCount,
+                       const SiteWeights& siteWeights, double threshold);
+
+          /**
+           * Compare the time each rank has spent calculating since the last call. Collective.
+           *
+           * @param calculationTime The total time this rank has spent calculating so far.
+           * @return true if the slowest rank took more than the threshold times the mean.
+           */
+          bool IsImbalanced(double calculationTime);
+
+          /**
+           * Fold the times measured by the last call to IsImbalanced into the weight scale of each
+           * block. Collective.
+           *
+           * @param latticeData The sites on this rank, as decomposed with the current scales.
+           */
+          void UpdateBlockWeightScales(const LatticeData& latticeData);
+
+          /**
+           * As above, given the block and collision type of each of this rank's sites. Collective.
+           *
+           * @param siteBlocks The block of each site on this rank.
+           * @param siteCollisionTypes The collision type of each site on this rank.
+           */
+          void UpdateBlockWeightScales(const std::vector<site_t>& siteBlocks,
+                                       const std::vector<unsigned>& siteCollisionTypes);
+
+          /**
+           * @return The factor for the site weights of each block, or an empty vector until the
+           *   first update.
+           */
+          const std::vector<float>& GetBlockWeightScales() const
+          {
+            return blockWeightScales;
+          }
+
+        private:
+          const net::MpiCommunicator& communicator; //! The ranks doing the calculation.
+          const site_t blockCount; //! The number of blocks in the geometry.
+          const SiteWeights siteWeights; //! The weight of a site of each collision type.
+          const double threshold; //! The imbalance above which to rebalance.
+          double lastCalculationTime; //! This rank's total calculation time at the last check.
+          double intervalCalculationTime; //! This rank's calculation time between the last two checks.
+          std::vector<float> blockWeightScales; //! The factor for the site weights of each block.
+      };
+    }
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_DECOMPOSITION_LOADBALANCER_H */
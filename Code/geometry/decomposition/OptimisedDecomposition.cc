@@ -7,8 +7,10 @@
 // specifically made by you with University College London.
 // 
 
+#include <algorithm>
+
 #include "geometry/decomposition/OptimisedDecomposition.h"
-#include "geometry/decomposition/DecompositionWeights.h"
+#include "geometry/decomposition/SpaceFillingCurveDecomposition.h"
 #include "lb/lattices/D3Q27.h"
 #include "log/Logger.h"
 #include "net/net.h"
@@ -22,9 +24,11 @@ namespace hemelb
       OptimisedDecomposition::OptimisedDecomposition(
           reporting::Timers& timers, net::MpiCommunicator& comms, const Geometry& geometry,
           const lb::lattices::LatticeInfo& latticeInfo, const std::vector<proc_t>& procForEachBlock,
-          const std::vector<site_t>& fluidSitesOnEachBlock) :
+          const std::vector<site_t>& fluidSitesOnEachBlock, const std::vector<float>& blockWeightScales,
+          const SiteWeights& siteWeights, DecompositionMethod method) :
           timers(timers), comms(comms), geometry(geometry), latticeInfo(latticeInfo),
-              procForEachBlock(procForEachBlock), fluidSitesPerBlock(fluidSitesOnEachBlock)
+              procForEachBlock(procForEachBlock), fluidSitesPerBlock(fluidSitesOnEachBlock),
+              blockWeightScales(blockWeightScales), siteWeights(siteWeights), method(method)
       {
         timers[hemelb::reporting::Timers::InitialGeometryRead].Start(); //overall dbg timing
 
@@ -44,28 +48,40 @@ namespace hemelb
           ValidateFirstSiteIndexOnEachBlock();
         }
 
-        // Populate the adjacency data arrays (for ParMetis) and validate if appropriate
         idx_t localVertexCount = vtxDistribn[comms.Rank() + 1] - vtxDistribn[comms.Rank()];
 
-        PopulateAdjacencyData(localVertexCount);
-
-        if (ShouldValidate())
+        if (method == PARMETIS)
         {
-          ValidateAdjacencyData(localVertexCount);
-        }
+          // Populate the adjacency data arrays (for ParMetis) and validate if appropriate
+          PopulateAdjacencyData(localVertexCount);
 
-        log::Logger::Log<log::Trace, log::OnePerCore>("Adj length %i", localAdjacencies.size());
+          if (ShouldValidate())
+          {
+            ValidateAdjacencyData(localVertexCount);
+          }
+
+          log::Logger::Log<log::Trace, log::OnePerCore>("Adj length %i", localAdjacencies.size());
+        }
 
         timers[hemelb::reporting::Timers::InitialGeometryRead].Stop();
 
-        // Call parmetis.
+        // Call parmetis, or cut up a space-filling curve (which needs no adjacency data).
         timers[hemelb::reporting::Timers::parmetis].Start();
-        log::Logger::Log<log::Debug, log::OnePerCore>("Making the call to Parmetis");
+        if (method == PARMETIS)
+        {
+          log::Logger::Log<log::Debug, log::OnePerCore>("Making the call to Parmetis");
 
-        CallParmetis(localVertexCount);
+          CallParmetis(localVertexCount);
+
+          log::Logger::Log<log::Debug, log::OnePerCore>("Parmetis has finished.");
+        }
+        else
+        {
+          log::Logger::Log<log::Debug, log::OnePerCore>("Decomposing along a space-filling curve");
 
+          CallSpaceFillingCurve(localVertexCount);
+        }
         timers[hemelb::reporting::Timers::parmetis].Stop();
-        log::Logger::Log<log::Debug, log::OnePerCore>("Parmetis has finished.");
 
         // Convert the ParMetis results into a nice format.
         timers[hemelb::reporting::Timers::PopulateOptimisationMovesList].Start();
@@ -210,6 +226,17 @@ namespace hemelb
         }
       }
 
+      void OptimisedDecomposition::CallSpaceFillingCurve(idx_t localVertexCount)
+      {
+        PopulateVertexWeightData(localVertexCount);
+
+        SpaceFillingCurveDecomposition curveDecomposition(comms,
+                                                          geometry,
+                                                          procForEachBlock,
+                                                          method);
+        curveDecomposition.Decompose(vertexWeights, partitionVector);
+      }
+
       void OptimisedDecomposition::PopulateVertexWeightData(idx_t localVertexCount)
       {
         // These counters will be used later on to count the number of each type of vertex site
@@ -274,36 +301,45 @@ namespace hemelb
                     switch (siteData.GetCollisionType())
                     {
                       case FLUID:
-                        localweight = hemelbSiteWeights[0];
+                        localweight = siteWeights[0];
                         ++FluidSiteCounter;
                         break;
 
                       case WALL:
-                        localweight = hemelbSiteWeights[1];
+                        localweight = siteWeights[1];
                         ++WallSiteCounter;
                         break;
 
                       case INLET:
-                        localweight = hemelbSiteWeights[2];
+                        localweight = siteWeights[2];
                         ++IOSiteCounter;
                         break;
 
                       case OUTLET:
-                        localweight = hemelbSiteWeights[3];
+                        localweight = siteWeights[3];
                         ++IOSiteCounter;
                         break;
 
                       case (INLET | WALL):
-                        localweight = hemelbSiteWeights[4];
+                        localweight = siteWeights[4];
                         ++WallIOSiteCounter;
                         break;
 
                       case (OUTLET | WALL):
-                        localweight = hemelbSiteWeights[5];
+                        localweight = siteWeights[5];
                         ++WallIOSiteCounter;
                         break;
                     }
 
+                    // Scale by the cost measured for the block, keeping some resolution in the
+                    // integer weights.
+                    if (!blockWeightScales.empty())
+                    {
+                      localweight = std::max(1,
+                                             (int) (localweight * blockWeightScales[blockNumber]
+                                                 * BlockWeightScaleResolution + 0.5));
+                    }
+
                     vertexWeights.push_back(localweight);
                     vertexCoordinates.push_back(blockXCoord + localSiteI);
                     vertexCoordinates.push_back(blockYCoord + localSiteJ);
@@ -320,9 +356,9 @@ namespace hemelb
           }
         }
 
-        int TotalCoreWeight = ( (FluidSiteCounter * hemelbSiteWeights[0])
-            + (WallSiteCounter * hemelbSiteWeights[1]) + (IOSiteCounter * hemelbSiteWeights[2])
-            + (WallIOSiteCounter * hemelbSiteWeights[4])) / hemelbSiteWeights[0];
+        int TotalCoreWeight = ( (FluidSiteCounter * siteWeights[0])
+            + (WallSiteCounter * siteWeights[1]) + (IOSiteCounter * siteWeights[2])
+            + (WallIOSiteCounter * siteWeights[4])) / siteWeights[0];
         int TotalSites = FluidSiteCounter + WallSiteCounter + WallIOSiteCounter;
 
         log::Logger::Log<log::Debug, log::OnePerCore>("There are %u Bulk Flow Sites, %u Wall Sites, %u IO Sites, %u WallIO Sites on core %u. Total: %u (Weighted %u Points)",
@@ -943,6 +979,7 @@ namespace hemelb
         // Right. Let's count how many sites we're going to have to move. Count the local number of
         // sites to be moved, and collect the site id and the destination processor.
         std::vector<idx_t> moveData = CompileMoveData(blockIdLookupByLastSiteIndex);
+        localMoves = moveData;
         // Spread the move data around
         log::Logger::Log<log::Debug, log::OnePerCore>("Starting to spread move data");
         // First, for each core, gather a list of which blocks the current core wants to
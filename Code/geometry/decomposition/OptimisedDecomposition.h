@@ -18,6 +18,8 @@
 #include "net/MpiCommunicator.h"
 #include "geometry/SiteData.h"
 #include "geometry/GeometryBlock.h"
+#include "geometry/decomposition/DecompositionMethod.h"
+#include "geometry/decomposition/SiteWeights.h"
 
 namespace hemelb
 {
@@ -32,7 +34,10 @@ namespace hemelb
                                  const Geometry& geometry,
                                  const lb::lattices::LatticeInfo& latticeInfo,
                                  const std::vector<proc_t>& procForEachBlock,
-                                 const std::vector<site_t>& fluidSitesPerBlock);
+                                 const std::vector<site_t>& fluidSitesPerBlock,
+                                 const std::vector<float>& blockWeightScales,
+                                 const SiteWeights& siteWeights,
+                                 DecompositionMethod method = PARMETIS);
 
           /**
            * Returns a vector with the number of moves coming from each core
@@ -52,8 +57,22 @@ namespace hemelb
             return movesList;
           }
 
+          /**
+           * Returns the moves of this core's own sites, as (block, site, destination rank)
+           * triples in site order. Unlike the moves list, which only has the moves this core needs
+           * to know about, the local moves of all the cores together make up the whole
+           * decomposition.
+           * @return
+           */
+          inline const std::vector<idx_t>& GetLocalMoves() const
+          {
+            return localMoves;
+          }
+
         private:
           typedef util::Vector3D<site_t> BlockLocation;
+          //! The factor site weights are multiplied by when scaled, so that scales close to 1 still make a difference.
+          static const int BlockWeightScaleResolution = 8;
           /**
            * Populates the vector of vertex weights with different values for each local site type.
            * This allows ParMETIS to more efficiently decompose the system.
@@ -90,6 +109,14 @@ namespace hemelb
            */
           void CallParmetis(idx_t localVertexCount);
 
+          /**
+           * Partition the sites along a space-filling curve, instead of calling ParMetis. Returns
+           * the result in the partition vector.
+           *
+           * @param localVertexCount [in] The number of local fluid sites
+           */
+          void CallSpaceFillingCurve(idx_t localVertexCount);
+
           /**
            * Populate the list of moves from each proc that we need locally, using the
            * partition vector.
@@ -214,6 +241,9 @@ namespace hemelb
           const lb::lattices::LatticeInfo& latticeInfo; //! The lattice info to optimise for.
           const std::vector<proc_t>& procForEachBlock; //! The processor assigned to each block at the moment
           const std::vector<site_t>& fluidSitesPerBlock; //! The number of fluid sites on each block.
+          const std::vector<float>& blockWeightScales; //! A factor for the weight of the sites on each block, or empty to use the site weights as they are.
+          const SiteWeights& siteWeights; //! The weight of a site of each collision type.
+          const DecompositionMethod method; //! How to improve on the basic decomposition.
           std::vector<idx_t> vtxDistribn; //! The vertex distribution across participating cores.
           std::vector<idx_t> firstSiteIndexPerBlock; //! The global contiguous index of the first fluid site on each block.
           std::vector<idx_t> adjacenciesPerVertex; //! The number of adjacencies for each local fluid site
@@ -223,6 +253,7 @@ namespace hemelb
           std::vector<idx_t> partitionVector; //! The results of the optimisation -- which core each fluid site should go to.
           std::vector<idx_t> allMoves; //! The list of move counts from each core
           std::vector<idx_t> movesList;
+          std::vector<idx_t> localMoves; //! The moves of this core's own sites.
       };
     }
   }
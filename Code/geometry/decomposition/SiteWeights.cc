@@ -0,0 +1,101 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#include <cmath>
+#include <fstream>
+#include <algorithm>
+
+#include "geometry/decomposition/SiteWeights.h"
+#include "geometry/decomposition/DecompositionWeights.h"
+#include "io/xml/XmlAbstractionLayer.h"
+#include "Exception.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      namespace
+      {
+        //! The element holding the weight of each collision type in the file.
+        const char* const CollisionTypeNames[COLLISION_TYPES] = { "fluid", "wall", "inlet", "outlet",
+                                                                  "inlet_wall", "outlet_wall" };
+        const unsigned WeightsFileVersion = 1;
+      }
+
+      SiteWeights::SiteWeights(const std::string& path) :
+          weights(hemelbSiteWeights, hemelbSiteWeights + COLLISION_TYPES)
+      {
+        if (path.empty())
+        {
+          return;
+        }
+
+        io::xml::Document document(path);
+        const io::xml::Element root = document.GetRoot();
+        if (root.GetName() != "site_weights")
+        {
+          throw Exception() << "Site weights file " << path << " has no site_weights element";
+        }
+        unsigned version;
+        root.GetAttributeOrThrow("version", version);
+        if (version != WeightsFileVersion)
+        {
+          throw Exception() << "Site weights file " << path << " has version " << version
+              << " but only version " << WeightsFileVersion << " is understood";
+        }
+
+        for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+        {
+          const io::xml::Element weightEl = root.GetChildOrThrow(CollisionTypeNames[collisionType]);
+          weightEl.GetAttributeOrThrow("value", weights[collisionType]);
+          if (weights[collisionType] < 1)
+          {
+            throw Exception() << "Site weights must be at least one in " << weightEl.GetPath();
+          }
+        }
+      }
+
+      SiteWeights SiteWeights::FromMeasuredCosts(const std::vector<double>& costPerSite)
+      {
+        SiteWeights siteWeights;
+        const double fluidCost = costPerSite[0];
+        for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+        {
+          double relativeCost = double(hemelbSiteWeights[collisionType]) / hemelbSiteWeights[0];
+          if (fluidCost > 0.0 && costPerSite[collisionType] > 0.0)
+          {
+            relativeCost = costPerSite[collisionType] / fluidCost;
+          }
+          siteWeights.weights[collisionType] = std::max(1, (int) std::floor(relativeCost * WeightResolution
+              + 0.5));
+        }
+        return siteWeights;
+      }
+
+      void SiteWeights::Write(const std::string& path) const
+      {
+        std::ofstream file(path.c_str());
+        if (!file)
+        {
+          throw Exception() << "Couldn't open site weights file " << path << " for writing";
+        }
+        file << "<?xml version=\"1.0\" ?>\n";
+        file << "<site_weights version=\"" << WeightsFileVersion << "\">\n";
+        for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+        {
+          file << "  <" << CollisionTypeNames[collisionType] << " value=\"" << weights[collisionType]
+              << "\" />\n";
+        }
+        file << "</site_weights>\n";
+      }
+    }
+  }
+}
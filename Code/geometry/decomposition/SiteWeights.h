@@ -0,0 +1,81 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#ifndef HEMELB_GEOMETRY_DECOMPOSITION_SITEWEIGHTS_H
+#define HEMELB_GEOMETRY_DECOMPOSITION_SITEWEIGHTS_H
+
+#include <string>
+#include <vector>
+
+#include "constants.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      /**
+       * The relative cost of a site of each collision type (bulk fluid, wall, inlet, outlet,
+       * wall/inlet and wall/outlet), used to weight the sites when decomposing the domain.
+       *
+       * By default these are the weights compiled in from DecompositionWeights.h. They can
+       * instead be read from a file written after measuring how long each collision type
+       * actually takes on the machine in use, e.g.
+       *
+       * <site_weights version="1">
+       *   <fluid value="10" />
+       *   <wall value="13" />
+       *   ...
+       * </site_weights>
+       */
+      class SiteWeights
+      {
+        public:
+          /**
+           * @param path The file to read the weights from, or empty to use the compiled-in weights.
+           */
+          explicit SiteWeights(const std::string& path = std::string());
+
+          /**
+           * Make weights in proportion to the measured cost of a site of each collision type.
+           * The bulk fluid weight is WeightResolution. Types with no cost measured (e.g. there
+           * are no sites of that type) keep their compiled-in weight relative to bulk fluid.
+           *
+           * @param costPerSite The time taken per site of each collision type, or zero if unknown.
+           * @return
+           */
+          static SiteWeights FromMeasuredCosts(const std::vector<double>& costPerSite);
+
+          /**
+           * Write the weights to a file that the constructor can read.
+           * @param path
+           */
+          void Write(const std::string& path) const;
+
+          /**
+           * @param collisionType The index of the collision type (0 to COLLISION_TYPES - 1).
+           * @return The weight of a site of that type.
+           */
+          int operator[](unsigned collisionType) const
+          {
+            return weights[collisionType];
+          }
+
+          //! The weight given to bulk fluid sites by FromMeasuredCosts.
+          static const int WeightResolution = 10;
+
+        private:
+          std::vector<int> weights; //! The weight of each collision type.
+      };
+    }
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_DECOMPOSITION_SITEWEIGHTS_H */
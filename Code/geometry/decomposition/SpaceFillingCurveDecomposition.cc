@@ -0,0 +1,209 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+#include <algorithm>
+#include <utility>
+
+#include "geometry/decomposition/SpaceFillingCurveDecomposition.h"
+#include "Exception.h"
+#include "log/Logger.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      SpaceFillingCurveDecomposition::SpaceFillingCurveDecomposition(
+          const net::MpiCommunicator& communicator, const Geometry& geometry,
+          const std::vector<proc_t>& procForEachBlock, DecompositionMethod curve) :
+          communicator(communicator), geometry(geometry), procForEachBlock(procForEachBlock),
+              curve(curve), bits(1)
+      {
+        // Enough bits for the largest site coordinate.
+        const util::Vector3D<site_t>& blocks = geometry.GetBlockDimensions();
+        const site_t maxSites = std::max(blocks.x, std::max(blocks.y, blocks.z))
+            * geometry.GetBlockSize();
+        while ( ((site_t) 1 << bits) < maxSites)
+        {
+          ++bits;
+        }
+        if (bits > 21)
+        {
+          throw Exception() << "The geometry is too large for a space-filling curve decomposition";
+        }
+      }
+
+      void SpaceFillingCurveDecomposition::Decompose(const std::vector<idx_t>& vertexWeights,
+                                                     std::vector<idx_t>& partitionVector) const
+      {
+        const site_t blockSize = geometry.GetBlockSize();
+        const int rank = communicator.Rank();
+
+        // Total up the weight of each block: every rank needs all of them to place its blocks on
+        // the curve.
+        std::vector<site_t> weightOfEachBlock(geometry.GetBlockCount(), 0);
+        std::vector<idx_t>::const_iterator weight = vertexWeights.begin();
+        for (site_t block = 0; block < geometry.GetBlockCount(); ++block)
+        {
+          if (procForEachBlock[block] != rank)
+          {
+            continue;
+          }
+          const BlockReadResult& blockReadResult = geometry.Blocks[block];
+          for (site_t site = 0; site < geometry.GetSitesPerBlock(); ++site)
+          {
+            if (blockReadResult.Sites[site].targetProcessor != BIG_NUMBER2)
+            {
+              weightOfEachBlock[block] += *weight++;
+            }
+          }
+        }
+        weightOfEachBlock = communicator.AllReduce(weightOfEachBlock, MPI_SUM);
+
+        // Put the blocks in curve order, each placed by its first site, and find the weight of
+        // the curve before each one.
+        std::vector<std::pair<uint64_t, site_t> > blocksInCurveOrder;
+        for (site_t block = 0; block < geometry.GetBlockCount(); ++block)
+        {
+          if (weightOfEachBlock[block] > 0)
+          {
+            blocksInCurveOrder.push_back(std::make_pair(GetKey(geometry.GetBlockCoordinatesFromBlockId(block)
+                                                            * blockSize),
+                                                        block));
+          }
+        }
+        std::sort(blocksInCurveOrder.begin(), blocksInCurveOrder.end());
+
+        std::vector<site_t> weightBeforeEachBlock(geometry.GetBlockCount(), 0);
+        site_t totalWeight = 0;
+        for (std::vector<std::pair<uint64_t, site_t> >::const_iterator it = blocksInCurveOrder.begin();
+            it != blocksInCurveOrder.end(); ++it)
+        {
+          weightBeforeEachBlock[it->second] = totalWeight;
+          totalWeight += weightOfEachBlock[it->second];
+        }
+
+        // Now walk along the curve through the sites of each local block, giving each site to the
+        // rank whose share of the curve contains its middle.
+        const double ranksPerWeight = (double) communicator.Size() / (double) totalWeight;
+        partitionVector.resize(vertexWeights.size());
+        idx_t firstVertexOnBlock = 0;
+        std::vector<std::pair<uint64_t, idx_t> > sitesInCurveOrder;
+        for (site_t block = 0; block < geometry.GetBlockCount(); ++block)
+        {
+          if (procForEachBlock[block] != rank)
+          {
+            continue;
+          }
+
+          const BlockReadResult& blockReadResult = geometry.Blocks[block];
+          const util::Vector3D<site_t> blockOrigin = geometry.GetBlockCoordinatesFromBlockId(block)
+              * blockSize;
+          sitesInCurveOrder.clear();
+          idx_t vertex = firstVertexOnBlock;
+          site_t site = 0;
+          for (site_t localSiteI = 0; localSiteI < blockSize; localSiteI++)
+          {
+            for (site_t localSiteJ = 0; localSiteJ < blockSize; localSiteJ++)
+            {
+              for (site_t localSiteK = 0; localSiteK < blockSize; localSiteK++, site++)
+              {
+                if (blockReadResult.Sites[site].targetProcessor != BIG_NUMBER2)
+                {
+                  util::Vector3D<site_t> location = blockOrigin
+                      + util::Vector3D<site_t>(localSiteI, localSiteJ, localSiteK);
+                  sitesInCurveOrder.push_back(std::make_pair(GetKey(location), vertex++));
+                }
+              }
+            }
+          }
+          std::sort(sitesInCurveOrder.begin(), sitesInCurveOrder.end());
+
+          site_t weightBefore = weightBeforeEachBlock[block];
+          for (std::vector<std::pair<uint64_t, idx_t> >::const_iterator it = sitesInCurveOrder.begin();
+              it != sitesInCurveOrder.end(); ++it)
+          {
+            const idx_t siteWeight = vertexWeights[it->second];
+            idx_t siteRank = (idx_t) ( (weightBefore + 0.5 * siteWeight) * ranksPerWeight);
+            partitionVector[it->second] = std::min(siteRank, (idx_t) (communicator.Size() - 1));
+            weightBefore += siteWeight;
+          }
+
+          firstVertexOnBlock = vertex;
+        }
+      }
+
+      uint64_t SpaceFillingCurveDecomposition::GetKey(const util::Vector3D<site_t>& location) const
+      {
+        return curve == HILBERT_CURVE ?
+          HilbertKey(location, bits) :
+          MortonKey(location, bits);
+      }
+
+      uint64_t SpaceFillingCurveDecomposition::MortonKey(const util::Vector3D<site_t>& location,
+                                                         unsigned bits)
+      {
+        uint64_t key = 0;
+        for (int bit = bits - 1; bit >= 0; --bit)
+        {
+          key = (key << 3) | ( ( (location.x >> bit) & 1) << 2) | ( ( (location.y >> bit) & 1) << 1)
+              | ( (location.z >> bit) & 1);
+        }
+        return key;
+      }
+
+      uint64_t SpaceFillingCurveDecomposition::HilbertKey(const util::Vector3D<site_t>& location,
+                                                          unsigned bits)
+      {
+        uint64_t coords[3] = { (uint64_t) location.x, (uint64_t) location.y, (uint64_t) location.z };
+        const uint64_t highestBit = (uint64_t) 1 << (bits - 1);
+
+        // Undo the excess work of the curve at each level, from the top down.
+        for (uint64_t q = highestBit; q > 1; q >>= 1)
+        {
+          const uint64_t p = q - 1;
+          for (int i = 0; i < 3; ++i)
+          {
+            if (coords[i] & q)
+            {
+              // Invert.
+              coords[0] ^= p;
+            }
+            else
+            {
+              // Exchange.
+              const uint64_t t = (coords[0] ^ coords[i]) & p;
+              coords[0] ^= t;
+              coords[i] ^= t;
+            }
+          }
+        }
+
+        // Gray encode.
+        coords[1] ^= coords[0];
+        coords[2] ^= coords[1];
+        uint64_t t = 0;
+        for (uint64_t q = highestBit; q > 1; q >>= 1)
+        {
+          if (coords[2] & q)
+          {
+            t ^= q - 1;
+          }
+        }
+        for (int i = 0; i < 3; ++i)
+        {
+          coords[i] ^= t;
+        }
+
+        // The key is the transposed coordinates, interleaved.
+        return MortonKey(util::Vector3D<site_t>(coords[0], coords[1], coords[2]), bits);
+      }
+    }
+  }
+}
@@ -0,0 +1,97 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+#ifndef HEMELB_GEOMETRY_DECOMPOSITION_SPACEFILLINGCURVEDECOMPOSITION_H
+#define HEMELB_GEOMETRY_DECOMPOSITION_SPACEFILLINGCURVEDECOMPOSITION_H
+
+#include <vector>
+#include "geometry/Geometry.h"
+#include "geometry/ParmetisHeader.h"
+#include "geometry/decomposition/DecompositionMethod.h"
+#include "net/MpiCommunicator.h"
+#include "units.h"
+#include "util/Vector3D.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      /**
+       * Decomposes the fluid sites by ordering them along a space-filling curve and cutting the
+       * curve into chunks of equal weight, one per rank. Unlike ParMETIS this needs no graph of
+       * the sites and only a single reduction over the blocks, so it scales to any number of
+       * ranks, at the price of a somewhat larger edge cut.
+       *
+       * Each rank orders the sites of its own blocks; the blocks are placed along the curve using
+       * the total weight of each block, which is shared between all ranks. When the block size is
+       * a power of two every block covers a contiguous stretch of the curve, so the order is
+       * exactly the curve order; otherwise it is the curve order of the blocks and then of the
+       * sites within each block.
+       */
+      class SpaceFillingCurveDecomposition
+      {
+        public:
+          /**
+           * @param communicator The ranks to decompose over.
+           * @param geometry The geometry, with the blocks in procForEachBlock read on this rank.
+           * @param procForEachBlock The basic decomposition of the blocks.
+           * @param curve MORTON_CURVE or HILBERT_CURVE.
+           */
+          SpaceFillingCurveDecomposition(const net::MpiCommunicator& communicator,
+                                         const Geometry& geometry,
+                                         const std::vector<proc_t>& procForEachBlock,
+                                         DecompositionMethod curve);
+
+          /**
+           * Find the rank for each of the fluid sites on this rank's blocks. These are ordered as
+           * for ParMETIS: by block id, then by site id within the block.
+           *
+           * @param vertexWeights [in] The weight of each local fluid site.
+           * @param partitionVector [out] The rank for each local fluid site.
+           */
+          void Decompose(const std::vector<idx_t>& vertexWeights,
+                         std::vector<idx_t>& partitionVector) const;
+
+          /**
+           * The position of a site along the Morton (Z order) curve.
+           *
+           * @param location The coordinates of the site, each less than 2^bits.
+           * @param bits The number of bits per coordinate (at most 21).
+           * @return
+           */
+          static uint64_t MortonKey(const util::Vector3D<site_t>& location, unsigned bits);
+
+          /**
+           * The position of a site along the Hilbert curve, using Skilling's transpose algorithm
+           * ("Programming the Hilbert curve", AIP Conf. Proc. 707, 2004).
+           *
+           * @param location The coordinates of the site, each less than 2^bits.
+           * @param bits The number of bits per coordinate (at most 21).
+           * @return
+           */
+          static uint64_t HilbertKey(const util::Vector3D<site_t>& location, unsigned bits);
+
+        private:
+          /**
+           * The position of a site along the curve in use.
+           */
+          uint64_t GetKey(const util::Vector3D<site_t>& location) const;
+
+          const net::MpiCommunicator& communicator; //! The ranks to decompose over.
+          const Geometry& geometry; //! The geometry being decomposed.
+          const std::vector<proc_t>& procForEachBlock; //! The basic decomposition of the blocks.
+          const DecompositionMethod curve; //! The curve to use.
+          unsigned bits; //! The number of bits needed for each site coordinate.
+      };
+    }
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_DECOMPOSITION_SPACEFILLINGCURVEDECOMPOSITION_H */
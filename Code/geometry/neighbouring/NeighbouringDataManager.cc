@@ -121,6 +121,19 @@ namespace hemelb
                              source);
 
         }
+        const unsigned numVectors = localLatticeData.GetLatticeInfo().GetNumVectors();
+        if (!SiteFOldContiguous)
+        {
+          // The buffer must be sized up-front: the requests hold pointers into it.
+          site_t sendCount = 0;
+          for (proc_t other = 0; other < net.Size(); other++)
+          {
+            sendCount += needsEachProcHasFromMe[other].size();
+          }
+          fOldSendBuffer.resize(sendCount * numVectors);
+        }
+
+        site_t sendsSoFar = 0;
         for (proc_t other = 0; other < net.Size(); other++)
         {
           for (std::vector<site_t>::iterator needOnProcFromMe =
@@ -131,11 +144,14 @@ namespace hemelb
                 localLatticeData.GetLocalContiguousIdFromGlobalNoncontiguousId(*needOnProcFromMe);
             Site<LatticeData> site =
                 const_cast<LatticeData&>(localLatticeData).GetSite(localContiguousId);
+            // Gather now (where needed) rather than when the send happens, by which time
+            // in-place streaming may have overwritten the values.
+            distribn_t* buffer = SiteFOldContiguous ?
+              NULL :
+              &fOldSendBuffer[sendsSoFar * numVectors];
             // have to cast away the const, because no respect for const-ness for sends in MPI
-            net.RequestSend(const_cast<distribn_t*>(site.GetFOld(localLatticeData.GetLatticeInfo().GetNumVectors())),
-                            localLatticeData.GetLatticeInfo().GetNumVectors(),
-                            other);
-
+            net.RequestSend(const_cast<distribn_t*>(site.GetFOld(buffer)), numVectors, other);
+            ++sendsSoFar;
           }
         }
       }
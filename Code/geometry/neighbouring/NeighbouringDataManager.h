@@ -60,6 +60,8 @@ namespace hemelb
 
           std::vector<site_t> neededSites;
           std::vector<std::vector<site_t> > needsEachProcHasFromMe;
+          //! Staging area for the distributions we send, when they can't be sent straight from fOld.
+          std::vector<distribn_t> fOldSendBuffer;
 
           bool needsHaveBeenShared;
 
@@ -60,6 +60,16 @@ namespace hemelb
               Site<const NeighbouringLatticeData>(localContiguousIndex, latticeData)
           {
           }
+
+          /**
+           * Neighbouring data is always stored site-contiguously, whatever the layout of the
+           * local distributions, so a pointer can be given directly.
+           */
+          template<typename LatticeType>
+          inline const distribn_t* GetFOld() const
+          {
+            return latticeData.GetFOld(index * LatticeType::NUMVECTORS);
+          }
       };
     }
   }
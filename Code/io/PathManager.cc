@@ -28,6 +28,7 @@ namespace hemelb
       imageDirectory = outputDir + "/Images/";
       dataPath = outputDir + "/Extracted/";
       colloidFile = outputDir + "/ColloidOutput.xdr";
+      checkpointDirectory = outputDir + "/Checkpoints/";
 
       if (doIo)
       {
@@ -37,6 +38,7 @@ namespace hemelb
         hemelb::util::MakeDirAllRXW(outputDir);
         hemelb::util::MakeDirAllRXW(imageDirectory);
         hemelb::util::MakeDirAllRXW(dataPath);
+        hemelb::util::MakeDirAllRXW(checkpointDirectory);
         reportName = outputDir;
       }
     }
@@ -79,6 +81,13 @@ namespace hemelb
       return dataPath;
     }
 
+    std::string PathManager::GetCheckpointPath(const unsigned long time) const
+    {
+      char filename[255];
+      snprintf(filename, 255, "%08lu.chk", time);
+      return checkpointDirectory + std::string(filename);
+    }
+
     void PathManager::SaveConfiguration(configuration::SimConfig * const simConfig) const
     {
       if (doIo)
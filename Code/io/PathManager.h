@@ -81,6 +81,13 @@ namespace hemelb
          * @return
          */
         const std::string& GetDataExtractionPath() const;
+
+        /**
+         * Return the path that the checkpoint for the given time step should be written to.
+         * @param time The time step from which a restart would resume.
+         * @return
+         */
+        std::string GetCheckpointPath(const unsigned long time) const;
       private:
         void GuessOutputDir(); //! String processing to generate an appropriate outptu folder name.
         std::string outputDir;
@@ -90,6 +97,7 @@ namespace hemelb
         std::string configLeafName;
         std::string reportName;
         std::string dataPath;
+        std::string checkpointDirectory;
         const configuration::CommandLine &options;
         bool doIo; //! Am I the input/output node?
     };
@@ -0,0 +1,73 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#ifndef HEMELB_IO_FORMATS_CHECKPOINT_H
+#define HEMELB_IO_FORMATS_CHECKPOINT_H
+
+#include "io/formats/formats.h"
+
+namespace hemelb
+{
+  namespace io
+  {
+    namespace formats
+    {
+      namespace checkpoint
+      {
+        /* The format comprises an XDR header and then a body.
+         * Header is made up of (hex file position, type, description)
+         * 00   uint       HemeLB magic number (see formats.h)
+         * 04   uint       Checkpoint magic number (see below)
+         * 08   uint       Version number
+         * 0C   uint       Number of values stored per site (NUMVECTORS + 1)
+         * 10   uint       Number of values stored per colloid particle
+         * 14   uint64     Time step at which to resume the simulation
+         * 1C   uint64     Number of fluid sites
+         * 24   uint64     Number of values of iolet state
+         * 2C   uint64     Number of colloid particles
+         * Header length = 52 bytes
+         *
+         * The body is written in the native binary representation of the
+         * machine that made the checkpoint, in four sections:
+         * - the iolet state, one double per value;
+         * - the colloid particles, one record of doubles per particle;
+         * - the global (non-contiguous) id of each site, one uint64 per site;
+         * - the site values, one record of doubles per site in the same order
+         *   as the ids. Each record holds the distribution followed by the
+         *   per-site state of the collision kernel (zero if it has none).
+         *
+         * Sites are keyed by their global id rather than by their position in
+         * the file so that a checkpoint can be read back by a different number
+         * of processes.
+         */
+
+        enum
+        {
+          /* Identify checkpoint files
+           * ASCII for 'chk', then EOF
+           * Combined magic number is
+           * hex    68 6c 62 21 63 68 6b 04
+           * ascii:  h  l  b  !  c  h  k EOF
+           */
+          MagicNumber = 0x63686b04
+        };
+        enum
+        {
+          VersionNumber = 1
+        };
+        enum
+        {
+          HeaderLength = 52
+        };
+      }
+    }
+  }
+
+}
+#endif // HEMELB_IO_FORMATS_CHECKPOINT_H
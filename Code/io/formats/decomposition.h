@@ -0,0 +1,74 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#ifndef HEMELB_IO_FORMATS_DECOMPOSITION_H
+#define HEMELB_IO_FORMATS_DECOMPOSITION_H
+
+#include "io/formats/formats.h"
+
+namespace hemelb
+{
+  namespace io
+  {
+    namespace formats
+    {
+      namespace decomposition
+      {
+        /* The format comprises an XDR header and then a body.
+         * Header is made up of (hex file position, type, description)
+         * 00   uint       HemeLB magic number (see formats.h)
+         * 04   uint       Decomposition magic number (see below)
+         * 08   uint       Version number
+         * 0C   uint       Number of ranks the geometry was decomposed over
+         * 10   uint       Number of vectors of the lattice
+         * 14   uint       Bytes per ParMETIS index (sizeof(idx_t))
+         * 18   uint       Decomposition method (geometry::decomposition::DecompositionMethod)
+         * 1C   uint64     Hash of the geometry file's preamble and header
+         * 24   uint64     Number of blocks
+         * 2C   uint64     Number of sites moved by the optimisation
+         * Header length = 52 bytes
+         *
+         * The ranks, lattice, method and hash are the key: a file with any of
+         * them different from the current run is ignored.
+         *
+         * The body is written in the native binary representation of the
+         * machine that made it, in three sections:
+         * - the rank of each block in the basic decomposition, one int per block;
+         * - the number of sites moved from each rank, one idx_t per rank;
+         * - the moves, three idx_t per site (block, site in block, new rank),
+         *   ordered by the rank the site was moved from.
+         *
+         * Together these give the final rank of every site, as applied by
+         * GeometryReader::ImplementMoves.
+         */
+
+        enum
+        {
+          /* Identify decomposition files
+           * ASCII for 'dcm', then EOF
+           * Combined magic number is
+           * hex    68 6c 62 21 64 63 6d 04
+           * ascii:  h  l  b  !  d  c  m EOF
+           */
+          MagicNumber = 0x64636d04
+        };
+        enum
+        {
+          VersionNumber = 3
+        };
+        enum
+        {
+          HeaderLength = 52
+        };
+      }
+    }
+  }
+
+}
+#endif // HEMELB_IO_FORMATS_DECOMPOSITION_H
@@ -62,6 +62,35 @@ namespace hemelb
           //!< VersionNumber
           };
 
+          /**
+           * Version number for the columnar variant of the geometry format.
+           *
+           * The preamble and header are as for VersionNumber, except that the padding value at
+           * the end of the preamble gives the Codec used to compress the blocks. Each block
+           * decompresses to a set of little-endian arrays, which can be copied straight out:
+           *  * 1 uint8 per site for the SiteType
+           *  * 1 uint8 per displacement (NumberOfDisplacements) per fluid site for the CutType
+           *  * 1 uint8 per fluid site for the WallNormalAvailability
+           *  * 1 float32 per cut link for the cut distance
+           *  * 1 uint32 per link cutting an inlet or outlet for the inlet/outlet ID
+           *  * 3 float32s per fluid site with a wall normal for the normal
+           * Sites, and the links of each site, are in the same order as in VersionNumber files.
+           */
+          enum
+          {
+            ColumnarVersionNumber = 5
+          };
+
+          /**
+           * Type codes for the compression of the blocks in a columnar geometry file.
+           */
+          enum Codec
+          {
+            CODEC_ZLIB = 0, //!< zlib, as used by VersionNumber files
+            CODEC_LZ4 = 1
+          //!< LZ4 block format (no frame)
+          };
+
           /**
            * Type codes permitted for sites
            */
@@ -176,6 +205,19 @@ namespace hemelb
             return (nFluidSites * geometry::MaxFluidSiteRecordLength + nSolidSites * geometry::MaxSolidSiteRecordLength);
           }
 
+          /**
+           * Compute the maximum length of a block's data in a columnar file, given the number of
+           * fluid sites contained within it.
+           * @param blockSideLength
+           * @param nFluidSites
+           * @return max length in bytes
+           */
+          static inline unsigned int GetMaxColumnarBlockLength(unsigned int blockSideLength, unsigned int nFluidSites)
+          {
+            return blockSideLength * blockSideLength * blockSideLength
+                + nFluidSites * (geometry::NumberOfDisplacements * (1 + 4 + 4) + 1 + 3 * 4);
+          }
+
           /**
            * Give the displacement to a neighbouring lattice point.
            */
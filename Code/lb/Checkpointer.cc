@@ -0,0 +1,267 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+
+#include <limits>
+#include <map>
+
+#include "lb/Checkpointer.h"
+#include "Exception.h"
+#include "io/formats/checkpoint.h"
+#include "io/writers/xdr/XdrMemReader.h"
+#include "io/writers/xdr/XdrMemWriter.h"
+#include "net/MpiFile.h"
+
+namespace hemelb
+{
+  namespace lb
+  {
+    namespace
+    {
+      /**
+       * The process that collects the checkpointed values of a site while the
+       * checkpoint is redistributed.
+       */
+      int GetDirectoryRank(site_t siteId, int size)
+      {
+        return (int) (siteId % size);
+      }
+
+      /**
+       * Work out how to group the given sites by their directory rank.
+       * @param siteIds
+       * @param size
+       * @param counts set to the number of sites for each rank
+       * @param order set so that order[i] is the index of the ith site once grouped
+       */
+      void GroupByDirectoryRank(const std::vector<site_t>& siteIds, int size, std::vector<int>& counts,
+                                std::vector<site_t>& order)
+      {
+        counts.assign(size, 0);
+        for (std::vector<site_t>::const_iterator it = siteIds.begin(); it != siteIds.end(); ++it)
+        {
+          ++counts[GetDirectoryRank(*it, size)];
+        }
+
+        std::vector<site_t> next(size, 0);
+        for (int rank = 1; rank < size; ++rank)
+        {
+          next[rank] = next[rank - 1] + counts[rank - 1];
+        }
+
+        order.resize(siteIds.size());
+        for (site_t i = 0; i < (site_t) siteIds.size(); ++i)
+        {
+          order[next[GetDirectoryRank(siteIds[i], size)]++] = i;
+        }
+      }
+
+      /**
+       * Convert counts of sites into counts of values, which MPI needs as ints.
+       */
+      std::vector<int> ScaleCounts(const std::vector<int>& counts, unsigned factor)
+      {
+        std::vector<int> ans(counts);
+        for (std::vector<int>::iterator it = ans.begin(); it != ans.end(); ++it)
+        {
+          if (factor != 0 && *it > std::numeric_limits<int>::max() / (int) factor)
+          {
+            throw Exception() << "Too many checkpoint values to redistribute in one message: " << *it
+                << " sites of " << factor << " values";
+          }
+          *it *= factor;
+        }
+        return ans;
+      }
+    }
+
+    Checkpointer::Checkpointer(const net::IOCommunicator& comms) :
+        comms(comms)
+    {
+    }
+
+    void Checkpointer::Write(const std::string& path, const CheckpointData& data) const
+    {
+      const uint64_t localSites = data.siteIds.size();
+      const uint64_t localParticles = data.valuesPerParticle == 0 ?
+        0 :
+        data.particleValues.size() / data.valuesPerParticle;
+
+      // Find where this process's records go.
+      const std::vector<uint64_t> sitesPerRank = comms.AllGather(localSites);
+      const std::vector<uint64_t> particlesPerRank = comms.AllGather(localParticles);
+      uint64_t totalSites = 0, siteOffset = 0, totalParticles = 0, particleOffset = 0;
+      for (int rank = 0; rank < comms.Size(); ++rank)
+      {
+        if (rank == comms.Rank())
+        {
+          siteOffset = totalSites;
+          particleOffset = totalParticles;
+        }
+        totalSites += sitesPerRank[rank];
+        totalParticles += particlesPerRank[rank];
+      }
+
+      const MPI_Offset particleStart = io::formats::checkpoint::HeaderLength
+          + data.ioletState.size() * sizeof(distribn_t);
+      const MPI_Offset idStart = particleStart + totalParticles * data.valuesPerParticle * sizeof(distribn_t);
+      const MPI_Offset valueStart = idStart + totalSites * sizeof(site_t);
+
+      const MPI_Offset fileLength = valueStart + totalSites * data.valuesPerSite * sizeof(distribn_t);
+
+      // Rewriting an existing checkpoint, e.g. when restarting into the same output directory,
+      // mustn't leave the tail of a longer old file after our data.
+      net::MpiFile file = net::MpiFile::Open(comms, path, MPI_MODE_WRONLY | MPI_MODE_CREATE);
+      file.SetSize(fileLength);
+
+      if (comms.OnIORank())
+      {
+        std::vector<char> header(io::formats::checkpoint::HeaderLength);
+        io::writers::xdr::XdrMemWriter writer(&header[0], io::formats::checkpoint::HeaderLength);
+        writer << (uint32_t) io::formats::HemeLbMagicNumber;
+        writer << (uint32_t) io::formats::checkpoint::MagicNumber;
+        writer << (uint32_t) io::formats::checkpoint::VersionNumber;
+        writer << (uint32_t) data.valuesPerSite;
+        writer << (uint32_t) data.valuesPerParticle;
+        writer << (uint64_t) data.timeStep;
+        writer << (uint64_t) totalSites;
+        writer << (uint64_t) data.ioletState.size();
+        writer << (uint64_t) totalParticles;
+        file.WriteAt(0, header);
+
+        if (!data.ioletState.empty())
+        {
+          file.WriteAt(io::formats::checkpoint::HeaderLength, data.ioletState);
+        }
+      }
+
+      file.WriteAtAll(particleStart + particleOffset * data.valuesPerParticle * sizeof(distribn_t),
+                      data.particleValues);
+      file.WriteAtAll(idStart + siteOffset * sizeof(site_t), data.siteIds);
+      file.WriteAtAll(valueStart + siteOffset * data.valuesPerSite * sizeof(distribn_t), data.siteValues);
+    }
+
+    void Checkpointer::Read(const std::string& path, CheckpointData& data) const
+    {
+      net::MpiFile file = net::MpiFile::Open(comms, path, MPI_MODE_RDONLY);
+
+      std::vector<char> header(io::formats::checkpoint::HeaderLength);
+      file.ReadAtAll(0, header);
+
+      io::writers::xdr::XdrMemReader reader(&header[0], io::formats::checkpoint::HeaderLength);
+      unsigned hemeLbMagic, checkpointMagic, version, valuesPerSite;
+      uint64_t timeStep, totalSites, ioletStateSize, totalParticles;
+      reader.readUnsignedInt(hemeLbMagic);
+      reader.readUnsignedInt(checkpointMagic);
+      reader.readUnsignedInt(version);
+      reader.readUnsignedInt(valuesPerSite);
+      reader.readUnsignedInt(data.valuesPerParticle);
+      reader.readUnsignedLong(timeStep);
+      reader.readUnsignedLong(totalSites);
+      reader.readUnsignedLong(ioletStateSize);
+      reader.readUnsignedLong(totalParticles);
+
+      if (hemeLbMagic != io::formats::HemeLbMagicNumber || checkpointMagic != io::formats::checkpoint::MagicNumber)
+      {
+        throw Exception() << "File " << path << " is not a HemeLB checkpoint";
+      }
+      if (version != io::formats::checkpoint::VersionNumber)
+      {
+        throw Exception() << "Checkpoint " << path << " has version " << version << " but expected "
+            << (unsigned) io::formats::checkpoint::VersionNumber;
+      }
+      if (valuesPerSite != data.valuesPerSite)
+      {
+        throw Exception() << "Checkpoint " << path << " has " << valuesPerSite << " values per site but expected "
+            << data.valuesPerSite << " - was it made with a different lattice?";
+      }
+      data.timeStep = timeStep;
+
+      // The iolet state and the particles are small: everyone reads all of them.
+      const MPI_Offset particleStart = io::formats::checkpoint::HeaderLength + ioletStateSize * sizeof(distribn_t);
+      const MPI_Offset idStart = particleStart + totalParticles * data.valuesPerParticle * sizeof(distribn_t);
+      const MPI_Offset valueStart = idStart + totalSites * sizeof(site_t);
+
+      data.ioletState.resize(ioletStateSize);
+      file.ReadAtAll(io::formats::checkpoint::HeaderLength, data.ioletState);
+      data.particleValues.resize(totalParticles * data.valuesPerParticle);
+      file.ReadAtAll(particleStart, data.particleValues);
+
+      // Each process reads an even share of the sites...
+      const int size = comms.Size();
+      const uint64_t firstRead = totalSites * comms.Rank() / size;
+      const uint64_t endRead = totalSites * (comms.Rank() + 1) / size;
+      std::vector<site_t> readIds(endRead - firstRead);
+      std::vector<distribn_t> readValues(readIds.size() * valuesPerSite);
+      file.ReadAtAll(idStart + firstRead * sizeof(site_t), readIds);
+      file.ReadAtAll(valueStart + firstRead * valuesPerSite * sizeof(distribn_t), readValues);
+
+      // ... and sends each one to its directory rank.
+      std::vector<int> counts, receivedCounts;
+      std::vector<site_t> order;
+      GroupByDirectoryRank(readIds, size, counts, order);
+
+      std::vector<site_t> groupedIds(readIds.size());
+      std::vector<distribn_t> groupedValues(readValues.size());
+      for (site_t i = 0; i < (site_t) order.size(); ++i)
+      {
+        groupedIds[i] = readIds[order[i]];
+        std::copy(readValues.begin() + order[i] * valuesPerSite,
+                  readValues.begin() + (order[i] + 1) * valuesPerSite,
+                  groupedValues.begin() + i * valuesPerSite);
+      }
+
+      const std::vector<site_t> directoryIds = comms.AllToAllV(groupedIds, counts, receivedCounts);
+      const std::vector<distribn_t> directoryValues = comms.AllToAllV(groupedValues,
+                                                                      ScaleCounts(counts, valuesPerSite),
+                                                                      receivedCounts);
+
+      std::map<site_t, site_t> directory;
+      for (site_t i = 0; i < (site_t) directoryIds.size(); ++i)
+      {
+        directory[directoryIds[i]] = i;
+      }
+
+      // Now ask the directory ranks for the sites we need...
+      GroupByDirectoryRank(data.siteIds, size, counts, order);
+      std::vector<site_t> requestedIds(order.size());
+      for (site_t i = 0; i < (site_t) order.size(); ++i)
+      {
+        requestedIds[i] = data.siteIds[order[i]];
+      }
+      const std::vector<site_t> requestsReceived = comms.AllToAllV(requestedIds, counts, receivedCounts);
+
+      // ... which answer, in the order asked ...
+      std::vector<distribn_t> replies(requestsReceived.size() * valuesPerSite);
+      for (site_t i = 0; i < (site_t) requestsReceived.size(); ++i)
+      {
+        std::map<site_t, site_t>::const_iterator found = directory.find(requestsReceived[i]);
+        if (found == directory.end())
+        {
+          throw Exception() << "Checkpoint " << path << " has no data for site " << requestsReceived[i];
+        }
+        std::copy(directoryValues.begin() + found->second * valuesPerSite,
+                  directoryValues.begin() + (found->second + 1) * valuesPerSite,
+                  replies.begin() + i * valuesPerSite);
+      }
+      const std::vector<distribn_t> answers = comms.AllToAllV(replies,
+                                                              ScaleCounts(receivedCounts, valuesPerSite),
+                                                              counts);
+
+      // ... which we put back into the order requested.
+      data.siteValues.resize(data.siteIds.size() * valuesPerSite);
+      for (site_t i = 0; i < (site_t) order.size(); ++i)
+      {
+        std::copy(answers.begin() + i * valuesPerSite,
+                  answers.begin() + (i + 1) * valuesPerSite,
+                  data.siteValues.begin() + order[i] * valuesPerSite);
+      }
+    }
+  }
+}
@@ -0,0 +1,88 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+
+#ifndef HEMELB_LB_CHECKPOINTER_H
+#define HEMELB_LB_CHECKPOINTER_H
+
+#include <string>
+#include <vector>
+
+#include "units.h"
+#include "net/IOCommunicator.h"
+
+namespace hemelb
+{
+  namespace lb
+  {
+    /**
+     * The state of a simulation, as held by one process, that is needed to restart it.
+     */
+    struct CheckpointData
+    {
+        CheckpointData() :
+            timeStep(0), valuesPerSite(0), valuesPerParticle(0)
+        {
+        }
+
+        //! The time step at which the restarted simulation should resume.
+        LatticeTimeStep timeStep;
+        //! The number of values stored for each site.
+        unsigned valuesPerSite;
+        //! The global non-contiguous id of each site.
+        std::vector<site_t> siteIds;
+        //! The values of each site, in the same order as siteIds.
+        std::vector<distribn_t> siteValues;
+        //! The state of the inlets and outlets (identical on every process).
+        std::vector<distribn_t> ioletState;
+        //! The number of values stored for each colloid particle.
+        unsigned valuesPerParticle;
+        //! The records of the colloid particles owned by this process.
+        std::vector<distribn_t> particleValues;
+    };
+
+    /**
+     * Writes and reads checkpoint files (see io/formats/checkpoint.h) with
+     * collective MPI-IO.
+     *
+     * Sites are identified by their global id, so a checkpoint written by
+     * one number of processes can be read by another.
+     */
+    class Checkpointer
+    {
+      public:
+        Checkpointer(const net::IOCommunicator& comms);
+
+        /**
+         * Write a checkpoint. Collective over the communicator.
+         * @param path the file to write
+         * @param data this process's part of the state
+         */
+        void Write(const std::string& path, const CheckpointData& data) const;
+
+        /**
+         * Read a checkpoint. Collective over the communicator.
+         *
+         * On entry, data.siteIds holds the ids of the sites this process needs
+         * and data.valuesPerSite the number of values it expects per site.
+         * On return, siteValues holds the values for those sites, in the same
+         * order, and the remaining members are filled in. Every process gets
+         * every colloid particle.
+         * @param path the file to read
+         * @param data
+         */
+        void Read(const std::string& path, CheckpointData& data) const;
+
+      private:
+        const net::IOCommunicator& comms;
+    };
+  }
+}
+
+#endif /* HEMELB_LB_CHECKPOINTER_H */
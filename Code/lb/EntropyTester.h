@@ -68,7 +68,8 @@ namespace hemelb
               {
                 const geometry::Site<const geometry::LatticeData> site = mLatDat->GetSite(i);
 
-                HFunction<LatticeType> HFunc(site.GetFOld<LatticeType>(), NULL);
+                distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+                HFunction<LatticeType> HFunc(site.GetFOld<LatticeType>(fOldBuffer), NULL);
                 dHMax = util::NumericalFunctions::max(dHMax, HFunc.eval() - mHPreCollision[i]);
               }
             }
@@ -84,7 +85,8 @@ namespace hemelb
               {
                 const geometry::Site<const geometry::LatticeData> site = mLatDat->GetSite(i);
 
-                HFunction<LatticeType> HFunc(site.GetFOld<LatticeType>(), NULL);
+                distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+                HFunction<LatticeType> HFunc(site.GetFOld<LatticeType>(fOldBuffer), NULL);
                 dHMax = util::NumericalFunctions::max(dHMax, HFunc.eval() - mHPreCollision[i]);
               }
             }
@@ -140,7 +142,8 @@ namespace hemelb
               for (site_t i = offset; i < offset + mLatDat->GetMidDomainCollisionCount(collision_type); i++)
               {
                 const geometry::Site<const geometry::LatticeData> site = mLatDat->GetSite(i);
-                HFunction<LatticeType> HFunc(site.GetFOld<LatticeType>(), NULL);
+                distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+                HFunction<LatticeType> HFunc(site.GetFOld<LatticeType>(fOldBuffer), NULL);
                 mHPreCollision[i] = HFunc.eval();
               }
             }
@@ -155,7 +158,8 @@ namespace hemelb
               for (site_t i = offset; i < offset + mLatDat->GetDomainEdgeCollisionCount(collision_type); i++)
               {
                 const geometry::Site<const geometry::LatticeData> site = mLatDat->GetSite(i);
-                HFunction<LatticeType> HFunc(site.GetFOld<LatticeType>(), NULL);
+                distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+                HFunction<LatticeType> HFunc(site.GetFOld<LatticeType>(fOldBuffer), NULL);
                 mHPreCollision[i] = HFunc.eval();
               }
             }
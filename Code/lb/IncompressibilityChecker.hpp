@@ -189,11 +189,14 @@ namespace hemelb
     {
       timings[hemelb::reporting::Timers::monitoring].Start();
 
-      for (site_t i = 0; i < mLatDat->GetLocalFluidSiteCount(); i++)
-      {
-        upwardsDensityTracker.UpdateDensityTracker(propertyCache.densityCache.Get(i),
-                                                   propertyCache.velocityCache.Get(i).GetMagnitude());
-      }
+      // The streamers have already reduced the local densities and velocities while colliding.
+      distribn_t localDensities[DensityTracker::DENSITY_TRACKER_SIZE];
+      localDensities[DensityTracker::MIN_DENSITY] = propertyCache.monitoringAccumulator.GetMinDensity();
+      localDensities[DensityTracker::MAX_DENSITY] = propertyCache.monitoringAccumulator.GetMaxDensity();
+      localDensities[DensityTracker::MAX_VELOCITY_MAGNITUDE] =
+          propertyCache.monitoringAccumulator.GetMaxVelocityMagnitude();
+
+      upwardsDensityTracker.UpdateDensityTracker(DensityTracker(localDensities));
 
       timings[hemelb::reporting::Timers::monitoring].Stop();
     }
@@ -12,6 +12,7 @@
 
 #include <vector>
 #include "geometry/LatticeData.h"
+#include "lb/MonitoringAccumulator.h"
 #include "lb/SimulationState.h"
 #include "units.h"
 #include "util/RefreshableCache.hpp"
@@ -86,6 +87,12 @@ namespace hemelb
          */
         util::RefreshableCache<util::Vector3D<LatticeStress> > tangentialProjectionTractionCache;
 
+        /**
+         * The stability and incompressibility reductions over the fluid sites on this core,
+         * accumulated while streaming.
+         */
+        MonitoringAccumulator monitoringAccumulator;
+
       private:
         /**
          * The state of the simulation, including the number of timesteps passed.
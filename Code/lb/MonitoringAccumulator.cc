@@ -0,0 +1,128 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include "lb/MonitoringAccumulator.h"
+
+namespace hemelb
+{
+  namespace lb
+  {
+    MonitoringAccumulator::Slot::Slot() :
+      timeStep(std::numeric_limits<LatticeTimeStep>::max())
+    {
+      Restart(timeStep);
+    }
+
+    void MonitoringAccumulator::Slot::Restart(LatticeTimeStep newTimeStep)
+    {
+      timeStep = newTimeStep;
+      minDensity = DBL_MAX;
+      maxDensity = -DBL_MAX;
+      maxVelocitySquared = 0.0;
+      nonPositiveDistribution = false;
+    }
+
+    MonitoringAccumulator::MonitoringAccumulator(const SimulationState& simState) :
+#ifdef HEMELB_USE_OPENMP
+      simState(simState), requiresRefreshing(false), slotCount(omp_get_max_threads()), slotMemory(NULL)
+#else
+      simState(simState), requiresRefreshing(false), slotCount(1), slotMemory(NULL)
+#endif
+    {
+      void* memory;
+      if (posix_memalign(&memory, CacheLineSize, slotCount * SlotStride) != 0)
+      {
+        throw std::bad_alloc();
+      }
+      slotMemory = static_cast<char*>(memory);
+
+      for (unsigned slot = 0; slot < slotCount; ++slot)
+      {
+        new (slotMemory + slot * SlotStride) Slot();
+      }
+    }
+
+    MonitoringAccumulator::~MonitoringAccumulator()
+    {
+      // Slot is trivially destructible, so just release the memory.
+      free(slotMemory);
+    }
+
+    void MonitoringAccumulator::SetRefreshFlag()
+    {
+      requiresRefreshing = true;
+    }
+
+    void MonitoringAccumulator::UnsetRefreshFlag()
+    {
+      requiresRefreshing = false;
+    }
+
+    bool MonitoringAccumulator::IsNonPositiveDistributionPresent() const
+    {
+      bool nonPositive = false;
+      for (unsigned slotIndex = 0; slotIndex < slotCount; ++slotIndex)
+      {
+        const Slot& slot = GetSlot(slotIndex);
+        if (slot.timeStep == simState.GetTimeStep())
+        {
+          nonPositive |= slot.nonPositiveDistribution;
+        }
+      }
+      return nonPositive;
+    }
+
+    distribn_t MonitoringAccumulator::GetMinDensity() const
+    {
+      distribn_t minDensity = DBL_MAX;
+      for (unsigned slotIndex = 0; slotIndex < slotCount; ++slotIndex)
+      {
+        const Slot& slot = GetSlot(slotIndex);
+        if (slot.timeStep == simState.GetTimeStep() && slot.minDensity < minDensity)
+        {
+          minDensity = slot.minDensity;
+        }
+      }
+      return minDensity;
+    }
+
+    distribn_t MonitoringAccumulator::GetMaxDensity() const
+    {
+      distribn_t maxDensity = -DBL_MAX;
+      for (unsigned slotIndex = 0; slotIndex < slotCount; ++slotIndex)
+      {
+        const Slot& slot = GetSlot(slotIndex);
+        if (slot.timeStep == simState.GetTimeStep() && slot.maxDensity > maxDensity)
+        {
+          maxDensity = slot.maxDensity;
+        }
+      }
+      return maxDensity;
+    }
+
+    distribn_t MonitoringAccumulator::GetMaxVelocityMagnitude() const
+    {
+      distribn_t maxVelocitySquared = 0.0;
+      for (unsigned slotIndex = 0; slotIndex < slotCount; ++slotIndex)
+      {
+        const Slot& slot = GetSlot(slotIndex);
+        if (slot.timeStep == simState.GetTimeStep() && slot.maxVelocitySquared > maxVelocitySquared)
+        {
+          maxVelocitySquared = slot.maxVelocitySquared;
+        }
+      }
+      return std::sqrt(maxVelocitySquared);
+    }
+  }
+}
@@ -0,0 +1,165 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#ifndef HEMELB_LB_MONITORINGACCUMULATOR_H
+#define HEMELB_LB_MONITORINGACCUMULATOR_H
+
+#include <cstddef>
+#ifdef HEMELB_USE_OPENMP
+#include <omp.h>
+#endif
+
+#include "lb/SimulationState.h"
+#include "units.h"
+#include "util/Vector3D.h"
+
+namespace hemelb
+{
+  namespace lb
+  {
+    /**
+     * Local reductions needed by the stability tester and the incompressibility checker,
+     * gathered by the streamers as each site is collided rather than in a separate sweep over
+     * the distributions afterwards.
+     *
+     * Each OpenMP thread accumulates into its own slot. The slots are allocated on cache line
+     * boundaries, one or more lines apart, so that threads never write to the same line. A slot
+     * is restarted the first time it is written on a new time step, and only slots written on
+     * the current time step are merged when the results are read, so no explicit reset between
+     * steps is needed.
+     */
+    class MonitoringAccumulator
+    {
+      public:
+        MonitoringAccumulator(const SimulationState& simState);
+
+        ~MonitoringAccumulator();
+
+        /**
+         * Request that the streamers accumulate on this time step.
+         */
+        void SetRefreshFlag();
+
+        void UnsetRefreshFlag();
+
+        bool RequiresRefresh() const
+        {
+          return requiresRefreshing;
+        }
+
+        /**
+         * Add one site's values. Safe to call concurrently from different OpenMP threads.
+         *
+         * @param density
+         * @param velocity
+         * @param fPostCollision The post-collision distributions the site is about to stream.
+         */
+        template<class LatticeType>
+        inline void Accumulate(distribn_t density,
+                               const util::Vector3D<distribn_t>& velocity,
+                               const distribn_t* fPostCollision)
+        {
+#ifdef HEMELB_USE_OPENMP
+          Slot& slot = GetSlot(omp_get_thread_num());
+#else
+          Slot& slot = GetSlot(0);
+#endif
+          if (slot.timeStep != simState.GetTimeStep())
+          {
+            slot.Restart(simState.GetTimeStep());
+          }
+
+          // Note that by testing for value > 0.0, we also catch stray NaNs.
+          bool nonPositive = false;
+          for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+          {
+            nonPositive |= ! (fPostCollision[direction] > 0.0);
+          }
+          slot.nonPositiveDistribution |= nonPositive;
+
+          if (density < slot.minDensity)
+          {
+            slot.minDensity = density;
+          }
+          if (density > slot.maxDensity)
+          {
+            slot.maxDensity = density;
+          }
+
+          const distribn_t velocitySquared = velocity.GetMagnitudeSquared();
+          if (velocitySquared > slot.maxVelocitySquared)
+          {
+            slot.maxVelocitySquared = velocitySquared;
+          }
+        }
+
+        /**
+         * @return Whether any distribution accumulated this time step was zero, negative or NaN.
+         */
+        bool IsNonPositiveDistributionPresent() const;
+
+        /**
+         * @return The smallest density accumulated this time step, or DBL_MAX if none was.
+         */
+        distribn_t GetMinDensity() const;
+
+        /**
+         * @return The largest density accumulated this time step, or -DBL_MAX if none was.
+         */
+        distribn_t GetMaxDensity() const;
+
+        /**
+         * @return The largest velocity magnitude accumulated this time step, or 0 if none was.
+         */
+        distribn_t GetMaxVelocityMagnitude() const;
+
+      private:
+        struct Slot
+        {
+            Slot();
+
+            void Restart(LatticeTimeStep newTimeStep);
+
+            LatticeTimeStep timeStep;
+            distribn_t minDensity;
+            distribn_t maxDensity;
+            distribn_t maxVelocitySquared;
+            bool nonPositiveDistribution;
+        };
+
+        static const size_t CacheLineSize = 64;
+        //! The distance between consecutive slots, a whole number of cache lines.
+        static const size_t SlotStride = ( (sizeof(Slot) + CacheLineSize - 1) / CacheLineSize)
+            * CacheLineSize;
+
+        // Owns the slot memory, so not copyable.
+        MonitoringAccumulator(const MonitoringAccumulator&);
+        MonitoringAccumulator& operator=(const MonitoringAccumulator&);
+
+        inline Slot& GetSlot(unsigned slot)
+        {
+          return *reinterpret_cast<Slot*>(slotMemory + slot * SlotStride);
+        }
+
+        inline const Slot& GetSlot(unsigned slot) const
+        {
+          return *reinterpret_cast<const Slot*>(slotMemory + slot * SlotStride);
+        }
+
+        const SimulationState& simState;
+        bool requiresRefreshing;
+        //! One slot per OpenMP thread, or a single slot without OpenMP.
+        unsigned slotCount;
+        //! Cache line aligned storage for the slots.
+        char* slotMemory;
+    };
+  }
+}
+
+#endif /* HEMELB_LB_MONITORINGACCUMULATOR_H */
@@ -32,6 +32,11 @@ namespace hemelb
       timeStep = 1;
     }
 
+    void SimulationState::SetTimeStep(LatticeTimeStep value)
+    {
+      timeStep = value;
+    }
+
     void SimulationState::SetIsTerminating(bool value)
     {
       isTerminating = value;
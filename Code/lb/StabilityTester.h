@@ -12,6 +12,8 @@
 
 #include "net/PhasedBroadcastRegular.h"
 #include "geometry/LatticeData.h"
+#include "lb/MacroscopicPropertyCache.h"
+#include "log/Logger.h"
 
 namespace hemelb
 {
@@ -34,11 +36,21 @@ namespace hemelb
     {
       public:
         StabilityTester(const geometry::LatticeData * iLatDat, net::Net* net,
-                        SimulationState* simState, reporting::Timers& timings,
+                        SimulationState* simState, lb::MacroscopicPropertyCache& propertyCache,
+                        reporting::Timers& timings,
                         const hemelb::configuration::SimConfig::MonitoringConfig* testerConfig) :
             net::PhasedBroadcastRegular<>(net, simState, SPREADFACTOR), mLatDat(iLatDat),
-                mSimState(simState), timings(timings), testerConfig(testerConfig)
+                mSimState(simState), propertyCache(propertyCache), timings(timings), testerConfig(testerConfig),
+                doConvergenceCheck(testerConfig->doConvergenceCheck)
         {
+#ifdef HEMELB_USE_AA_PATTERN
+          // Streaming in place overwrites fOld, so there's nothing to compare fNew with.
+          if (doConvergenceCheck)
+          {
+            log::Logger::Log<log::Warning, log::Singleton>("Convergence checking is not available when streaming in place, so will not be done");
+            doConvergenceCheck = false;
+          }
+#endif
           Reset();
         }
 
@@ -88,6 +100,11 @@ namespace hemelb
          * method rather than in ProgressToParent to make sure that the current timestep has
          * finished streaming.
          *
+         * The positivity of the distributions is not checked by sweeping the lattice here: the
+         * streamers have already accumulated it in the property cache as each site collided.
+         * Only the convergence check, which compares two time levels, still needs a pass over
+         * the sites.
+         *
          * @param splayNumber
          */
         void PostSendToParent(unsigned long splayNumber)
@@ -98,53 +115,38 @@ namespace hemelb
           // sending up a 'Unstable' value anyway.
           if (mUpwardsStability != Unstable)
           {
-            bool unconvergedSitePresent = false;
-
-            for (site_t i = 0; i < mLatDat->GetLocalFluidSiteCount(); i++)
+            if (propertyCache.monitoringAccumulator.IsNonPositiveDistributionPresent())
             {
-              for (unsigned int l = 0; l < LatticeType::NUMVECTORS; l++)
-              {
-                distribn_t value = *mLatDat->GetFNew(i * LatticeType::NUMVECTORS + l);
+              mUpwardsStability = Unstable;
+            }
+          }
 
-                // Note that by testing for value > 0.0, we also catch stray NaNs.
-                if (! (value > 0.0))
-                {
-                  mUpwardsStability = Unstable;
-                  break;
-                }
-              }
-              ///@todo: If we refactor the previous loop out, we can get away with a single break statement
-              if (mUpwardsStability == Unstable)
-              {
-                break;
-              }
+          if (mUpwardsStability != Unstable)
+          {
+            bool unconvergedSitePresent = false;
 
-              if (testerConfig->doConvergenceCheck)
+            if (doConvergenceCheck)
+            {
+              for (site_t i = 0; i < mLatDat->GetLocalFluidSiteCount(); i++)
               {
+                distribn_t fNewBuffer[LatticeType::NUMVECTORS];
+                distribn_t fOldBuffer[LatticeType::NUMVECTORS];
                 distribn_t relativeDifference =
-                    ComputeRelativeDifference(mLatDat->GetFNew(i * LatticeType::NUMVECTORS),
-                                              mLatDat->GetSite(i).GetFOld<LatticeType>());
+                    ComputeRelativeDifference(mLatDat->template GetSiteFNew<LatticeType>(i, fNewBuffer),
+                                              mLatDat->GetSite(i).template GetFOld<LatticeType>(fOldBuffer));
 
                 if (relativeDifference > testerConfig->convergenceRelativeTolerance)
                 {
                   // The simulation is stable but hasn't converged in the whole domain yet.
                   unconvergedSitePresent = true;
+                  break;
                 }
               }
             }
 
-            switch (mUpwardsStability)
-            {
-              case UndefinedStability:
-              case Stable:
-              case StableAndConverged:
-                mUpwardsStability = (testerConfig->doConvergenceCheck && !unconvergedSitePresent) ?
-                  StableAndConverged :
-                  Stable;
-                break;
-              case Unstable:
-                break;
-            }
+            mUpwardsStability = (doConvergenceCheck && !unconvergedSitePresent) ?
+              StableAndConverged :
+              Stable;
           }
 
           timings[hemelb::reporting::Timers::monitoring].Stop();
@@ -235,7 +237,7 @@ namespace hemelb
             }
 
             // If the simulation wasn't found to be unstable and we need to check for convergence, do it now.
-            if ( (mUpwardsStability != Unstable) && testerConfig->doConvergenceCheck)
+            if ( (mUpwardsStability != Unstable) && doConvergenceCheck)
             {
               bool anyStableNotConverged = false;
               bool anyConverged = false;
@@ -305,11 +307,17 @@ namespace hemelb
          */
         lb::SimulationState* mSimState;
 
+        /** The property cache, holding the reductions accumulated while streaming. */
+        lb::MacroscopicPropertyCache& propertyCache;
+
         /** Timing object. */
         reporting::Timers& timings;
 
         /** Object containing the user-provided configuration for this class */
         const hemelb::configuration::SimConfig::MonitoringConfig* testerConfig;
+
+        /** Whether to check for convergence as well as stability. */
+        bool doConvergenceCheck;
     };
   }
 }
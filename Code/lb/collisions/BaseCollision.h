@@ -13,6 +13,7 @@
 #include "constants.h"
 #include "lb/LbmParameters.h"
 #include "geometry/LatticeData.h"
+#include "lb/kernels/BaseKernel.h"
 
 namespace hemelb
 {
@@ -33,12 +34,21 @@ namespace hemelb
        *  - DoCalculatePreCollision(CHydroVars&, site_t)
        *  - DoCollide(const LbmParameters*, unsigned int, CHydroVars&) returns distribn_t
        *  - DoReset(InitParams*)
+       *
+       * Collisions that can work on kernels::SimdWidth sites at once set MultiSite to true and
+       * implement
+       *  - DoCalculatePreCollisionMultiSite(CMultiSiteHydroVars&)
+       *  - DoCollideMultiSite(const LbmParameters*, CMultiSiteHydroVars&)
        */
       template<typename CollisionImpl, typename KernelImpl>
       class BaseCollision
       {
         public:
           typedef KernelImpl CKernel;
+          typedef kernels::MultiSiteHydroVars<typename KernelImpl::LatticeType> CMultiSiteHydroVars;
+
+          //! Whether the collision provides the multi-site functions. Collisions that do hide this.
+          static const bool MultiSite = false;
 
           inline void CalculatePreCollision(kernels::HydroVars<KernelImpl>& hydroVars,
                                             const geometry::Site<geometry::LatticeData>& site)
@@ -52,6 +62,16 @@ namespace hemelb
             static_cast<CollisionImpl*>(this)->DoCollide(lbmParams, hydroVars);
           }
 
+          inline void CalculatePreCollisionMultiSite(CMultiSiteHydroVars& hydroVars)
+          {
+            static_cast<CollisionImpl*>(this)->DoCalculatePreCollisionMultiSite(hydroVars);
+          }
+
+          inline void CollideMultiSite(const LbmParameters* lbmParams, CMultiSiteHydroVars& hydroVars)
+          {
+            static_cast<CollisionImpl*>(this)->DoCollideMultiSite(lbmParams, hydroVars);
+          }
+
       };
 
     }
@@ -27,6 +27,7 @@ namespace hemelb
       {
         public:
           typedef KernelType CKernel;
+          static const bool MultiSite = KernelType::MultiSite;
 
           Normal(kernels::InitParams& initParams) :
               kernel(initParams)
@@ -45,6 +46,26 @@ namespace hemelb
             kernel.Collide(lbmParams, iHydroVars);
           }
 
+          inline void DoCalculatePreCollisionMultiSite(kernels::MultiSiteHydroVars<typename KernelType::LatticeType>& hydroVars)
+          {
+            kernel.CalculateDensityMomentumFeqMultiSite(hydroVars);
+          }
+
+          inline void DoCollideMultiSite(const LbmParameters* lbmParams,
+                                         kernels::MultiSiteHydroVars<typename KernelType::LatticeType>& hydroVars)
+          {
+            kernel.CollideMultiSite(lbmParams, hydroVars);
+          }
+
+          inline distribn_t GetKernelSiteState(site_t index) const
+          {
+            return kernel.GetSiteState(index);
+          }
+
+          inline void SetKernelSiteState(site_t index, distribn_t value)
+          {
+            kernel.SetSiteState(index, value);
+          }
 
           KernelType kernel;
 
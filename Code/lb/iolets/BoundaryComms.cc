@@ -8,9 +8,7 @@
 // 
 
 #include "lb/iolets/BoundaryComms.h"
-#include "lb/iolets/BoundaryValues.h"
-#include "net/IOCommunicator.h"
-#include "util/utilityFunctions.h"
+#include "net/MpiDataType.h"
 
 namespace hemelb
 {
@@ -19,112 +17,41 @@ namespace hemelb
     namespace iolets
     {
 
-      BoundaryComms::BoundaryComms(SimulationState* iSimState, std::vector<int> &iProcsList, const BoundaryCommunicator& boundaryComm, bool iHasBoundary) :
-          hasBoundary(iHasBoundary), nProcs((int) iProcsList.size()), procsList(iProcsList), bcComm(boundaryComm)
+      BoundaryComms::BoundaryComms(const std::vector<int>& procsList,
+                                   const net::MpiCommunicator& ioletComm) :
+          procsList(procsList), ioletComm(ioletComm), request(MPI_REQUEST_NULL)
       {
-        /* iProcsList contains the procs containing said Boundary/iolet, but NOT proc 0 (the BoundaryControlling/BC proc)! */
-
-        // Only BC proc sends
-        if (bcComm.IsCurrentProcTheBCProc())
-        {
-          sendRequest = new MPI_Request[nProcs];
-          sendStatus = new MPI_Status[nProcs];
-        }
-        else
-        {
-          sendRequest = NULL;
-          sendStatus = NULL;
-        }
       }
 
       BoundaryComms::~BoundaryComms()
       {
-
-        if (bcComm.IsCurrentProcTheBCProc())
-        {
-          delete[] sendRequest;
-          delete[] sendStatus;
-        }
-      }
-
-      void BoundaryComms::Wait()
-      {
-        if (hasBoundary)
-        {
-          HEMELB_MPI_CALL(
-              MPI_Wait, (&receiveRequest, &receiveStatus)
-          );
-        }
-      }
-
-      void BoundaryComms::WaitAllComms()
-      {
-        // Now wait for all to complete
-        if (bcComm.IsCurrentProcTheBCProc())
-        {
-          HEMELB_MPI_CALL(
-              MPI_Waitall, (nProcs, sendRequest, sendStatus)
-          );
-
-          if (hasBoundary)
-            HEMELB_MPI_CALL(
-                MPI_Wait, (&receiveRequest, &receiveStatus)
-            );
-        }
-        else
-        {
-          HEMELB_MPI_CALL(
-              MPI_Wait, (&receiveRequest, &receiveStatus)
-          );
-        }
-
+        Wait();
       }
 
-      // It is up to the caller to make sure only BCproc calls send
-      void BoundaryComms::Send(distribn_t* density)
+      void BoundaryComms::Broadcast(double* values, int count)
       {
-        for (int proc = 0; proc < nProcs; proc++)
+        // Nothing to do if the BC proc is the only one with the iolet.
+        if (ioletComm.Size() == 1)
         {
-          HEMELB_MPI_CALL(
-              MPI_Isend, (
-                  density,
-                  1,
-                  net::MpiDataType(*density),
-                  procsList[proc],
-                  100,
-                  bcComm,
-                  &sendRequest[proc]
-              ));
+          return;
         }
-      }
 
-      void BoundaryComms::Receive(distribn_t* density)
-      {
-        if (hasBoundary)
-        {
-          HEMELB_MPI_CALL(
-              MPI_Irecv, (
-                  density,
-                  1,
-                  net::MpiDataType(*density),
-                  bcComm.GetBCProcRank(),
-                  100,
-                  bcComm,
-                  &receiveRequest
-              ));
-        }
+        HEMELB_MPI_CALL(
+            MPI_Ibcast, (
+                values,
+                count,
+                net::MpiDataType<double>(),
+                0,
+                ioletComm,
+                &request
+            ));
       }
 
-      void BoundaryComms::FinishSend()
+      void BoundaryComms::Wait()
       {
-        // Don't move on to next step with BC proc until all messages have been sent
-        // Precautionary measure to make sure proc doesn't overwrite, before message is sent
-        if (bcComm.IsCurrentProcTheBCProc())
-        {
-          HEMELB_MPI_CALL(
-              MPI_Waitall, (nProcs, sendRequest, sendStatus)
-          );
-        }
+        HEMELB_MPI_CALL(
+            MPI_Wait, (&request, MPI_STATUS_IGNORE)
+        );
       }
 
     }
@@ -10,10 +10,8 @@
 #ifndef HEMELB_LB_IOLETS_BOUNDARYCOMMS_H
 #define HEMELB_LB_IOLETS_BOUNDARYCOMMS_H
 
-#include "geometry/LatticeData.h"
-#include "lb/SimulationState.h"
-#include "util/UnitConverter.h"
-#include "lb/iolets/BoundaryCommunicator.h"
+#include <vector>
+#include "net/MpiCommunicator.h"
 
 namespace hemelb
 {
@@ -22,44 +20,48 @@ namespace hemelb
     namespace iolets
     {
 
+      /**
+       * The communication for a single iolet. The BC proc broadcasts the iolet's values to all
+       * the procs with sites on the iolet over a communicator of just those procs (with the BC
+       * proc as rank 0), using a nonblocking broadcast so that the other procs only have to wait
+       * for it when they need the values.
+       */
       class BoundaryComms
       {
         public:
-          BoundaryComms(SimulationState* iSimState, std::vector<int> &iProcsList, const BoundaryCommunicator& boundaryComm, bool iHasBoundary);
+          /**
+           * @param procsList The procs with sites on the iolet.
+           * @param ioletComm The communicator of the BC proc and the procs in procsList.
+           */
+          BoundaryComms(const std::vector<int>& procsList, const net::MpiCommunicator& ioletComm);
           ~BoundaryComms();
 
-          void Wait();
+          /**
+           * Start broadcasting values from the BC proc to the other procs with the iolet. Must
+           * be called on all of them. The values must be left alone until Wait is called.
+           * @param values
+           * @param count
+           */
+          void Broadcast(double* values, int count);
 
-          // It is up to the caller to make sure only BCproc calls send
-          void Send(distribn_t* density);
-          void Receive(distribn_t* density);
+          /**
+           * Wait for the broadcast to complete, if there is one in progress.
+           */
+          void Wait();
 
           const std::vector<int>& GetListOfProcs() const
           {
             return procsList;
           }
 
-          void ReceiveDoubles(double* double_array, int size);
-          void WaitAllComms();
-          void FinishSend();
-
         private:
-          // This is necessary to support BC proc having fluid sites
-          bool hasBoundary;
-
-          // These are only assigned on the BC proc as it is the only one that needs to know
-          // which proc has which IOlet
-          int nProcs;
+          //! The procs which have sites on the iolet.
           std::vector<int> procsList;
-          const BoundaryCommunicator& bcComm;
-
-          MPI_Request *sendRequest;
-          MPI_Status *sendStatus;
-
-          MPI_Request receiveRequest;
-          MPI_Status receiveStatus;
+          //! The BC proc and the procs in procsList, with the BC proc as rank 0.
+          net::MpiCommunicator ioletComm;
 
-          SimulationState* mState;
+          //! The broadcast in progress, or MPI_REQUEST_NULL.
+          MPI_Request request;
       };
 
     }
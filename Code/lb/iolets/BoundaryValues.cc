@@ -9,6 +9,8 @@
 
 #include "lb/iolets/BoundaryValues.h"
 #include "lb/iolets/BoundaryComms.h"
+#include "lb/MacroscopicPropertyCache.h"
+#include "net/MpiDataType.h"
 #include "util/utilityFunctions.h"
 #include "util/fileutils.h"
 #include <algorithm>
@@ -27,10 +29,9 @@ namespace hemelb
                                      const net::MpiCommunicator& comms,
                                      const util::UnitConverter& units) :
         net::IteratedAction(), ioletType(ioletType), totalIoletCount(incoming_iolets.size()), localIoletCount(0),
-            state(simulationState), unitConverter(units), bcComms(comms)
+            state(simulationState), unitConverter(units), bcComms(comms),
+            flowRateRequest(MPI_REQUEST_NULL), propertyCache(NULL)
       {
-        std::vector<int> *procsList = new std::vector<int>[totalIoletCount];
-
         // Determine which iolets need comms and create them
         for (int ioletIndex = 0; ioletIndex < totalIoletCount; ioletIndex++)
         {
@@ -40,10 +41,20 @@ namespace hemelb
           iolet->Initialise(&unitConverter);
 
           iolets.push_back(iolet);
+          ioletNormals.push_back(iolet->GetNormal());
+          velocityIolets.push_back(dynamic_cast<iolets::InOutLetVelocity*>(iolet));
+
+          iolets::InOutLetWindkessel* windkessel = dynamic_cast<iolets::InOutLetWindkessel*>(iolet);
+          if (windkessel != NULL)
+          {
+            windkessels.push_back(windkessel);
+            windkesselSites.push_back(GetLocalSitesOnIolet(latticeData, ioletIndex));
+          }
 
           bool isIOletOnThisProc = IsIOletOnThisProc(ioletType, latticeData, ioletIndex);
           hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("BOUNDARYVALUES.CC - isioletonthisproc? : %d", isIOletOnThisProc);
-          procsList[ioletIndex] = GatherProcList(isIOletOnThisProc);
+          std::vector<int> procsList = GatherProcList(isIOletOnThisProc);
+          net::MpiCommunicator ioletComm = CreateIoletCommunicator(procsList);
 
           // With information on whether a proc has an IOlet and the list of procs for each IOlte
           // on the BC task we can create the comms
@@ -55,26 +66,34 @@ namespace hemelb
 
 //            if (iolet->IsCommsRequired()) //DEREK: POTENTIAL MULTISCALE ISSUE (this if-statement)
 //            {
-              iolet->SetComms(new BoundaryComms(state, procsList[ioletIndex], bcComms, isIOletOnThisProc));
+              iolet->SetComms(new BoundaryComms(procsList, ioletComm));
 //            }
           }
         }
 
+        localFlowRates.resize(windkessels.size());
+        flowRates.resize(windkessels.size());
+
         // Send out initial values
         Reset();
+        UpdateCurrentValues();
 
-        // Clear up
-        delete[] procsList;
-
-        hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("BOUNDARYVALUES.H - ioletCount: %d, first iolet ID %d", localIoletCount, localIoletIDs[0]);
+        // Ranks other than the BC proc may have no sites on any iolet.
+        hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("BOUNDARYVALUES.H - ioletCount: %d, first iolet ID %d",
+                                                                              localIoletCount,
+                                                                              localIoletCount > 0
+                                                                                ? localIoletIDs[0]
+                                                                                : -1);
 
       }
 
       BoundaryValues::~BoundaryValues()
       {
+        HEMELB_MPI_CALL(MPI_Wait, (&flowRateRequest, MPI_STATUS_IGNORE));
 
         for (int i = 0; i < totalIoletCount; i++)
         {
+          delete iolets[i]->GetComms();
           delete iolets[i];
         }
       }
@@ -93,7 +112,23 @@ namespace hemelb
           }
         }
 
-        return true;
+        return false;
+      }
+
+      std::vector<site_t> BoundaryValues::GetLocalSitesOnIolet(geometry::LatticeData* latticeData,
+                                                               int boundaryId) const
+      {
+        std::vector<site_t> sites;
+        for (site_t i = 0; i < latticeData->GetLocalFluidSiteCount(); i++)
+        {
+          const geometry::Site<geometry::LatticeData> site = latticeData->GetSite(i);
+
+          if (site.GetSiteType() == ioletType && site.GetIoletId() == boundaryId)
+          {
+            sites.push_back(i);
+          }
+        }
+        return sites;
       }
 
       std::vector<int> BoundaryValues::GatherProcList(bool hasBoundary)
@@ -109,25 +144,38 @@ namespace hemelb
         // Each stores true/false value. True if proc of rank equal to the index contains
         // the given inlet/outlet.
 
-        std::vector<int> processorsNeedingIoletFlags = bcComms.Gather(isIOletOnThisProc, bcComms.GetBCProcRank());
+        // Every proc gets the flags, so that they can all make the iolet's communicator.
+        std::vector<int> processorsNeedingIoletFlags = bcComms.AllGather(isIOletOnThisProc);
 
-        if (bcComms.IsCurrentProcTheBCProc())
+        // Now we have an array for each IOlet with true (1) at indices corresponding to
+        // processes that are members of that group. We have to convert this into arrays
+        // of ints which store a list of processor ranks.
+        for (proc_t process = 0; process < (proc_t) processorsNeedingIoletFlags.size(); ++process)
         {
-          // Now we have an array for each IOlet with true (1) at indices corresponding to
-          // processes that are members of that group. We have to convert this into arrays
-          // of ints which store a list of processor ranks.
-          for (proc_t process = 0; process < processorsNeedingIoletFlags.size(); ++process)
+          if (processorsNeedingIoletFlags[process])
           {
-            if (processorsNeedingIoletFlags[process])
-            {
-              processorsNeedingIoletList.push_back(process);
-            }
+            processorsNeedingIoletList.push_back(process);
           }
         }
 
         return processorsNeedingIoletList; // return by copy
       }
 
+      net::MpiCommunicator BoundaryValues::CreateIoletCommunicator(const std::vector<int>& procsList)
+      {
+        // The BC proc comes first, so it is rank 0 and the root of the broadcasts.
+        std::vector<int> members(1, bcComms.GetBCProcRank());
+        for (std::vector<int>::const_iterator proc = procsList.begin(); proc != procsList.end(); ++proc)
+        {
+          if (*proc != bcComms.GetBCProcRank())
+          {
+            members.push_back(*proc);
+          }
+        }
+
+        return bcComms.Create(bcComms.Group().Include(members));
+      }
+
       void BoundaryValues::RequestComms()
       {
         for (int i = 0; i < localIoletCount; i++)
@@ -148,12 +196,50 @@ namespace hemelb
 
       void BoundaryValues::EndIteration()
       {
-        for (int i = 0; i < localIoletCount; i++)
+        if (windkessels.empty())
         {
-          if (GetLocalIolet(i)->IsCommsRequired())
+          return;
+        }
+
+        for (unsigned i = 0; i < windkessels.size(); i++)
+        {
+          // The normal points into the domain, so the flow out is against it. Each site
+          // contributes the flow through its unit cross-section.
+          const util::Vector3D<Dimensionless>& normal = windkessels[i]->GetNormal();
+          LatticeFlowRate flowRate = 0.0;
+          for (std::vector<site_t>::const_iterator site = windkesselSites[i].begin();
+              site != windkesselSites[i].end(); ++site)
           {
-            GetLocalIolet(i)->GetComms()->FinishSend();
+            flowRate -= propertyCache->velocityCache.Get(*site).Dot(normal);
           }
+          localFlowRates[i] = flowRate;
+        }
+
+        // A single reduction for all the Windkessel iolets, which is waited for only when their
+        // pressures are next needed.
+        HEMELB_MPI_CALL(
+            MPI_Iallreduce, (
+                &localFlowRates[0],
+                &flowRates[0],
+                (int) flowRates.size(),
+                net::MpiDataType<LatticeFlowRate>(),
+                MPI_SUM,
+                bcComms,
+                &flowRateRequest
+            ));
+      }
+
+      void BoundaryValues::ApplyFlowRates()
+      {
+        if (flowRateRequest == MPI_REQUEST_NULL)
+        {
+          return;
+        }
+
+        HEMELB_MPI_CALL(MPI_Wait, (&flowRateRequest, MPI_STATUS_IGNORE));
+        for (unsigned i = 0; i < windkessels.size(); i++)
+        {
+          windkessels[i]->UpdateFlowRate(flowRates[i]);
         }
       }
 
@@ -163,24 +249,67 @@ namespace hemelb
         {
           if (GetLocalIolet(i)->IsCommsRequired())
           {
-            GetLocalIolet(i)->GetComms()->Wait();
+            GetLocalIolet(i)->FinishComms();
+          }
+        }
+
+        ApplyFlowRates();
+        UpdateCurrentValues();
+      }
+
+      void BoundaryValues::UpdateCurrentValues()
+      {
+        // Only the iolets with sites on this proc are streamed to, and only they have their
+        // values sent here.
+        currentDensities.resize(totalIoletCount);
+        for (int i = 0; i < localIoletCount; i++)
+        {
+          const int boundaryId = localIoletIDs[i];
+          currentDensities[boundaryId] = GetBoundaryDensity(boundaryId);
+          if (velocityIolets[boundaryId] != NULL)
+          {
+            velocityIolets[boundaryId]->UpdateToTimeStep(state->GetTimeStep());
           }
         }
       }
 
       void BoundaryValues::Reset()
       {
+        // Reset every iolet, not just those with sites on this proc, so that all procs agree on
+        // their parameters (e.g. their minimum densities, read from their files).
+        for (int i = 0; i < totalIoletCount; i++)
+        {
+          iolets[i]->Reset(*state);
+        }
+
         for (int i = 0; i < localIoletCount; i++)
         {
-          GetLocalIolet(i)->Reset(*state);
           if (GetLocalIolet(i)->IsCommsRequired())
           {
-            GetLocalIolet(i)->GetComms()->WaitAllComms();
-
+            GetLocalIolet(i)->GetComms()->Wait();
           }
         }
       }
 
+      void BoundaryValues::SaveToCheckpoint(std::vector<distribn_t>& state)
+      {
+        // The Windkessel iolets' state includes the flow rates from the step just finished.
+        ApplyFlowRates();
+
+        for (int i = 0; i < totalIoletCount; i++)
+        {
+          iolets[i]->SaveToCheckpoint(state);
+        }
+      }
+
+      void BoundaryValues::RestoreFromCheckpoint(std::vector<distribn_t>::const_iterator& state)
+      {
+        for (int i = 0; i < totalIoletCount; i++)
+        {
+          iolets[i]->RestoreFromCheckpoint(state);
+        }
+      }
+
       // This assumes the program has already waited for comms to finish before
       LatticeDensity BoundaryValues::GetBoundaryDensity(const int index)
       {
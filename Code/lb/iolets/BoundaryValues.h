@@ -13,6 +13,8 @@
 #include "net/IOCommunicator.h"
 #include "net/IteratedAction.h"
 #include "lb/iolets/InOutLet.h"
+#include "lb/iolets/InOutLetVelocity.h"
+#include "lb/iolets/InOutLetWindkessel.h"
 #include "geometry/LatticeData.h"
 #include "lb/iolets/BoundaryCommunicator.h"
 
@@ -20,6 +22,8 @@ namespace hemelb
 {
   namespace lb
   {
+    class MacroscopicPropertyCache;
+
     namespace iolets
     {
 
@@ -34,18 +38,109 @@ namespace hemelb
                          const util::UnitConverter& units);
           ~BoundaryValues();
 
+          /**
+           * Start sending the values of the iolets that need it from the BC proc. The
+           * receivers only wait for them in FinishReceive.
+           */
           void RequestComms();
+
+          /**
+           * Start adding up the flow rates out through the Windkessel iolets over all procs,
+           * from the site velocities this time step. They are passed to the iolets in the next
+           * FinishReceive.
+           */
           void EndIteration();
           void Reset();
 
+          /**
+           * Append the state of all the iolets to a checkpoint.
+           * @param state
+           */
+          void SaveToCheckpoint(std::vector<distribn_t>& state);
+
+          /**
+           * Restore the state of all the iolets from a checkpoint, advancing the iterator past it.
+           * @param state
+           */
+          void RestoreFromCheckpoint(std::vector<distribn_t>::const_iterator& state);
+
+          /**
+           * Wait for the iolets' communications, then fill in their values for the current time
+           * step, ready for the streamers and collisions.
+           */
           void FinishReceive();
 
           LatticeDensity GetBoundaryDensity(const int index);
 
+          /**
+           * Set where to find the site velocities, needed for the flow rates through the
+           * Windkessel iolets.
+           * @param cache
+           */
+          void SetPropertyCache(const MacroscopicPropertyCache& cache)
+          {
+            propertyCache = &cache;
+          }
+
+          /**
+           * Whether the site velocities are needed every time step.
+           * @return true if there are any Windkessel iolets.
+           */
+          bool IsFlowRateRequired() const
+          {
+            return !windkessels.empty();
+          }
+
+          /**
+           * Get the density of an iolet as at the last FinishReceive (or construction). This is
+           * read from a flat array, with no virtual call, so it is cheap enough to use per link.
+           * @param boundaryId
+           * @return
+           */
+          LatticeDensity GetCurrentDensity(const int boundaryId) const
+          {
+            return currentDensities[boundaryId];
+          }
+
+          /**
+           * Get the normal of an iolet, from a flat array of all their normals.
+           * @param boundaryId
+           * @return
+           */
+          const util::Vector3D<Dimensionless>& GetIoletNormal(const int boundaryId) const
+          {
+            return ioletNormals[boundaryId];
+          }
+
+          /**
+           * Get an iolet as a velocity iolet, without a dynamic_cast per link.
+           * @param boundaryId
+           * @return the iolet, or NULL if it isn't a velocity iolet
+           */
+          iolets::InOutLetVelocity* GetVelocityIolet(const int boundaryId) const
+          {
+            return velocityIolets[boundaryId];
+          }
+
           LatticeDensity GetDensityMin(int boundaryId);
           LatticeDensity GetDensityMax(int boundaryId);
 
           static proc_t GetBCProcRank();
+          /**
+           * Get an iolet by its id, whether or not it has sites on this proc.
+           * @param boundaryId
+           * @return
+           */
+          iolets::InOutLet* GetIolet(const int boundaryId) const
+          {
+            return iolets[boundaryId];
+          }
+          /**
+           * Get one of the iolets this proc takes part in the communication for: those with sites
+           * on this proc, or all of them on the BC proc.
+           * @param index
+           * @return
+           */
           iolets::InOutLet* GetLocalIolet(unsigned int index)
           {
             return iolets[localIoletIDs[index]];
@@ -65,8 +160,37 @@ namespace hemelb
 
         private:
           bool IsIOletOnThisProc(geometry::SiteType ioletType, geometry::LatticeData* latticeData, int boundaryId);
+          /**
+           * Find the local sites on an iolet.
+           * @param latticeData
+           * @param boundaryId
+           * @return Their indices.
+           */
+          std::vector<site_t> GetLocalSitesOnIolet(geometry::LatticeData* latticeData, int boundaryId) const;
+          /**
+           * Wait for the flow rates through the Windkessel iolets, if they are being added up,
+           * and advance the iolets with them.
+           */
+          void ApplyFlowRates();
+          /**
+           * Find the procs with sites on an iolet. Collective on all procs.
+           * @param hasBoundary Whether this proc has sites on the iolet.
+           * @return The ranks of the procs with sites on the iolet.
+           */
           std::vector<int> GatherProcList(bool hasBoundary);
+          /**
+           * Make the communicator for an iolet's broadcasts, of the BC proc (as rank 0) and
+           * the procs with sites on the iolet. Collective on all procs.
+           * @param procsList The procs with sites on the iolet, from GatherProcList.
+           * @return The communicator, or a null one on procs not in it.
+           */
+          net::MpiCommunicator CreateIoletCommunicator(const std::vector<int>& procsList);
           void HandleComms(iolets::InOutLet* iolet);
+          /**
+           * Fill in the density of each iolet, and bring the velocity iolets up to date, for the
+           * current time step.
+           */
+          void UpdateCurrentValues();
           geometry::SiteType ioletType;
           int totalIoletCount;
           // Number of IOlets and vector of their indices for communication purposes
@@ -74,10 +198,29 @@ namespace hemelb
           std::vector<int> localIoletIDs;
           // Has to be a vector of pointers for InOutLet polymorphism
           std::vector<iolets::InOutLet*> iolets;
+          //! The density of each iolet at the current time step.
+          std::vector<LatticeDensity> currentDensities;
+          //! The normal of each iolet.
+          std::vector<util::Vector3D<Dimensionless> > ioletNormals;
+          //! Each iolet if it is a velocity iolet, otherwise NULL.
+          std::vector<iolets::InOutLetVelocity*> velocityIolets;
 
           SimulationState* state;
           const util::UnitConverter& unitConverter;
           BoundaryCommunicator bcComms;
+
+          //! The Windkessel iolets, which need the flow rate through them.
+          std::vector<iolets::InOutLetWindkessel*> windkessels;
+          //! The local sites on each Windkessel iolet.
+          std::vector<std::vector<site_t> > windkesselSites;
+          //! The flow rate out through each Windkessel iolet over this proc's sites.
+          std::vector<LatticeFlowRate> localFlowRates;
+          //! The flow rate out through each Windkessel iolet over all procs.
+          std::vector<LatticeFlowRate> flowRates;
+          //! The reduction of the flow rates in progress, or MPI_REQUEST_NULL.
+          MPI_Request flowRateRequest;
+          //! Where to find the site velocities.
+          const MacroscopicPropertyCache* propertyCache;
       }
       ;
     }
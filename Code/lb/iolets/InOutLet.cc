@@ -1,4 +1,5 @@
 #include "lb/iolets/InOutLet.h"
+#include "lb/iolets/BoundaryComms.h"
 
 namespace hemelb
 {
@@ -11,6 +12,14 @@ namespace hemelb
         // pass
       }
 
+      void InOutLet::FinishComms()
+      {
+        if (comms)
+        {
+          comms->Wait();
+        }
+      }
+
       namespace
       {
         unsigned SmallestMagnitudeComponent(const LatticeVector r)
@@ -106,6 +106,12 @@ namespace hemelb
            */
           virtual void DoComms(const BoundaryCommunicator& bcComms, const LatticeTimeStep timeStep);
 
+          /***
+           * Wait for the communication started by DoComms to complete, ready for the iolet's
+           * values to be used.
+           */
+          virtual void FinishComms();
+
           /***
            * Set up the Iolet.
            * @param units a UnitConverter instance.
@@ -150,6 +156,23 @@ namespace hemelb
           /// @todo: #632 Is this method ever implemented not empty?
           virtual void Reset(SimulationState& state) = 0;
 
+          /**
+           * Append any state that the iolet carries from one time step to the next to a
+           * checkpoint. Iolets whose boundary values depend only on the time have none.
+           * @param state
+           */
+          virtual void SaveToCheckpoint(std::vector<distribn_t>& state) const
+          {
+          }
+
+          /**
+           * Restore the state appended by SaveToCheckpoint, advancing the iterator past it.
+           * @param state
+           */
+          virtual void RestoreFromCheckpoint(std::vector<distribn_t>::const_iterator& state)
+          {
+          }
+
           const LatticePosition& GetPosition() const
           {
             return position;
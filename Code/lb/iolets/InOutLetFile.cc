@@ -24,7 +24,7 @@ namespace hemelb
     namespace iolets
     {
       InOutLetFile::InOutLetFile() :
-        InOutLet(), densityTable(0), units(NULL)
+        InOutLet(), totalTimeSteps(0), units(NULL)
       {
 
       }
@@ -48,8 +48,10 @@ namespace hemelb
       // IMPORTANT: to allow reading in data taken at irregular intervals the user
       // needs to make sure that the last point in the file coincides with the first
       // point of a new cycle for a continuous trace.
-      void InOutLetFile::CalculateTable(LatticeTimeStep totalTimeSteps)
+      void InOutLetFile::ReadTrace(LatticeTimeStep totalTimeSteps)
       {
+        this->totalTimeSteps = totalTimeSteps;
+
         // First read in values from file
         // Used to be complex code here to keep a vector unique, but this is just achieved by using a map.
         std::map < PhysicalTime, PhysicalPressure > timeValuePairs;
@@ -69,10 +71,10 @@ namespace hemelb
         datafile.close();
         // the default iterator for maps traverses in key order, so no sort is needed.
 
-        std::vector<double> times(0);
-        std::vector<double> values(0);
+        times.clear();
+        pressures.clear();
 
-        // Must convert into vectors since LinearInterpolate works on a pair of vectors
+        // Must convert into vectors since LinearInterpolateSorted works on a pair of vectors
         // Determine min and max pressure on the way
         PhysicalPressure pMin = timeValuePairs.begin()->second;
         PhysicalPressure pMax = timeValuePairs.begin()->second;
@@ -82,27 +84,26 @@ namespace hemelb
           pMin = util::NumericalFunctions::min(pMin, entry->second);
           pMax = util::NumericalFunctions::max(pMax, entry->second);
           times.push_back(entry->first);
-          values.push_back(entry->second);
+          pressures.push_back(entry->second);
         }
         densityMin = units->ConvertPressureToLatticeUnits(pMin) / Cs2;
         densityMax = units->ConvertPressureToLatticeUnits(pMax) / Cs2;
 
         // Check if last point's value matches the first
-        if (values.back() != values.front())
+        if (pressures.back() != pressures.front())
           throw Exception() << "Last point's value does not match the first point's value in " <<pressureFilePath;
+      }
 
-        // extend the table to one past the total time steps, so that the table is valid in the end-state, where the zero indexed time step is equal to the limit.
-        densityTable.resize(totalTimeSteps + 1);
-        // Now convert these vectors into arrays using linear interpolation
-        for (unsigned int timeStep = 0; timeStep <= totalTimeSteps; timeStep++)
-        {
-          double point = times.front() + (static_cast<double> (timeStep)
-              / static_cast<double> (totalTimeSteps)) * (times.back() - times.front());
+      LatticeDensity InOutLetFile::GetDensity(LatticeTimeStep timeStep) const
+      {
+        // This is valid up to and including the end-state, where the zero indexed time step is
+        // equal to the limit.
+        double point = times.front() + (static_cast<double> (timeStep)
+            / static_cast<double> (totalTimeSteps)) * (times.back() - times.front());
 
-          double pressure = util::NumericalFunctions::LinearInterpolate(times, values, point);
+        double pressure = util::NumericalFunctions::LinearInterpolateSorted(times, pressures, point);
 
-          densityTable[timeStep] = units->ConvertPressureToLatticeUnits(pressure) / Cs2;
-        }
+        return units->ConvertPressureToLatticeUnits(pressure) / Cs2;
       }
 
     }
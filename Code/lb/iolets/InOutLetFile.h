@@ -36,7 +36,7 @@ namespace hemelb
           virtual InOutLet* Clone() const;
           virtual void Reset(SimulationState &state)
           {
-            CalculateTable(state.GetTotalTimeSteps());
+            ReadTrace(state.GetTotalTimeSteps());
           }
 
           const std::string& GetFilePath()
@@ -56,14 +56,23 @@ namespace hemelb
           {
             return densityMax;
           }
-          LatticeDensity GetDensity(LatticeTimeStep timeStep) const
-          {
-            return densityTable[timeStep];
-          }
+          /**
+           * Interpolate the trace at the given time step. The trace is stretched over the whole
+           * run, so only the points from the file are kept and the density is worked out on
+           * demand, keeping the memory used independent of the length of the run.
+           * @param timeStep
+           * @return
+           */
+          LatticeDensity GetDensity(LatticeTimeStep timeStep) const;
           virtual void Initialise(const util::UnitConverter* unitConverter);
         private:
-          void CalculateTable(LatticeTimeStep totalTimeSteps);
-          std::vector<LatticeDensity> densityTable;
+          void ReadTrace(LatticeTimeStep totalTimeSteps);
+          //! The times of the points in the file, in order.
+          std::vector<PhysicalTime> times;
+          //! The pressure at each point in the file.
+          std::vector<PhysicalPressure> pressures;
+          //! The number of time steps the trace is stretched over.
+          LatticeTimeStep totalTimeSteps;
           LatticeDensity densityMin;
           LatticeDensity densityMax;
           std::string pressureFilePath;
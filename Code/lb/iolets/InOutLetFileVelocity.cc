@@ -10,6 +10,7 @@
 #include "lb/iolets/InOutLetFileVelocity.h"
 #include <algorithm>
 #include <fstream>
+#include <limits>
 #include "log/Logger.h"
 #include "util/fileutils.h"
 #include "util/utilityFunctions.h"
@@ -23,7 +24,8 @@ namespace hemelb
     namespace iolets
     {
       InOutLetFileVelocity::InOutLetFileVelocity() :
-          units(NULL)
+          totalTimeSteps(0), units(NULL), maxSpeed(0.0),
+              maxSpeedTimeStep(std::numeric_limits<LatticeTimeStep>::max())
       {
       }
 
@@ -33,8 +35,10 @@ namespace hemelb
         return copy;
       }
 
-      void InOutLetFileVelocity::CalculateTable(LatticeTimeStep totalTimeSteps)
+      void InOutLetFileVelocity::ReadTrace(LatticeTimeStep totalTimeSteps)
       {
+        this->totalTimeSteps = totalTimeSteps;
+
         // First read in values from file
         // Used to be complex code here to keep a vector unique, but this is just achieved by using a map.
         std::map<PhysicalTime, PhysicalSpeed> timeValuePairs;
@@ -54,10 +58,10 @@ namespace hemelb
         datafile.close();
         // the default iterator for maps traverses in key order, so no sort is needed.
 
-        std::vector<PhysicalTime> times(0);
-        std::vector<PhysicalSpeed> values(0);
+        times.clear();
+        speeds.clear();
 
-        // Must convert into vectors since LinearInterpolate works on a pair of vectors
+        // Must convert into vectors since LinearInterpolateSorted works on a pair of vectors
         // Determine min and max pressure on the way
 //        PhysicalPressure pMin = timeValuePairs.begin()->second;
 //        PhysicalPressure pMax = timeValuePairs.begin()->second;
@@ -67,30 +71,15 @@ namespace hemelb
 //          pMin = util::NumericalFunctions::min(pMin, entry->second);
 //          pMax = util::NumericalFunctions::max(pMax, entry->second);
           times.push_back(entry->first);
-          values.push_back(entry->second);
+          speeds.push_back(entry->second);
         }
 //        densityMin = units->ConvertPressureToLatticeUnits(pMin) / Cs2;
 //        densityMax = units->ConvertPressureToLatticeUnits(pMax) / Cs2;
 
         // Check if last point's value matches the first
-        if (values.back() != values.front())
+        if (speeds.back() != speeds.front())
           throw Exception() << "Last point's value does not match the first point's value in "
               << velocityFilePath;
-
-        // extend the table to one past the total time steps, so that the table is valid in the end-state, where the zero indexed time step is equal to the limit.
-        velocityTable.resize(totalTimeSteps + 1);
-        // Now convert these vectors into arrays using linear interpolation
-        for (unsigned int timeStep = 0; timeStep <= totalTimeSteps; timeStep++)
-        {
-          double point = times.front()
-              + (static_cast<double>(timeStep) / static_cast<double>(totalTimeSteps))
-                  * (times.back() - times.front());
-
-          PhysicalSpeed vel = util::NumericalFunctions::LinearInterpolate(times, values, point);
-
-          velocityTable[timeStep] = units->ConvertVelocityToLatticeUnits(vel);
-        }
-
       }
 
       LatticeVelocity InOutLetFileVelocity::GetVelocity(const LatticePosition& x,
@@ -103,13 +92,33 @@ namespace hemelb
         Dimensionless rSqOverASq = (displ.GetMagnitudeSquared() - z * z) / (radius * radius);
         assert(rSqOverASq <= 1.0);
 
-        // Get the max velocity
-        LatticeSpeed max = velocityTable[t];
+        // Get the max velocity, which is normally already worked out for this time step.
+        LatticeSpeed max = t == maxSpeedTimeStep
+          ? maxSpeed
+          : GetMaxSpeed(t);
 
         // Brackets to ensure that the scalar multiplies are done before vector * scalar.
         return normal * (max * (1. - rSqOverASq));
       }
 
+      void InOutLetFileVelocity::UpdateToTimeStep(const LatticeTimeStep t)
+      {
+        maxSpeed = GetMaxSpeed(t);
+        maxSpeedTimeStep = t;
+      }
+
+      LatticeSpeed InOutLetFileVelocity::GetMaxSpeed(const LatticeTimeStep t) const
+      {
+        // Interpolate the trace (stretched over the whole run) at this time step. This is valid
+        // up to and including the end-state, where the zero indexed time step is equal to the
+        // limit.
+        double point = times.front()
+            + (static_cast<double>(t) / static_cast<double>(totalTimeSteps))
+                * (times.back() - times.front());
+        PhysicalSpeed vel = util::NumericalFunctions::LinearInterpolateSorted(times, speeds, point);
+        return units->ConvertVelocityToLatticeUnits(vel);
+      }
+
       void InOutLetFileVelocity::Initialise(const util::UnitConverter* unitConverter)
       {
         units = unitConverter;
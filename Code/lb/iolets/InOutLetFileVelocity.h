@@ -27,7 +27,8 @@ namespace hemelb
           InOutLet* Clone() const;
           void Reset(SimulationState &state)
           {
-            CalculateTable(state.GetTotalTimeSteps());
+            ReadTrace(state.GetTotalTimeSteps());
+            UpdateToTimeStep(state.GetTimeStep());
           }
 
           const std::string& GetFilePath()
@@ -41,13 +42,29 @@ namespace hemelb
 
           LatticeVelocity GetVelocity(const LatticePosition& x, const LatticeTimeStep t) const;
 
+          /**
+           * Interpolate the maximum speed for the time step, for GetVelocity to use.
+           * @param t
+           */
+          void UpdateToTimeStep(const LatticeTimeStep t);
+
           void Initialise(const util::UnitConverter* unitConverter);
 
         private:
           std::string velocityFilePath;
-          void CalculateTable(LatticeTimeStep totalTimeSteps);
-          std::vector<LatticeSpeed> velocityTable;
+          void ReadTrace(LatticeTimeStep totalTimeSteps);
+          LatticeSpeed GetMaxSpeed(const LatticeTimeStep t) const;
+          //! The times of the points in the file, in order.
+          std::vector<PhysicalTime> times;
+          //! The maximum speed at each point in the file.
+          std::vector<PhysicalSpeed> speeds;
+          //! The number of time steps the trace is stretched over.
+          LatticeTimeStep totalTimeSteps;
           const util::UnitConverter* units;
+          //! The maximum speed at maxSpeedTimeStep, in lattice units.
+          LatticeSpeed maxSpeed;
+          //! The time step maxSpeed is for.
+          LatticeTimeStep maxSpeedTimeStep;
 
       };
 
@@ -128,43 +128,28 @@ namespace hemelb
                                                                               isIoProc
                                                                                 ? "true"
                                                                                 : "false");
-        double pressure_array[3];
         //TODO: Change these operators on SharedValue.
-        pressure_array[0] = pressure.GetPayload();
-        pressure_array[1] = minPressure.GetPayload();
-        pressure_array[2] = maxPressure.GetPayload();
+        pressureBuffer[0] = pressure.GetPayload();
+        pressureBuffer[1] = minPressure.GetPayload();
+        pressureBuffer[2] = maxPressure.GetPayload();
 
-        net::Net commsNet(bcComms);
-
-        const std::vector<int>& procList = comms->GetListOfProcs(); //TODO: CHECK + IMPROVE!
-
-        // If this proc is to do IO, send the pressure array list to all cores that require it.
-        if (isIoProc && procList[0] != bcComms.GetBCProcRank())
-        {
-          for (std::vector<int>::const_iterator it = procList.begin(); it != procList.end(); it++)
-          {
-            commsNet.RequestSend(pressure_array, 3, *it);
-          }
-        }
-        // Otherwise, receive the pressure array list from the core.
-        else if (procList[0] != bcComms.GetBCProcRank())
-        {
-          commsNet.RequestReceive(pressure_array, 3, bcComms.GetBCProcRank());
-        }
+        // Start sending the pressures from the BC proc to all the cores with the iolet. They
+        // are unpacked once they have arrived, in FinishComms.
+        comms->Broadcast(pressureBuffer, 3);
+      }
 
-        // Perform the send / receive.
-        commsNet.Dispatch();
+      void InOutLetMultiscale::FinishComms()
+      {
+        InOutLet::FinishComms();
 
-        if (!isIoProc)
-        {
-          pressure.SetPayload(static_cast<PhysicalPressure> (pressure_array[0]));
-          minPressure.SetPayload(static_cast<PhysicalPressure> (pressure_array[1]));
-          maxPressure.SetPayload(static_cast<PhysicalPressure> (pressure_array[2]));
-          hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("Received: %f %f %f",
-                                                                                pressure.GetPayload(),
-                                                                                minPressure.GetPayload(),
-                                                                                maxPressure.GetPayload());
-        }
+        // The broadcast leaves the BC proc's values as they were, so it can unpack them too.
+        pressure.SetPayload(static_cast<PhysicalPressure> (pressureBuffer[0]));
+        minPressure.SetPayload(static_cast<PhysicalPressure> (pressureBuffer[1]));
+        maxPressure.SetPayload(static_cast<PhysicalPressure> (pressureBuffer[2]));
+        hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("Received: %f %f %f",
+                                                                              pressure.GetPayload(),
+                                                                              minPressure.GetPayload(),
+                                                                              maxPressure.GetPayload());
       }
     }
   }
@@ -90,6 +90,7 @@ namespace hemelb
           virtual bool IsCommsRequired() const;
           virtual void SetCommsRequired(bool b);
           void DoComms(const BoundaryCommunicator& bcComms, const LatticeTimeStep timeStep);
+          void FinishComms();
 
         private:
           std::string label;
@@ -100,6 +101,8 @@ namespace hemelb
           multiscale::SharedValue<PhysicalPressure> minPressure;
           multiscale::SharedValue<PhysicalPressure> maxPressure;
           mutable multiscale::SharedValue<PhysicalVelocity> velocity;
+          //! The pressure, min and max pressure being broadcast, from DoComms until FinishComms.
+          double pressureBuffer[3];
       };
     }
   }
@@ -46,6 +46,15 @@ namespace hemelb
 
           virtual LatticeVelocity GetVelocity(const LatticePosition& x, const LatticeTimeStep t) const = 0;
 
+          /**
+           * Work out anything GetVelocity needs at the given time step that doesn't depend on
+           * position, so that it isn't redone per link. Called once per step, before streaming.
+           * @param t
+           */
+          virtual void UpdateToTimeStep(const LatticeTimeStep t)
+          {
+          }
+
         protected:
           LatticeDistance radius;
       };
@@ -0,0 +1,84 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+
+#include "lb/iolets/InOutLetWindkessel.h"
+#include "util/utilityFunctions.h"
+
+namespace hemelb
+{
+  namespace lb
+  {
+    namespace iolets
+    {
+
+      InOutLetWindkessel::InOutLetWindkessel() :
+        InOutLet(), proximalResistance(0.0), distalResistance(1.0), compliance(1.0),
+            distalPressure(Cs2), capacitorPressure(Cs2), flowRate(0.0), pressureMin(Cs2),
+            pressureMax(Cs2)
+      {
+
+      }
+
+      InOutLet* InOutLetWindkessel::Clone() const
+      {
+        InOutLetWindkessel* copy = new InOutLetWindkessel(*this);
+
+        return copy;
+      }
+
+      InOutLetWindkessel::~InOutLetWindkessel()
+      {
+
+      }
+
+      LatticeDensity InOutLetWindkessel::GetDensity(LatticeTimeStep timeStep) const
+      {
+        return GetPressure() / Cs2;
+      }
+
+      void InOutLetWindkessel::SetDistalPressure(const LatticePressure& pressure)
+      {
+        distalPressure = pressure;
+        capacitorPressure = pressure;
+        flowRate = 0.0;
+        pressureMin = pressure;
+        pressureMax = pressure;
+      }
+
+      void InOutLetWindkessel::UpdateFlowRate(LatticeFlowRate outwardFlowRate)
+      {
+        // C dp/dt = Q - (p - p_distal) / R_distal, by backward Euler over one time step.
+        flowRate = outwardFlowRate;
+        capacitorPressure = (compliance * capacitorPressure + flowRate + distalPressure / distalResistance)
+            / (compliance + 1.0 / distalResistance);
+
+        pressureMin = util::NumericalFunctions::min(pressureMin, GetPressure());
+        pressureMax = util::NumericalFunctions::max(pressureMax, GetPressure());
+      }
+
+      void InOutLetWindkessel::SaveToCheckpoint(std::vector<distribn_t>& state) const
+      {
+        state.push_back(capacitorPressure);
+        state.push_back(flowRate);
+        state.push_back(pressureMin);
+        state.push_back(pressureMax);
+      }
+
+      void InOutLetWindkessel::RestoreFromCheckpoint(std::vector<distribn_t>::const_iterator& state)
+      {
+        capacitorPressure = *state++;
+        flowRate = *state++;
+        pressureMin = *state++;
+        pressureMax = *state++;
+      }
+
+    }
+  }
+}
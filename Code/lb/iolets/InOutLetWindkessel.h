@@ -0,0 +1,151 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+
+#ifndef HEMELB_LB_IOLETS_INOUTLETWINDKESSEL_H
+#define HEMELB_LB_IOLETS_INOUTLETWINDKESSEL_H
+
+#include "lb/iolets/InOutLet.h"
+
+namespace hemelb
+{
+  namespace lb
+  {
+    namespace iolets
+    {
+
+      /**
+       * A pressure iolet whose pressure is given by a three element (RCR) Windkessel model of the
+       * vessels beyond it: a proximal resistance in series with a compliance, which drains
+       * through a distal resistance to the distal pressure. The model is driven by the flow rate
+       * out of the domain through the iolet, which BoundaryValues measures every time step and
+       * passes to UpdateFlowRate. Everything is kept in lattice units.
+       *
+       * Unlike the other iolets the pressure depends on the history of the flow, so the state is
+       * saved in checkpoints.
+       */
+      class InOutLetWindkessel : public InOutLet
+      {
+        public:
+          InOutLetWindkessel();
+          virtual ~InOutLetWindkessel();
+          virtual InOutLet* Clone() const;
+          virtual void Reset(SimulationState &state)
+          {
+            //pass;
+          }
+
+          /**
+           * The density for the model's current pressure. The time step is ignored: the model
+           * is advanced by UpdateFlowRate.
+           * @param timeStep
+           * @return
+           */
+          LatticeDensity GetDensity(LatticeTimeStep timeStep) const;
+
+          /**
+           * The lowest density the model has given so far.
+           * @return
+           */
+          LatticeDensity GetDensityMin() const
+          {
+            return pressureMin / Cs2;
+          }
+          /**
+           * The highest density the model has given so far.
+           * @return
+           */
+          LatticeDensity GetDensityMax() const
+          {
+            return pressureMax / Cs2;
+          }
+
+          /**
+           * The pressure at the iolet, across the proximal resistance from the compliance.
+           * @return
+           */
+          LatticePressure GetPressure() const
+          {
+            return capacitorPressure + proximalResistance * flowRate;
+          }
+
+          const LatticeResistance& GetProximalResistance() const
+          {
+            return proximalResistance;
+          }
+          void SetProximalResistance(const LatticeResistance& resistance)
+          {
+            proximalResistance = resistance;
+          }
+
+          const LatticeResistance& GetDistalResistance() const
+          {
+            return distalResistance;
+          }
+          void SetDistalResistance(const LatticeResistance& resistance)
+          {
+            distalResistance = resistance;
+          }
+
+          const LatticeCompliance& GetCompliance() const
+          {
+            return compliance;
+          }
+          void SetCompliance(const LatticeCompliance& aCompliance)
+          {
+            compliance = aCompliance;
+          }
+
+          const LatticePressure& GetDistalPressure() const
+          {
+            return distalPressure;
+          }
+          /**
+           * Set the pressure the distal resistance drains to. The model starts at rest, with
+           * the compliance at this pressure and no flow.
+           * @param pressure
+           */
+          void SetDistalPressure(const LatticePressure& pressure);
+
+          const LatticeFlowRate& GetFlowRate() const
+          {
+            return flowRate;
+          }
+
+          /**
+           * Advance the model by one time step, given the flow rate out of the domain through
+           * the iolet. The compliance is updated implicitly, so this is stable for any time
+           * constant.
+           * @param outwardFlowRate
+           */
+          void UpdateFlowRate(LatticeFlowRate outwardFlowRate);
+
+          virtual void SaveToCheckpoint(std::vector<distribn_t>& state) const;
+          virtual void RestoreFromCheckpoint(std::vector<distribn_t>::const_iterator& state);
+
+        private:
+          LatticeResistance proximalResistance;
+          LatticeResistance distalResistance;
+          LatticeCompliance compliance;
+          LatticePressure distalPressure;
+
+          //! The pressure across the compliance.
+          LatticePressure capacitorPressure;
+          //! The flow rate out through the iolet at the last update.
+          LatticeFlowRate flowRate;
+          //! The range of pressures given so far.
+          LatticePressure pressureMin;
+          LatticePressure pressureMax;
+      };
+
+    }
+  }
+}
+
+#endif /* HEMELB_LB_IOLETS_INOUTLETWINDKESSEL_H */
@@ -1,6 +1,8 @@
 #include "lb/iolets/InOutLetWomersleyVelocity.h"
 #include "configuration/SimConfig.h"
 #include "util/Bessel.h"
+#include <algorithm>
+#include <cmath>
 
 namespace hemelb
 {
@@ -18,6 +20,44 @@ namespace hemelb
         return copy;
       }
 
+      void InOutLetWomersleyVelocity::Initialise(const util::UnitConverter* unitConverter)
+      {
+        CalculateProfileTable();
+      }
+
+      void InOutLetWomersleyVelocity::CalculateProfileTable()
+      {
+        profileDenominator = util::BesselJ0ComplexArgument(iPowThreeHalves * womersleyNumber);
+
+        const unsigned intervals = ProfileTableResolution
+            * std::max(1u, (unsigned) std::ceil(womersleyNumber));
+        profileTable.resize(intervals + 1);
+        for (unsigned point = 0; point <= intervals; ++point)
+        {
+          profileTable[point] = CalculateProfile(double(point) / intervals);
+        }
+      }
+
+      InOutLetWomersleyVelocity::Complex InOutLetWomersleyVelocity::CalculateProfile(Dimensionless rOverR) const
+      {
+        Complex besselNumer = util::BesselJ0ComplexArgument(iPowThreeHalves * womersleyNumber * rOverR);
+        return 1.0 - besselNumer / profileDenominator;
+      }
+
+      InOutLetWomersleyVelocity::Complex InOutLetWomersleyVelocity::GetProfile(Dimensionless rOverR) const
+      {
+        // Outside the iolet (or before Initialise) there's no table to use.
+        if (profileTable.empty() || rOverR >= 1.0)
+        {
+          return CalculateProfile(rOverR);
+        }
+
+        const double tablePosition = rOverR * (profileTable.size() - 1);
+        const unsigned below = (unsigned) tablePosition;
+        const double fraction = tablePosition - below;
+        return profileTable[below] + fraction * (profileTable[below + 1] - profileTable[below]);
+      }
+
       LatticeVelocity InOutLetWomersleyVelocity::GetVelocity(const LatticePosition& x,
                                                              const LatticeTimeStep t) const
       {
@@ -28,11 +68,9 @@ namespace hemelb
         double omega = 2.0 * PI / period;
         LatticeDensity density = 1.0;
 
-        Complex besselNumer = util::BesselJ0ComplexArgument(iPowThreeHalves * womersleyNumber * r
-            / radius);
-        Complex besselDenom = util::BesselJ0ComplexArgument(iPowThreeHalves * womersleyNumber);
-        LatticeSpeed velocityMagnitude = std::real(pressureGradientAmplitude / (density * omega)
-            * (1.0 - besselNumer / besselDenom) * exp(i * omega * double(t)));
+        const Complex phase = std::polar(1.0, omega * double(t));
+        LatticeSpeed velocityMagnitude = pressureGradientAmplitude / (density * omega)
+            * std::real(GetProfile(r / radius) * phase);
 
         return normal * -velocityMagnitude;
       }
@@ -65,6 +103,16 @@ namespace hemelb
       void InOutLetWomersleyVelocity::SetWomersleyNumber(const Dimensionless& womNumber)
       {
         womersleyNumber = womNumber;
+        // Keep the table in step if we've already made it, otherwise just the denominator that
+        // CalculateProfile needs.
+        if (!profileTable.empty())
+        {
+          CalculateProfileTable();
+        }
+        else
+        {
+          profileDenominator = util::BesselJ0ComplexArgument(iPowThreeHalves * womersleyNumber);
+        }
       }
     }
   }
@@ -11,6 +11,7 @@
 #define HEMELB_LB_IOLETS_INOUTLETWOMERSLEYVELOCITY_H
 #include "lb/iolets/InOutLetVelocity.h"
 #include <complex>
+#include <vector>
 
 namespace hemelb
 {
@@ -31,6 +32,10 @@ namespace hemelb
        *
        * If combined with a pressure iolet at the other end of the cylinder, it must be set to
        * zero pressure
+       *
+       * The radial part of the profile, which needs two complex Bessel functions, only depends on
+       * the Womersley number and r/R, so Initialise tabulates it once. Each call to GetVelocity
+       * then interpolates the table and multiplies by the phase for the time step.
        */
       class InOutLetWomersleyVelocity : public InOutLetVelocity
       {
@@ -43,6 +48,12 @@ namespace hemelb
            */
           InOutLet* Clone() const;
 
+          /**
+           * Tabulate the radial profile.
+           * @param unitConverter
+           */
+          void Initialise(const util::UnitConverter* unitConverter);
+
           /**
            * Get Womersley velocity for a given time and position.
            *
@@ -98,9 +109,34 @@ namespace hemelb
           typedef std::complex<double> Complex;
           static const Complex i;
           static const Complex iPowThreeHalves;
+          //! The number of intervals in the profile table for each unit of the Womersley number
+          //! (and at least this many), enough to resolve the boundary layer by interpolation.
+          static const unsigned ProfileTableResolution = 1024;
+
+          /**
+           * Fill in the profile table, and its denominator, for the current Womersley number.
+           */
+          void CalculateProfileTable();
+
+          /**
+           * Get the radial part of the profile, 1 - J0(i^(3/2) alpha r / R) / J0(i^(3/2) alpha).
+           * @param rOverR the distance from the axis as a fraction of the radius
+           * @return
+           */
+          Complex GetProfile(Dimensionless rOverR) const;
+
+          /**
+           * Evaluate the radial part of the profile directly from the Bessel functions.
+           * @param rOverR the distance from the axis as a fraction of the radius
+           * @return
+           */
+          Complex CalculateProfile(Dimensionless rOverR) const;
+
           LatticePressureGradient pressureGradientAmplitude; ///< See class documentation
           LatticeTime period; ///< See class documentation
           double womersleyNumber; ///< See class documentation
+          std::vector<Complex> profileTable; ///< The radial profile at evenly spaced r/R from 0 to 1, or empty before Initialise
+          Complex profileDenominator; ///< J0(i^(3/2) alpha), which doesn't depend on position
       };
     }
   }
@@ -17,5 +17,6 @@
 #include "lb/iolets/InOutLetParabolicVelocity.h"
 #include "lb/iolets/InOutLetWomersleyVelocity.h"
 #include "lb/iolets/InOutLetFileVelocity.h"
+#include "lb/iolets/InOutLetWindkessel.h"
 
 #endif /* HEMELB_LB_IOLETS_INOUTLETS_H */
@@ -110,7 +110,7 @@ namespace hemelb
             fPostCollision[direction] = value;
           }
 
-          inline const FVector<LatticeType>& GetFPostCollision()
+          inline const FVector<LatticeType>& GetFPostCollision() const
           {
             return fPostCollision;
           }
@@ -130,6 +130,71 @@ namespace hemelb
           }
       };
 
+      /**
+       * The number of sites collided together by kernels that provide a multi-site
+       * implementation, as set by the CMake HEMELB_SIMD_WIDTH parameter. A width of 1 keeps the
+       * streamers on the site-by-site path.
+       */
+      const unsigned SimdWidth = HEMELB_SIMD_WIDTH;
+
+      /**
+       * MultiSiteHydroVars: the hydrodynamic variables of SimdWidth sites, for kernels that
+       * collide several sites at once. Every array is indexed [direction][site] (or just [site])
+       * so that the kernels can loop over the sites innermost with unit stride, which the
+       * compiler turns into vector instructions.
+       *
+       * The streamers fill f and tau, call the kernel, then copy each site's results into an
+       * ordinary HydroVars with GetSiteHydroVars, so that the link delegates and the property
+       * cache see exactly what the single-site path would give them.
+       */
+      template<class LatticeType>
+      struct MultiSiteHydroVars
+      {
+        public:
+          distribn_t f[LatticeType::NUMVECTORS][SimdWidth];
+          distribn_t density[SimdWidth], tau[SimdWidth];
+          distribn_t momentum_x[SimdWidth], momentum_y[SimdWidth], momentum_z[SimdWidth];
+          distribn_t velocity_x[SimdWidth], velocity_y[SimdWidth], velocity_z[SimdWidth];
+          distribn_t f_eq[LatticeType::NUMVECTORS][SimdWidth];
+          distribn_t f_neq[LatticeType::NUMVECTORS][SimdWidth];
+          distribn_t fPostCollision[LatticeType::NUMVECTORS][SimdWidth];
+
+          /**
+           * Copies the distributions of one site into the given lane.
+           *
+           * @param lane
+           * @param siteF
+           */
+          inline void SetSiteF(unsigned lane, const distribn_t* const siteF)
+          {
+            for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+            {
+              f[direction][lane] = siteF[direction];
+            }
+          }
+
+          /**
+           * Copies the results for the site in the given lane into a single-site HydroVars.
+           *
+           * @param lane
+           * @param hydroVars
+           */
+          inline void GetSiteHydroVars(unsigned lane, HydroVarsBase<LatticeType>& hydroVars) const
+          {
+            hydroVars.density = density[lane];
+            hydroVars.tau = tau[lane];
+            hydroVars.momentum = util::Vector3D<distribn_t>(momentum_x[lane], momentum_y[lane], momentum_z[lane]);
+            hydroVars.velocity = util::Vector3D<distribn_t>(velocity_x[lane], velocity_y[lane], velocity_z[lane]);
+
+            for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+            {
+              hydroVars.SetFEq(direction, f_eq[direction][lane]);
+              hydroVars.SetFNeq(direction, f_neq[direction][lane]);
+              hydroVars.SetFPostCollision(direction, fPostCollision[direction][lane]);
+            }
+          }
+      };
+
       /**
        * InitParams: struct for passing variables into streaming, collision and kernel operators
        * to initialise them.
@@ -193,6 +258,15 @@ namespace hemelb
        *  - DoCalculateDensityMomentumFeq(KHydroVars&, site_t)
        *  - DoCollide(const LbmParameters*, KHydroVars&, unsigned int) returns distibn_t
        *  - DoReset(InitParams*)
+       *
+       * Kernels that can collide SimdWidth sites at once set MultiSite to true and implement
+       *  - DoCalculateDensityMomentumFeqMultiSite(MultiSiteHydroVars&)
+       *  - DoCollideMultiSite(const LbmParameters*, MultiSiteHydroVars&)
+       *
+       * Kernels that carry state from one time step to the next for each site (which must be
+       * checkpointed) implement
+       *  - DoGetSiteState(site_t) returns distribn_t
+       *  - DoSetSiteState(site_t, distribn_t)
        */
       template<typename KernelImpl, typename LatticeImpl>
       class BaseKernel
@@ -200,6 +274,10 @@ namespace hemelb
         public:
           typedef HydroVars<KernelImpl> KHydroVars;
           typedef LatticeImpl LatticeType;
+          typedef MultiSiteHydroVars<LatticeImpl> KMultiSiteHydroVars;
+
+          //! Whether the kernel provides the multi-site functions. Kernels that do hide this.
+          static const bool MultiSite = false;
 
           inline void CalculateDensityMomentumFeq(KHydroVars& hydroVars, site_t index)
           {
@@ -216,6 +294,46 @@ namespace hemelb
             static_cast<KernelImpl*> (this)->DoCollide(lbmParams, hydroVars);
           }
 
+          inline void CalculateDensityMomentumFeqMultiSite(KMultiSiteHydroVars& hydroVars)
+          {
+            static_cast<KernelImpl*> (this)->DoCalculateDensityMomentumFeqMultiSite(hydroVars);
+          }
+
+          inline void CollideMultiSite(const LbmParameters* lbmParams, KMultiSiteHydroVars& hydroVars)
+          {
+            static_cast<KernelImpl*> (this)->DoCollideMultiSite(lbmParams, hydroVars);
+          }
+
+          /**
+           * Get the state the kernel keeps for a site between time steps.
+           * @param index The local contiguous site index.
+           * @return
+           */
+          inline distribn_t GetSiteState(site_t index) const
+          {
+            return static_cast<const KernelImpl*> (this)->DoGetSiteState(index);
+          }
+
+          /**
+           * Set the state the kernel keeps for a site between time steps.
+           * @param index The local contiguous site index.
+           * @param value
+           */
+          inline void SetSiteState(site_t index, distribn_t value)
+          {
+            static_cast<KernelImpl*> (this)->DoSetSiteState(index, value);
+          }
+
+          //! Stateless kernels have nothing to checkpoint. Stateful ones hide these.
+          inline distribn_t DoGetSiteState(site_t index) const
+          {
+            return 0.0;
+          }
+
+          inline void DoSetSiteState(site_t index, distribn_t value)
+          {
+          }
+
       };
 
     }
@@ -55,6 +55,16 @@ namespace hemelb
             }
           }
 
+          inline distribn_t DoGetSiteState(site_t index) const
+          {
+            return oldAlpha[index];
+          }
+
+          inline void DoSetSiteState(site_t index, distribn_t value)
+          {
+            oldAlpha[index] = value;
+          }
+
         protected:
           /**
            * Constructs the alpha array.
@@ -59,6 +59,10 @@ namespace hemelb
           {
           }
 
+          // The alpha cache is the per-site state, not BaseKernel's default.
+          using Entropic<LatticeType>::DoGetSiteState;
+          using Entropic<LatticeType>::DoSetSiteState;
+
           /**
            * Calculates the density and momentum for the given f. Then calculates the
            * equilibrium distribution as described by Ansumali.
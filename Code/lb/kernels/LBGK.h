@@ -28,6 +28,8 @@ namespace hemelb
       class LBGK : public BaseKernel<LBGK<LatticeType>, LatticeType>
       {
         public:
+          static const bool MultiSite = true;
+
           LBGK(InitParams& initParams)
           {
           }
@@ -74,6 +76,42 @@ namespace hemelb
             }
           }
 
+          inline void DoCalculateDensityMomentumFeqMultiSite(MultiSiteHydroVars<LatticeType>& hydroVars)
+          {
+            LatticeType::template CalculateDensityMomentumFEqMultiSite<SimdWidth>(hydroVars.f,
+                                                                                  hydroVars.density,
+                                                                                  hydroVars.momentum_x,
+                                                                                  hydroVars.momentum_y,
+                                                                                  hydroVars.momentum_z,
+                                                                                  hydroVars.velocity_x,
+                                                                                  hydroVars.velocity_y,
+                                                                                  hydroVars.velocity_z,
+                                                                                  hydroVars.f_eq);
+
+            for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ++ii)
+            {
+              for (unsigned lane = 0; lane < SimdWidth; ++lane)
+              {
+                hydroVars.f_neq[ii][lane] = hydroVars.f[ii][lane] - hydroVars.f_eq[ii][lane];
+              }
+            }
+          }
+
+          inline void DoCollideMultiSite(const LbmParameters* const lbmParams,
+                                         MultiSiteHydroVars<LatticeType>& hydroVars)
+          {
+            const distribn_t omega = lbmParams->GetOmega();
+
+            for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+            {
+              for (unsigned lane = 0; lane < SimdWidth; ++lane)
+              {
+                hydroVars.fPostCollision[direction][lane] = hydroVars.f[direction][lane]
+                    + hydroVars.f_neq[direction][lane] * omega;
+              }
+            }
+          }
+
       };
 
     }
@@ -101,6 +101,16 @@ namespace hemelb
             return mTau;
           }
 
+          inline distribn_t DoGetSiteState(site_t index) const
+          {
+            return mTau[index];
+          }
+
+          inline void DoSetSiteState(site_t index, distribn_t value)
+          {
+            mTau[index] = value;
+          }
+
         private:
           /**
            * Vector containing the current relaxation time for each site in the domain. It will be initialised
@@ -54,6 +54,7 @@ namespace hemelb
       class MRT : public BaseKernel<MRT<MomentBasis>, typename MomentBasis::Lattice>
       {
         public:
+          static const bool MultiSite = true;
 
           MRT(InitParams& initParams)
           {
@@ -126,6 +127,74 @@ namespace hemelb
             }
           }
 
+          inline void DoCalculateDensityMomentumFeqMultiSite(MultiSiteHydroVars<typename MomentBasis::Lattice>& hydroVars)
+          {
+            MomentBasis::Lattice::template CalculateDensityMomentumFEqMultiSite<SimdWidth>(hydroVars.f,
+                                                                                           hydroVars.density,
+                                                                                           hydroVars.momentum_x,
+                                                                                           hydroVars.momentum_y,
+                                                                                           hydroVars.momentum_z,
+                                                                                           hydroVars.velocity_x,
+                                                                                           hydroVars.velocity_y,
+                                                                                           hydroVars.velocity_z,
+                                                                                           hydroVars.f_eq);
+
+            for (unsigned int ii = 0; ii < MomentBasis::Lattice::NUMVECTORS; ++ii)
+            {
+              for (unsigned lane = 0; lane < SimdWidth; ++lane)
+              {
+                hydroVars.f_neq[ii][lane] = hydroVars.f[ii][lane] - hydroVars.f_eq[ii][lane];
+              }
+            }
+          }
+
+          /**
+           * The multi-site collision projects f_neq into the moment space itself, as the
+           * multi-site hydrodynamic variables have no m_neq.
+           */
+          inline void DoCollideMultiSite(const LbmParameters* const lbmParams,
+                                         MultiSiteHydroVars<typename MomentBasis::Lattice>& hydroVars)
+          {
+            distribn_t m_neq[MomentBasis::NUM_KINETIC_MOMENTS][SimdWidth];
+            for (unsigned momentIndex = 0; momentIndex < MomentBasis::NUM_KINETIC_MOMENTS; momentIndex++)
+            {
+              for (unsigned lane = 0; lane < SimdWidth; ++lane)
+              {
+                m_neq[momentIndex][lane] = 0.;
+              }
+              for (Direction direction = 0; direction < MomentBasis::Lattice::NUMVECTORS; ++direction)
+              {
+                for (unsigned lane = 0; lane < SimdWidth; ++lane)
+                {
+                  m_neq[momentIndex][lane] += MomentBasis::REDUCED_MOMENT_BASIS[momentIndex][direction]
+                      * hydroVars.f_neq[direction][lane];
+                }
+              }
+            }
+
+            for (Direction direction = 0; direction < MomentBasis::Lattice::NUMVECTORS; ++direction)
+            {
+              distribn_t collision[SimdWidth];
+              for (unsigned lane = 0; lane < SimdWidth; ++lane)
+              {
+                collision[lane] = 0.;
+              }
+              for (unsigned momentIndex = 0; momentIndex < MomentBasis::NUM_KINETIC_MOMENTS; momentIndex++)
+              {
+                const distribn_t relaxedBasis = collisionMatrix[momentIndex]
+                    * normalisedReducedMomentBasis[momentIndex][direction];
+                for (unsigned lane = 0; lane < SimdWidth; ++lane)
+                {
+                  collision[lane] += relaxedBasis * m_neq[momentIndex][lane];
+                }
+              }
+              for (unsigned lane = 0; lane < SimdWidth; ++lane)
+              {
+                hydroVars.fPostCollision[direction][lane] = hydroVars.f[direction][lane] - collision[lane];
+              }
+            }
+          }
+
           inline void DoReset(InitParams* initParams)
           {
             InitState(*initParams);
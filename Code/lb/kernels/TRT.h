@@ -37,6 +37,8 @@ namespace hemelb
           Direction iZero;
 
         public:
+          static const bool MultiSite = true;
+
           TRT(InitParams& initParams)
           {
             for (Direction i = 0; i < LatticeType::NUMVECTORS; ++i)
@@ -115,6 +117,61 @@ namespace hemelb
             }
           }
 
+          inline void DoCalculateDensityMomentumFeqMultiSite(MultiSiteHydroVars<LatticeType>& hydroVars)
+          {
+            LatticeType::template CalculateDensityMomentumFEqMultiSite<SimdWidth>(hydroVars.f,
+                                                                                  hydroVars.density,
+                                                                                  hydroVars.momentum_x,
+                                                                                  hydroVars.momentum_y,
+                                                                                  hydroVars.momentum_z,
+                                                                                  hydroVars.velocity_x,
+                                                                                  hydroVars.velocity_y,
+                                                                                  hydroVars.velocity_z,
+                                                                                  hydroVars.f_eq);
+
+            for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ++ii)
+            {
+              for (unsigned lane = 0; lane < SimdWidth; ++lane)
+              {
+                hydroVars.f_neq[ii][lane] = hydroVars.f[ii][lane] - hydroVars.f_eq[ii][lane];
+              }
+            }
+          }
+
+          inline void DoCollideMultiSite(const LbmParameters* const lbmParams,
+                                         MultiSiteHydroVars<LatticeType>& hydroVars)
+          {
+            // See DoCollide for the choice of the second relaxation time.
+            const distribn_t Lambda = 3.0 / 16.0;
+
+            const distribn_t tau_plus = lbmParams->GetTau();
+            const distribn_t omega_plus = lbmParams->GetOmega();
+            const distribn_t tau_minus = 0.5 + Lambda / (tau_plus - 0.5);
+            const distribn_t omega_minus =  -1.0 / tau_minus;
+
+            for (unsigned lane = 0; lane < SimdWidth; ++lane)
+            {
+              hydroVars.fPostCollision[iZero][lane] = hydroVars.f[iZero][lane]
+                  + omega_plus * hydroVars.f_neq[iZero][lane];
+            }
+
+            for (OppList::const_iterator oppIt = directionPairs.begin();
+                oppIt != directionPairs.end();
+                ++oppIt)
+            {
+              const Direction& i = oppIt->first;
+              const Direction& iBar = oppIt->second;
+
+              for (unsigned lane = 0; lane < SimdWidth; ++lane)
+              {
+                distribn_t sym = 0.5 * omega_plus * (hydroVars.f_neq[i][lane] + hydroVars.f_neq[iBar][lane]);
+                distribn_t asym = 0.5 * omega_minus * (hydroVars.f_neq[i][lane] - hydroVars.f_neq[iBar][lane]);
+                hydroVars.fPostCollision[i][lane] = hydroVars.f[i][lane] + sym + asym;
+                hydroVars.fPostCollision[iBar][lane] = hydroVars.f[iBar][lane] + sym - asym;
+              }
+            }
+          }
+
       };
 
     }
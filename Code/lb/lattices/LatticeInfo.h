@@ -25,13 +25,15 @@ namespace hemelb
         public:
           inline LatticeInfo(unsigned numberOfVectors,
                              const util::Vector3D<int>* vectors,
-                             const Direction* inverseVectorIndicesIn) :
-              numVectors(numberOfVectors), vectorSet(), inverseVectorIndices()
+                             const Direction* inverseVectorIndicesIn,
+                             const distribn_t* weightsIn) :
+              numVectors(numberOfVectors), vectorSet(), inverseVectorIndices(), weights()
           {
             for (Direction direction = 0; direction < numberOfVectors; ++direction)
             {
               vectorSet.push_back(util::Vector3D<int>(vectors[direction]));
               inverseVectorIndices.push_back(inverseVectorIndicesIn[direction]);
+              weights.push_back(weightsIn[direction]);
             }
           }
 
@@ -50,10 +52,20 @@ namespace hemelb
             return inverseVectorIndices[index];
           }
 
+          /**
+           * The equilibrium weight of the given direction, i.e. the rest equilibrium
+           * distribution at unit density.
+           */
+          inline distribn_t GetWeight(unsigned index) const
+          {
+            return weights[index];
+          }
+
         private:
           const unsigned numVectors;
           std::vector<util::Vector3D<int> > vectorSet;
           std::vector<Direction> inverseVectorIndices;
+          std::vector<distribn_t> weights;
       };
     }
   }
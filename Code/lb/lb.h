@@ -20,6 +20,8 @@
 #include "configuration/SimConfig.h"
 #include "reporting/Timers.h"
 #include "lb/BuildSystemInterface.h"
+#include "lb/Checkpointer.h"
+#include "util/utilityFunctions.h"
 #include <typeinfo>
 
 namespace hemelb
@@ -105,6 +107,37 @@ namespace hemelb
         hemelb::lb::LbmParameters *GetLbmParams();
         lb::MacroscopicPropertyCache& GetPropertyCache();
 
+        /**
+         * Add the state of this process's sites (the distributions and any state the kernel
+         * keeps for each site) to a checkpoint.
+         * @param checkpoint
+         */
+        void SaveToCheckpoint(CheckpointData& checkpoint);
+
+        /**
+         * Fill in the ids of this process's sites, and the number of values expected for
+         * each, ready to read a checkpoint.
+         * @param checkpoint
+         */
+        void PrepareToRestoreFromCheckpoint(CheckpointData& checkpoint) const;
+
+        /**
+         * Set the state of this process's sites from a checkpoint that has been read. Replaces
+         * the initial conditions.
+         * @param checkpoint
+         */
+        void RestoreFromCheckpoint(const CheckpointData& checkpoint);
+
+        /**
+         * The time this process has spent streaming, colliding and post-stepping the sites of
+         * each collision type since the LBM was made, used to calibrate the decomposition weights.
+         * @return
+         */
+        const std::vector<double>& GetCollisionTypeTimes() const
+        {
+          return collisionTypeTimes;
+        }
+
       private:
         void SetInitialConditions();
 
@@ -129,9 +162,26 @@ namespace hemelb
         tInletWallCollision* mInletWallCollision;
         tOutletWallCollision* mOutletWallCollision;
 
+        /**
+         * Wait for the iolets' values for this time step, unless that has already been done. This
+         * is called just before the first iolet sites are streamed, so that the broadcast of the
+         * values overlaps as much of the step as possible.
+         */
+        void ReceiveIoletValues();
+
+        /**
+         * Whether any of the domain edge (or mid domain) sites are on an iolet and so need the
+         * iolets' values.
+         * @param domainEdge
+         * @return
+         */
+        bool HasIoletSites(bool domainEdge) const;
+
         template<typename Collision>
-        void StreamAndCollide(Collision* collision, const site_t iFirstIndex, const site_t iSiteCount)
+        void StreamAndCollide(Collision* collision, const site_t iFirstIndex, const site_t iSiteCount,
+                              const unsigned collisionType)
         {
+          const double start = util::myClock();
           if (mVisControl->IsRendering())
           {
             collision->template StreamAndCollide<true> (iFirstIndex, iSiteCount, &mParams, mLatDat, propertyCache);
@@ -140,11 +190,14 @@ namespace hemelb
           {
             collision->template StreamAndCollide<false> (iFirstIndex, iSiteCount, &mParams, mLatDat, propertyCache);
           }
+          collisionTypeTimes[collisionType] += util::myClock() - start;
         }
 
         template<typename Collision>
-        void PostStep(Collision* collision, const site_t iFirstIndex, const site_t iSiteCount)
+        void PostStep(Collision* collision, const site_t iFirstIndex, const site_t iSiteCount,
+                      const unsigned collisionType)
         {
+          const double start = util::myClock();
           if (mVisControl->IsRendering())
           {
             collision->template DoPostStep<true> (iFirstIndex, iSiteCount, &mParams, mLatDat, propertyCache);
@@ -153,6 +206,32 @@ namespace hemelb
           {
             collision->template DoPostStep<false> (iFirstIndex, iSiteCount, &mParams, mLatDat, propertyCache);
           }
+          collisionTypeTimes[collisionType] += util::myClock() - start;
+        }
+
+        /**
+         * Copy the per-site kernel state of every collision object into (if save is true) or
+         * out of the extra value that follows each site's distributions in siteValues.
+         */
+        void TransferKernelSiteStates(std::vector<distribn_t>& siteValues, bool save);
+
+        template<typename Collision>
+        void TransferKernelSiteStates(Collision* collision, const site_t iFirstIndex, const site_t iSiteCount,
+                                      std::vector<distribn_t>& siteValues, bool save)
+        {
+          const unsigned valuesPerSite = LatticeType::NUMVECTORS + 1;
+          for (site_t siteIndex = iFirstIndex; siteIndex < iFirstIndex + iSiteCount; ++siteIndex)
+          {
+            distribn_t& value = siteValues[siteIndex * valuesPerSite + LatticeType::NUMVECTORS];
+            if (save)
+            {
+              value = collision->GetKernelSiteState(siteIndex);
+            }
+            else
+            {
+              collision->SetKernelSiteState(siteIndex, value);
+            }
+          }
         }
 
         unsigned int inletCount;
@@ -174,6 +253,11 @@ namespace hemelb
         MacroscopicPropertyCache propertyCache;
 
         geometry::neighbouring::NeighbouringDataManager *neighbouringDataManager;
+
+        //! The time spent on the sites of each collision type so far.
+        std::vector<double> collisionTypeTimes;
+        //! Whether the iolets' values have been received yet this time step.
+        bool ioletValuesReceived;
     };
 
   } // Namespace lb
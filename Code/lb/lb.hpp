@@ -39,7 +39,8 @@ namespace hemelb
                           geometry::neighbouring::NeighbouringDataManager *neighbouringDataManager) :
       mSimConfig(iSimulationConfig), mNet(net), mLatDat(latDat), mState(simState), 
           mParams(iSimulationConfig->GetTimeStepLength(), iSimulationConfig->GetVoxelSize()), timings(atimings),
-          propertyCache(*simState, *latDat), neighbouringDataManager(neighbouringDataManager)
+          propertyCache(*simState, *latDat), neighbouringDataManager(neighbouringDataManager),
+          collisionTypeTimes(COLLISION_TYPES, 0.0), ioletValuesReceived(false)
     {
       ReadParameters();
     }
@@ -149,28 +150,33 @@ namespace hemelb
     void LBM<LatticeType>::PrepareBoundaryObjects()
     {
       // First, iterate through all of the inlet and outlet objects, finding out the minimum density seen in the simulation.
+      // All of them, not just those with sites on this proc, so that every proc agrees.
       distribn_t minDensity = std::numeric_limits<distribn_t>::max();
 
-      for (unsigned inlet = 0; inlet < mInletValues->GetLocalIoletCount(); ++inlet)
+      for (int inlet = 0; inlet < InletCount(); ++inlet)
       {
-        minDensity = std::min(minDensity, mInletValues->GetLocalIolet(inlet)->GetDensityMin());
+        minDensity = std::min(minDensity, mInletValues->GetIolet(inlet)->GetDensityMin());
       }
 
-      for (unsigned outlet = 0; outlet < mOutletValues->GetLocalIoletCount(); ++outlet)
+      for (int outlet = 0; outlet < OutletCount(); ++outlet)
       {
-        minDensity = std::min(minDensity, mOutletValues->GetLocalIolet(outlet)->GetDensityMin());
+        minDensity = std::min(minDensity, mOutletValues->GetIolet(outlet)->GetDensityMin());
       }
 
       // Now go through them again, informing them of the minimum density.
-      for (unsigned inlet = 0; inlet < mInletValues->GetLocalIoletCount(); ++inlet)
+      for (int inlet = 0; inlet < InletCount(); ++inlet)
       {
-        mInletValues->GetLocalIolet(inlet)->SetMinimumSimulationDensity(minDensity);
+        mInletValues->GetIolet(inlet)->SetMinimumSimulationDensity(minDensity);
       }
 
-      for (unsigned outlet = 0; outlet < mOutletValues->GetLocalIoletCount(); ++outlet)
+      for (int outlet = 0; outlet < OutletCount(); ++outlet)
       {
-        mOutletValues->GetLocalIolet(outlet)->SetMinimumSimulationDensity(minDensity);
+        mOutletValues->GetIolet(outlet)->SetMinimumSimulationDensity(minDensity);
       }
+
+      // Any Windkessel iolets get their flow rates from the site velocities.
+      mInletValues->SetPropertyCache(propertyCache);
+      mOutletValues->SetPropertyCache(propertyCache);
     }
 
     template<class LatticeType>
@@ -184,14 +190,107 @@ namespace hemelb
 
         LatticeType::CalculateFeq(density, 0.0, 0.0, 0.0, f_eq);
 
-        distribn_t* f_old_p = mLatDat->GetFOld(i * LatticeType::NUMVECTORS);
-        distribn_t* f_new_p = mLatDat->GetFNew(i * LatticeType::NUMVECTORS);
+        for (unsigned int l = 0; l < LatticeType::NUMVECTORS; l++)
+        {
+          site_t index = mLatDat->template GetDistributionIndex<LatticeType>(i, l);
+          mLatDat->WriteFNew(index, l, f_eq[l]);
+          mLatDat->WriteFOld(index, l, f_eq[l]);
+        }
+      }
+    }
+
+    template<class LatticeType>
+    void LBM<LatticeType>::SaveToCheckpoint(CheckpointData& checkpoint)
+    {
+      const unsigned valuesPerSite = LatticeType::NUMVECTORS + 1;
+      checkpoint.valuesPerSite = valuesPerSite;
+      checkpoint.siteIds.resize(mLatDat->GetLocalFluidSiteCount());
+      checkpoint.siteValues.resize(mLatDat->GetLocalFluidSiteCount() * valuesPerSite);
+
+      for (site_t i = 0; i < mLatDat->GetLocalFluidSiteCount(); i++)
+      {
+        checkpoint.siteIds[i] =
+            mLatDat->GetGlobalNoncontiguousSiteIdFromGlobalCoords(mLatDat->GetGlobalSiteCoords(i));
+
+        distribn_t buffer[LatticeType::NUMVECTORS];
+        const distribn_t* fOld = mLatDat->GetSite(i).template GetFOld<LatticeType>(buffer);
+        std::copy(fOld, fOld + LatticeType::NUMVECTORS, checkpoint.siteValues.begin() + i * valuesPerSite);
+      }
+
+      TransferKernelSiteStates(checkpoint.siteValues, true);
+    }
+
+    template<class LatticeType>
+    void LBM<LatticeType>::PrepareToRestoreFromCheckpoint(CheckpointData& checkpoint) const
+    {
+      checkpoint.valuesPerSite = LatticeType::NUMVECTORS + 1;
+      checkpoint.siteIds.resize(mLatDat->GetLocalFluidSiteCount());
+      for (site_t i = 0; i < mLatDat->GetLocalFluidSiteCount(); i++)
+      {
+        checkpoint.siteIds[i] =
+            mLatDat->GetGlobalNoncontiguousSiteIdFromGlobalCoords(mLatDat->GetGlobalSiteCoords(i));
+      }
+    }
+
+    template<class LatticeType>
+    void LBM<LatticeType>::RestoreFromCheckpoint(const CheckpointData& checkpoint)
+    {
+      const unsigned valuesPerSite = LatticeType::NUMVECTORS + 1;
 
+      // As for the initial conditions, the distributions go where the first step will read them.
+      for (site_t i = 0; i < mLatDat->GetLocalFluidSiteCount(); i++)
+      {
         for (unsigned int l = 0; l < LatticeType::NUMVECTORS; l++)
         {
-          f_new_p[l] = f_old_p[l] = f_eq[l];
+          site_t index = mLatDat->template GetDistributionIndex<LatticeType>(i, l);
+          mLatDat->WriteFNew(index, l, checkpoint.siteValues[i * valuesPerSite + l]);
+          mLatDat->WriteFOld(index, l, checkpoint.siteValues[i * valuesPerSite + l]);
         }
       }
+
+      std::vector<distribn_t> siteValues(checkpoint.siteValues);
+      TransferKernelSiteStates(siteValues, false);
+    }
+
+    template<class LatticeType>
+    void LBM<LatticeType>::TransferKernelSiteStates(std::vector<distribn_t>& siteValues, bool save)
+    {
+      site_t offset = 0;
+
+      TransferKernelSiteStates(mMidFluidCollision, offset, mLatDat->GetMidDomainCollisionCount(0), siteValues, save);
+      offset += mLatDat->GetMidDomainCollisionCount(0);
+
+      TransferKernelSiteStates(mWallCollision, offset, mLatDat->GetMidDomainCollisionCount(1), siteValues, save);
+      offset += mLatDat->GetMidDomainCollisionCount(1);
+
+      TransferKernelSiteStates(mInletCollision, offset, mLatDat->GetMidDomainCollisionCount(2), siteValues, save);
+      offset += mLatDat->GetMidDomainCollisionCount(2);
+
+      TransferKernelSiteStates(mOutletCollision, offset, mLatDat->GetMidDomainCollisionCount(3), siteValues, save);
+      offset += mLatDat->GetMidDomainCollisionCount(3);
+
+      TransferKernelSiteStates(mInletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(4), siteValues, save);
+      offset += mLatDat->GetMidDomainCollisionCount(4);
+
+      TransferKernelSiteStates(mOutletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(5), siteValues, save);
+      offset += mLatDat->GetMidDomainCollisionCount(5);
+
+      TransferKernelSiteStates(mMidFluidCollision, offset, mLatDat->GetDomainEdgeCollisionCount(0), siteValues, save);
+      offset += mLatDat->GetDomainEdgeCollisionCount(0);
+
+      TransferKernelSiteStates(mWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(1), siteValues, save);
+      offset += mLatDat->GetDomainEdgeCollisionCount(1);
+
+      TransferKernelSiteStates(mInletCollision, offset, mLatDat->GetDomainEdgeCollisionCount(2), siteValues, save);
+      offset += mLatDat->GetDomainEdgeCollisionCount(2);
+
+      TransferKernelSiteStates(mOutletCollision, offset, mLatDat->GetDomainEdgeCollisionCount(3), siteValues, save);
+      offset += mLatDat->GetDomainEdgeCollisionCount(3);
+
+      TransferKernelSiteStates(mInletWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(4), siteValues, save);
+      offset += mLatDat->GetDomainEdgeCollisionCount(4);
+
+      TransferKernelSiteStates(mOutletWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(5), siteValues, save);
     }
 
     template<class LatticeType>
@@ -199,15 +298,51 @@ namespace hemelb
     {
       timings[hemelb::reporting::Timers::lb].Start();
 
+#ifdef HEMELB_USE_PERSISTENT_HALO
+      // The lattice data exchanges the halo through persistent requests of its own, which are
+      // started here and after streaming the domain edge (see PreSend).
+      mLatDat->StartHaloReceives();
+#else
       // Delegate to the lattice data object to post the asynchronous sends and receives
       // (via the Net object).
       // NOTE that this doesn't actually *perform* the sends and receives, it asks the Net
       // to include them in the ISends and IRecvs that happen later.
       mLatDat->SendAndReceive(mNet);
+#endif
+
+      // The iolets' values for this step are on their way.
+      ioletValuesReceived = false;
 
       timings[hemelb::reporting::Timers::lb].Stop();
     }
 
+    template<class LatticeType>
+    void LBM<LatticeType>::ReceiveIoletValues()
+    {
+      if (!ioletValuesReceived)
+      {
+        mInletValues->FinishReceive();
+        mOutletValues->FinishReceive();
+        ioletValuesReceived = true;
+      }
+    }
+
+    template<class LatticeType>
+    bool LBM<LatticeType>::HasIoletSites(bool domainEdge) const
+    {
+      // All the collision types after fluid (0) and wall (1) are on an inlet or outlet.
+      for (unsigned collisionType = 2; collisionType < COLLISION_TYPES; ++collisionType)
+      {
+        if ( (domainEdge
+          ? mLatDat->GetDomainEdgeCollisionCount(collisionType)
+          : mLatDat->GetMidDomainCollisionCount(collisionType)) > 0)
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
     template<class LatticeType>
     void LBM<LatticeType>::PreSend()
     {
@@ -222,26 +357,31 @@ namespace hemelb
        */
       site_t offset = mLatDat->GetMidDomainSiteCount();
 
-      StreamAndCollide(mMidFluidCollision, offset, mLatDat->GetDomainEdgeCollisionCount(0));
+      StreamAndCollide(mMidFluidCollision, offset, mLatDat->GetDomainEdgeCollisionCount(0), 0);
       offset += mLatDat->GetDomainEdgeCollisionCount(0);
 
-      StreamAndCollide(mWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(1));
+      StreamAndCollide(mWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(1), 1);
       offset += mLatDat->GetDomainEdgeCollisionCount(1);
 
-      mInletValues->FinishReceive();
-      StreamAndCollide(mInletCollision, offset, mLatDat->GetDomainEdgeCollisionCount(2));
+      if (HasIoletSites(true))
+      {
+        ReceiveIoletValues();
+      }
+      StreamAndCollide(mInletCollision, offset, mLatDat->GetDomainEdgeCollisionCount(2), 2);
       offset += mLatDat->GetDomainEdgeCollisionCount(2);
 
-      mOutletValues->FinishReceive();
-      StreamAndCollide(mOutletCollision, offset, mLatDat->GetDomainEdgeCollisionCount(3));
+      StreamAndCollide(mOutletCollision, offset, mLatDat->GetDomainEdgeCollisionCount(3), 3);
       offset += mLatDat->GetDomainEdgeCollisionCount(3);
 
-      StreamAndCollide(mInletWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(4));
+      StreamAndCollide(mInletWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(4), 4);
       offset += mLatDat->GetDomainEdgeCollisionCount(4);
 
-      StreamAndCollide(mOutletWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(5));
+      StreamAndCollide(mOutletWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(5), 5);
 
       timings[hemelb::reporting::Timers::lb_calc].Stop();
+#ifdef HEMELB_USE_PERSISTENT_HALO
+      mLatDat->StartHaloSends();
+#endif
       timings[hemelb::reporting::Timers::lb].Stop();
     }
 
@@ -261,22 +401,26 @@ namespace hemelb
        */
       site_t offset = 0;
 
-      StreamAndCollide(mMidFluidCollision, offset, mLatDat->GetMidDomainCollisionCount(0));
+      StreamAndCollide(mMidFluidCollision, offset, mLatDat->GetMidDomainCollisionCount(0), 0);
       offset += mLatDat->GetMidDomainCollisionCount(0);
 
-      StreamAndCollide(mWallCollision, offset, mLatDat->GetMidDomainCollisionCount(1));
+      StreamAndCollide(mWallCollision, offset, mLatDat->GetMidDomainCollisionCount(1), 1);
       offset += mLatDat->GetMidDomainCollisionCount(1);
 
-      StreamAndCollide(mInletCollision, offset, mLatDat->GetMidDomainCollisionCount(2));
+      if (HasIoletSites(false))
+      {
+        ReceiveIoletValues();
+      }
+      StreamAndCollide(mInletCollision, offset, mLatDat->GetMidDomainCollisionCount(2), 2);
       offset += mLatDat->GetMidDomainCollisionCount(2);
 
-      StreamAndCollide(mOutletCollision, offset, mLatDat->GetMidDomainCollisionCount(3));
+      StreamAndCollide(mOutletCollision, offset, mLatDat->GetMidDomainCollisionCount(3), 3);
       offset += mLatDat->GetMidDomainCollisionCount(3);
 
-      StreamAndCollide(mInletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(4));
+      StreamAndCollide(mInletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(4), 4);
       offset += mLatDat->GetMidDomainCollisionCount(4);
 
-      StreamAndCollide(mOutletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(5));
+      StreamAndCollide(mOutletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(5), 5);
 
       timings[hemelb::reporting::Timers::lb_calc].Stop();
       timings[hemelb::reporting::Timers::lb].Stop();
@@ -287,52 +431,61 @@ namespace hemelb
     {
       timings[hemelb::reporting::Timers::lb].Start();
 
-      // Copy the distribution functions received from the neighbouring
-      // processors into the destination buffer "f_new".
+#ifdef HEMELB_USE_PERSISTENT_HALO
+      timings[hemelb::reporting::Timers::mpiWait].Start();
+      mLatDat->WaitForHalo();
+      timings[hemelb::reporting::Timers::mpiWait].Stop();
+#endif
+      // Make sure the distribution functions received from the neighbouring
+      // processors are in the destination buffer "f_new".
       // This is done here, after receiving the sent distributions from neighbours.
       mLatDat->CopyReceived();
 
+      // Make sure the iolets' values have arrived by the end of the step, even with no iolet
+      // sites.
+      ReceiveIoletValues();
+
       // Do any cleanup steps necessary on boundary nodes
       site_t offset = mLatDat->GetMidDomainSiteCount();
 
       timings[hemelb::reporting::Timers::lb_calc].Start();
 
       //TODO yup, this is horrible. If you read this, please improve the following code.
-      PostStep(mMidFluidCollision, offset, mLatDat->GetDomainEdgeCollisionCount(0));
+      PostStep(mMidFluidCollision, offset, mLatDat->GetDomainEdgeCollisionCount(0), 0);
       offset += mLatDat->GetDomainEdgeCollisionCount(0);
 
-      PostStep(mWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(1));
+      PostStep(mWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(1), 1);
       offset += mLatDat->GetDomainEdgeCollisionCount(1);
 
-      PostStep(mInletCollision, offset, mLatDat->GetDomainEdgeCollisionCount(2));
+      PostStep(mInletCollision, offset, mLatDat->GetDomainEdgeCollisionCount(2), 2);
       offset += mLatDat->GetDomainEdgeCollisionCount(2);
 
-      PostStep(mOutletCollision, offset, mLatDat->GetDomainEdgeCollisionCount(3));
+      PostStep(mOutletCollision, offset, mLatDat->GetDomainEdgeCollisionCount(3), 3);
       offset += mLatDat->GetDomainEdgeCollisionCount(3);
 
-      PostStep(mInletWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(4));
+      PostStep(mInletWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(4), 4);
       offset += mLatDat->GetDomainEdgeCollisionCount(4);
 
-      PostStep(mOutletWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(5));
+      PostStep(mOutletWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(5), 5);
 
       offset = 0;
 
-      PostStep(mMidFluidCollision, offset, mLatDat->GetMidDomainCollisionCount(0));
+      PostStep(mMidFluidCollision, offset, mLatDat->GetMidDomainCollisionCount(0), 0);
       offset += mLatDat->GetMidDomainCollisionCount(0);
 
-      PostStep(mWallCollision, offset, mLatDat->GetMidDomainCollisionCount(1));
+      PostStep(mWallCollision, offset, mLatDat->GetMidDomainCollisionCount(1), 1);
       offset += mLatDat->GetMidDomainCollisionCount(1);
 
-      PostStep(mInletCollision, offset, mLatDat->GetMidDomainCollisionCount(2));
+      PostStep(mInletCollision, offset, mLatDat->GetMidDomainCollisionCount(2), 2);
       offset += mLatDat->GetMidDomainCollisionCount(2);
 
-      PostStep(mOutletCollision, offset, mLatDat->GetMidDomainCollisionCount(3));
+      PostStep(mOutletCollision, offset, mLatDat->GetMidDomainCollisionCount(3), 3);
       offset += mLatDat->GetMidDomainCollisionCount(3);
 
-      PostStep(mInletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(4));
+      PostStep(mInletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(4), 4);
       offset += mLatDat->GetMidDomainCollisionCount(4);
 
-      PostStep(mOutletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(5));
+      PostStep(mOutletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(5), 5);
 
       timings[hemelb::reporting::Timers::lb_calc].Stop();
       timings[hemelb::reporting::Timers::lb].Stop();
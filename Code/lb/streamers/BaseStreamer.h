@@ -11,6 +11,9 @@
 #define HEMELB_LB_STREAMERS_BASESTREAMER_H
 
 #include <cmath>
+#ifdef HEMELB_USE_OPENMP
+#include <omp.h>
+#endif
 
 #include "geometry/LatticeData.h"
 #include "vis/Control.h"
@@ -34,11 +37,15 @@ namespace hemelb
        *  - <bool tDoRayTracing> PostStep(const site_t, const site_t, const LbmParameters*,
        *      geometry::LatticeData*, hemelb::vis::Control*)
        *  - Reset(kernels::InitParams* init)
+       *  - GetKernelSiteState(site_t) and SetKernelSiteState(site_t, distribn_t), for checkpointing
        *
        * The following must be implemented by concrete streamers (which derive from this class
        * using the CRTP).
        *  - typedef for CollisionType, the type of the collider operation.
+       *  - static const bool ThreadSafe, true if DoStreamAndCollide may be run concurrently on
+       *      disjoint ranges of sites.
        *  - Constructor(InitParams&)
+       *  - CollisionType& GetCollision()
        *  - <bool tDoRayTracing> DoStreamAndCollide(const site_t, const site_t, const LbmParameters*,
        *      geometry::LatticeData*, hemelb::vis::Control*)
        *  - <bool tDoRayTracing> DoPostStep(const site_t, const site_t, const LbmParameters*,
@@ -52,6 +59,11 @@ namespace hemelb
        * SimpleCollideAndStreamDelegate and wall link streaming to BFLDelagate,
        * which uses SimpleBounceBackDelegate in the cases where it can't handle
        * because two opposite links are both wall links).
+       *
+       * When built with OpenMP, StreamAndCollide splits the range of sites into one contiguous
+       * chunk per thread, for streamers that are ThreadSafe. Each site only writes to its own
+       * slots in the property cache and the distributions streamed into it from its own links, so
+       * the chunks are independent.
        */
       template<typename StreamerImpl>
       class BaseStreamer
@@ -64,6 +76,25 @@ namespace hemelb
                                        geometry::LatticeData* latDat,
                                        lb::MacroscopicPropertyCache& propertyCache)
           {
+#ifdef HEMELB_USE_OPENMP
+            if (StreamerImpl::ThreadSafe && siteCount >= MinimumSitesToThread)
+            {
+#pragma omp parallel
+              {
+                const site_t threadCount = omp_get_num_threads();
+                const site_t thread = omp_get_thread_num();
+                const site_t chunkStart = firstIndex + (siteCount * thread) / threadCount;
+                const site_t chunkEnd = firstIndex + (siteCount * (thread + 1)) / threadCount;
+
+                static_cast<StreamerImpl*> (this)->template DoStreamAndCollide<tDoRayTracing> (chunkStart,
+                                                                                               chunkEnd - chunkStart,
+                                                                                               lbmParams,
+                                                                                               latDat,
+                                                                                               propertyCache);
+              }
+              return;
+            }
+#endif
             static_cast<StreamerImpl*> (this)->template DoStreamAndCollide<tDoRayTracing> (firstIndex,
                                                                                            siteCount,
                                                                                            lbmParams,
@@ -87,13 +118,44 @@ namespace hemelb
                                                                                    propertyCache);
           }
 
+          inline distribn_t GetKernelSiteState(site_t index)
+          {
+            return static_cast<StreamerImpl*> (this)->GetCollision().GetKernelSiteState(index);
+          }
+
+          inline void SetKernelSiteState(site_t index, distribn_t value)
+          {
+            static_cast<StreamerImpl*> (this)->GetCollision().SetKernelSiteState(index, value);
+          }
+
         protected:
+#ifdef HEMELB_USE_OPENMP
+          /**
+           * Ranges smaller than this aren't worth the cost of starting a parallel region.
+           */
+          static const site_t MinimumSitesToThread = 256;
+#endif
+
+          /**
+           * Store the macroscopic properties of a site in the property cache. This writes only
+           * to the entries for this site, and the caches are only resized (by SetRefreshFlag)
+           * between time steps, so it is safe to call concurrently for different sites. The
+           * monitoring reductions are folded in here too, while the site's distributions are
+           * still in cache; the accumulator keeps one slot per thread.
+           */
           template<bool tDoRayTracing, class LatticeType>
           inline static void UpdateMinsAndMaxes(const geometry::Site<geometry::LatticeData>& site,
                                                 const kernels::HydroVarsBase<LatticeType>& hydroVars,
                                                 const LbmParameters* lbmParams,
                                                 lb::MacroscopicPropertyCache& propertyCache)
           {
+            if (propertyCache.monitoringAccumulator.RequiresRefresh())
+            {
+              propertyCache.monitoringAccumulator.Accumulate<LatticeType>(hydroVars.density,
+                                                                          hydroVars.velocity,
+                                                                          hydroVars.GetFPostCollision().f);
+            }
+
             if (propertyCache.densityCache.RequiresRefresh())
             {
               propertyCache.densityCache.Put(site.GetIndex(), hydroVars.density);
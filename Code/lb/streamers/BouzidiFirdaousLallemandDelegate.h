@@ -51,7 +51,7 @@ namespace hemelb
                                  const Direction& direction)
           {
             site_t invDirection = LatticeType::INVERSEDIRECTIONS[direction];
-            site_t bbDestination = (site.GetIndex() * LatticeType::NUMVECTORS) + invDirection;
+            site_t bbDestination = latticeData->GetDistributionIndex<LatticeType>(site.GetIndex(), invDirection);
             distribn_t q = site.GetWallDistance<LatticeType> (direction);
 
             if (site.HasWall(invDirection) || q < 0.5)
@@ -67,8 +67,10 @@ namespace hemelb
             {
               // We have a fluid site and have all the data needed to complete this direction!
               // Implement Eq (5b) from Bouzidi et al.
-              * (latticeData->GetFNew(bbDestination)) = (hydroVars.GetFPostCollision()[direction] + (2.0 * q - 1)
-                  * hydroVars.GetFPostCollision()[invDirection]) / (2.0 * q);
+              latticeData->WriteFNew(bbDestination,
+                                     invDirection,
+                                     (hydroVars.GetFPostCollision()[direction] + (2.0 * q - 1)
+                                         * hydroVars.GetFPostCollision()[invDirection]) / (2.0 * q));
             }
 
           }
@@ -76,7 +78,6 @@ namespace hemelb
                                    const geometry::Site<geometry::LatticeData>& site,
                                    const Direction& direction)
           {
-            distribn_t* fNew = latticeData->GetFNew(site.GetIndex() * LatticeType::NUMVECTORS);
             site_t invDirection = LatticeType::INVERSEDIRECTIONS[direction];
             distribn_t q = site.GetWallDistance<LatticeType> (direction);
             // If there is no fluid site in the opposite direction, fall back to simple
@@ -91,7 +92,14 @@ namespace hemelb
               // Note that:
               // - fNew[direction] is the newly-arrived fPostColl[direction] from the neighbouring site
               // - fNew[invDirection] is the above-bounced-back fPostColl[direction] for this site.
-              fNew[invDirection] = 2.0 * q * fNew[invDirection] + (1.0 - 2.0 * q) * fNew[direction];
+              const site_t fNewInvIndex = latticeData->GetIncomingIndex<LatticeType>(site.GetIndex(), invDirection);
+              const distribn_t fNewInv = latticeData->ReadFNew(fNewInvIndex, invDirection);
+              latticeData->WriteFNew(fNewInvIndex,
+                                     invDirection,
+                                     2.0 * q * fNewInv + (1.0 - 2.0 * q)
+                                         * latticeData->ReadFNew(latticeData->GetIncomingIndex<LatticeType>(site.GetIndex(),
+                                                                                                            direction),
+                                                                 direction));
             }
           }
       };
@@ -13,6 +13,7 @@
 #include "lb/streamers/BaseStreamerDelegate.h"
 #include "geometry/neighbouring/RequiredSiteInformation.h"
 #include "geometry/neighbouring/NeighbouringDataManager.h"
+#include "util/static_assert.h"
 
 namespace hemelb
 {
@@ -39,6 +40,12 @@ namespace hemelb
                 bValues(initParams.boundaryObject),
                 bbDelegate(delegatorCollider, initParams)
           {
+#ifdef HEMELB_USE_AA_PATTERN
+            // GetNeighbourFOld reads the neighbour's distributions in the middle of the sweep.
+            // Streaming in place, a neighbour updated earlier in the sweep has already had them
+            // overwritten with post-step values, so GZS can't be used with the AA pattern.
+            HEMELB_STATIC_ASSERT(sizeof(CollisionImpl) == 0);
+#endif
             // Want to loop over each site this streamer is responsible for,
             // as specified in the siteRanges.
             for (std::vector<std::pair<site_t, site_t> >::iterator rangeIt =
@@ -171,8 +178,7 @@ namespace hemelb
               if (site.HasIolet(i))
               {
                 int boundaryId = site.GetIoletId();
-                iolets::InOutLetVelocity* iolet =
-                    dynamic_cast<iolets::InOutLetVelocity*> (bValues->GetLocalIolet(boundaryId));
+                iolets::InOutLetVelocity* iolet = bValues->GetVelocityIolet(boundaryId);
                 if (iolet == NULL)
                 {
                   // SBB
@@ -220,7 +226,8 @@ namespace hemelb
                 else
                 {
                   // There is a neighbour site to use for standard GZS to calculate u_w2.
-                  const distribn_t *neighbourFOld = GetNeighbourFOld(site, i, latDat);
+                  distribn_t neighbourFOldBuffer[LatticeType::NUMVECTORS];
+                  const distribn_t *neighbourFOld = GetNeighbourFOld(site, i, latDat, neighbourFOldBuffer);
                   // Now calculate this field information.
                   LatticeVelocity neighbourVelocity;
                   distribn_t neighbourFEq[LatticeType::NUMVECTORS];
@@ -290,15 +297,17 @@ namespace hemelb
             // Perform collision
             collider.Collide(lbmParams, hydroVarsWall);
             // stream
-            distribn_t* fNew = latDat->GetFNew(site.GetIndex() * LatticeType::NUMVECTORS);
-            fNew[i] = hydroVarsWall.GetFPostCollision()[i];
+            latDat->WriteFNew(latDat->GetDistributionIndex<LatticeType>(site.GetIndex(), i),
+                              i,
+                              hydroVarsWall.GetFPostCollision()[i]);
 
           }
 
         private:
           const distribn_t *GetNeighbourFOld(const geometry::Site<geometry::LatticeData>& site,
                                              const Direction& i,
-                                             geometry::LatticeData* const latDat)
+                                             geometry::LatticeData* const latDat,
+                                             distribn_t* buffer)
           {
             const distribn_t* neighbourFOld;
             // Find the neighbour's global location and which proc it's on.
@@ -310,7 +319,7 @@ namespace hemelb
               // If it's local, get a Site object for it.
               geometry::Site<geometry::LatticeData> nextSiteOut =
                   latDat->GetSite(latDat->GetContiguousSiteId(neighbourGlobalLocation));
-              neighbourFOld = nextSiteOut.GetFOld<LatticeType> ();
+              neighbourFOld = nextSiteOut.GetFOld<LatticeType> (buffer);
             }
             else
             {
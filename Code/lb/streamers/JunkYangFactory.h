@@ -43,6 +43,8 @@ namespace hemelb
         public:
 
           typedef CollisionImpl CollisionType;
+          // The per-site maps of matrices and vectors are looked up with operator[].
+          static const bool ThreadSafe = false;
 
           JunkYangFactory(kernels::InitParams& initParams) :
               collider(initParams), bulkLinkDelegate(collider, initParams),
@@ -78,6 +80,11 @@ namespace hemelb
             }
           }
 
+          inline CollisionType& GetCollision()
+          {
+            return collider;
+          }
+
           template<bool tDoRayTracing>
           inline void DoStreamAndCollide(const site_t firstIndex, const site_t siteCount,
                                          const LbmParameters* lbmParams,
@@ -91,7 +98,9 @@ namespace hemelb
 
               geometry::Site<geometry::LatticeData> site = latticeData->GetSite(siteIndex);
 
-              kernels::HydroVars<typename CollisionType::CKernel> hydroVars(site.GetFOld<LatticeType>());
+              distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+              const distribn_t* siteFOld = site.GetFOld<LatticeType>(fOldBuffer);
+              kernels::HydroVars<typename CollisionType::CKernel> hydroVars(siteFOld);
 
               ///< @todo #126 This value of tau will be updated by some kernels within the collider code (e.g. LBGKNN). It would be nicer if tau is handled in a single place.
               hydroVars.tau = lbmParams->GetTau();
@@ -133,7 +142,7 @@ namespace hemelb
                     hydroVars.GetFPostCollision()[*incomingVelocityIter];
                 fPostCollisionInverseDir[siteIndex](index) =
                     hydroVars.GetFPostCollision()[inverseDirection];
-                fOld[siteIndex](index) = site.GetFOld<LatticeType>()[*incomingVelocityIter];
+                fOld[siteIndex](index) = siteFOld[*incomingVelocityIter];
               }
 
               for (std::set<Direction>::const_iterator outgoingVelocityIter =
@@ -143,7 +152,7 @@ namespace hemelb
               {
                 fPostCollision[siteIndex](index) =
                     hydroVars.GetFPostCollision()[*outgoingVelocityIter];
-                fOld[siteIndex](index) = site.GetFOld<LatticeType>()[*outgoingVelocityIter];
+                fOld[siteIndex](index) = siteFOld[*outgoingVelocityIter];
               }
 
               BaseStreamer<JunkYangFactory>::template UpdateMinsAndMaxes<tDoRayTracing>(site,
@@ -184,8 +193,10 @@ namespace hemelb
                   incomingVelocityIter != incomingVelocities[siteIndex].end();
                   ++incomingVelocityIter, ++index)
               {
-                * (latticeData->GetFNew(siteIndex * LatticeType::NUMVECTORS + *incomingVelocityIter)) =
-                    systemSolution[index];
+                latticeData->WriteFNew(latticeData->GetDistributionIndex<LatticeType>(siteIndex,
+                                                                                      *incomingVelocityIter),
+                                       *incomingVelocityIter,
+                                       systemSolution[index]);
               }
 
               geometry::Site<geometry::LatticeData> site = latticeData->GetSite(siteIndex);
@@ -468,8 +479,9 @@ namespace hemelb
                 outgoingDirIter != outgoingVelocities[contiguousSiteIndex].end();
                 ++outgoingDirIter, ++index)
             {
-              fNew[index] = *latticeData.GetFNew(contiguousSiteIndex * LatticeType::NUMVECTORS
-                  + *outgoingDirIter);
+              fNew[index] = latticeData.ReadFNew(latticeData.GetIncomingIndex<LatticeType>(contiguousSiteIndex,
+                                                                                           *outgoingDirIter),
+                                                 *outgoingDirIter);
             }
 
             rVector = THETA
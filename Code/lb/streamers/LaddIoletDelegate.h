@@ -49,8 +49,7 @@ namespace hemelb
             // link and a1_i = w_1 / cs2
 
             int boundaryId = site.GetIoletId();
-            iolets::InOutLetVelocity* iolet =
-                dynamic_cast<iolets::InOutLetVelocity*>(bValues->GetLocalIolet(boundaryId));
+            iolets::InOutLetVelocity* iolet = bValues->GetVelocityIolet(boundaryId);
             LatticePosition sitePos(site.GetGlobalSiteCoords());
 
             LatticePosition halfWay(sitePos);
@@ -69,9 +68,11 @@ namespace hemelb
                 * (wallMom.x * LatticeType::CX[ii] + wallMom.y * LatticeType::CY[ii]
                     + wallMom.z * LatticeType::CZ[ii]) / Cs2;
 
-            * (latticeData->GetFNew(SimpleBounceBackDelegate<CollisionImpl>::GetBBIndex(site.GetIndex(),
-                                                                                        ii))) =
-                hydroVars.GetFPostCollision()[ii] - correction;
+            latticeData->WriteFNew(SimpleBounceBackDelegate<CollisionImpl>::GetBBIndex(latticeData,
+                                                                                       site.GetIndex(),
+                                                                                       ii),
+                                   LatticeType::INVERSEDIRECTIONS[ii],
+                                   hydroVars.GetFPostCollision()[ii] - correction);
           }
         private:
           iolets::BoundaryValues* bValues;
@@ -31,10 +31,10 @@ namespace hemelb
             int boundaryId = site.GetIoletId();
 
             // Set the density at the "ghost" site to be the density of the iolet.
-            distribn_t ghostDensity = iolet.GetBoundaryDensity(boundaryId);
+            distribn_t ghostDensity = iolet.GetCurrentDensity(boundaryId);
 
             // Calculate the velocity at the ghost site, as the component normal to the iolet.
-            util::Vector3D<float> ioletNormal = iolet.GetLocalIolet(boundaryId)->GetNormal();
+            util::Vector3D<float> ioletNormal = iolet.GetIoletNormal(boundaryId);
 
             // Note that the division by density compensates for the fact that v_x etc have momentum
             // not velocity.
@@ -44,7 +44,8 @@ namespace hemelb
             // TODO having to give 0 as an argument is also ugly.
             // TODO it's ugly that we have to give hydroVars a nonsense distribution vector
             // that doesn't get used.
-            kernels::HydroVars<typename CollisionType::CKernel> ghostHydrovars(site.GetFOld<LatticeType> ());
+            distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+            kernels::HydroVars<typename CollisionType::CKernel> ghostHydrovars(site.GetFOld<LatticeType> (fOldBuffer));
 
             ghostHydrovars.density = ghostDensity;
             ghostHydrovars.momentum = ioletNormal * component * ghostDensity;
@@ -53,8 +54,9 @@ namespace hemelb
 
             Direction unstreamed = LatticeType::INVERSEDIRECTIONS[direction];
 
-            *latticeData->GetFNew(site.GetIndex() * LatticeType::NUMVECTORS + unstreamed)
-                = ghostHydrovars.GetFEq()[unstreamed];
+            latticeData->WriteFNew(latticeData->GetDistributionIndex<LatticeType>(site.GetIndex(), unstreamed),
+                                   unstreamed,
+                                   ghostHydrovars.GetFEq()[unstreamed]);
           }
         protected:
           CollisionType& collider;
@@ -27,9 +27,12 @@ namespace hemelb
           typedef CollisionImpl CollisionType;
           typedef typename CollisionType::CKernel::LatticeType LatticeType;
 
-          static inline site_t GetBBIndex(site_t siteIndex, int direction)
+          static inline site_t GetBBIndex(const geometry::LatticeData* const latticeData,
+                                          site_t siteIndex,
+                                          int direction)
           {
-            return (siteIndex * LatticeType::NUMVECTORS) + LatticeType::INVERSEDIRECTIONS[direction];
+            return latticeData->template GetDistributionIndex<LatticeType>(siteIndex,
+                                                                           LatticeType::INVERSEDIRECTIONS[direction]);
           }
 
           SimpleBounceBackDelegate(CollisionType& delegatorCollider, kernels::InitParams& initParams)
@@ -43,7 +46,9 @@ namespace hemelb
                                  const Direction& direction)
           {
             // Propagate the outgoing post-collisional f into the opposite direction.
-            * (latticeData->GetFNew(GetBBIndex(site.GetIndex(), direction))) = hydroVars.GetFPostCollision()[direction];
+            latticeData->WriteFNew(GetBBIndex(latticeData, site.GetIndex(), direction),
+                                   LatticeType::INVERSEDIRECTIONS[direction],
+                                   hydroVars.GetFPostCollision()[direction]);
           }
 
       };
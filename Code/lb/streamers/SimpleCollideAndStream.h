@@ -27,6 +27,7 @@ namespace hemelb
       {
         public:
           typedef CollisionImpl CollisionType;
+          static const bool ThreadSafe = true;
 
         private:
           CollisionType collider;
@@ -40,48 +41,147 @@ namespace hemelb
 
           }
 
+          inline CollisionType& GetCollision()
+          {
+            return collider;
+          }
+
           template<bool tDoRayTracing>
           inline void DoStreamAndCollide(const site_t firstIndex,
                                          const site_t siteCount,
                                          const LbmParameters* lbmParams,
                                          geometry::LatticeData* latDat,
                                          lb::MacroscopicPropertyCache& propertyCache)
+          {
+            StreamAndCollideSites<tDoRayTracing>(firstIndex,
+                                                 siteCount,
+                                                 lbmParams,
+                                                 latDat,
+                                                 propertyCache,
+                                                 MultiSiteSelector<UseMultiSite>());
+          }
+
+          template<bool tDoRayTracing>
+          inline void DoPostStep(const site_t iFirstIndex,
+                                 const site_t iSiteCount,
+                                 const LbmParameters* iLbmParams,
+                                 geometry::LatticeData* bLatDat,
+                                 lb::MacroscopicPropertyCache& propertyCache)
+          {
+
+          }
+
+        private:
+          //! Collide several sites at once when the collision supports it and the build asks for it.
+          static const bool UseMultiSite = CollisionType::MultiSite && (kernels::SimdWidth > 1);
+
+          template<bool tMultiSite>
+          struct MultiSiteSelector
+          {
+          };
+
+          template<bool tDoRayTracing>
+          inline void StreamAndCollideSites(const site_t firstIndex,
+                                            const site_t siteCount,
+                                            const LbmParameters* lbmParams,
+                                            geometry::LatticeData* latDat,
+                                            lb::MacroscopicPropertyCache& propertyCache,
+                                            MultiSiteSelector<false>)
           {
             for (site_t siteIndex = firstIndex; siteIndex < (firstIndex + siteCount); siteIndex++)
             {
-              geometry::Site<geometry::LatticeData> site = latDat->GetSite(siteIndex);
+              StreamAndCollideSite<tDoRayTracing>(siteIndex, lbmParams, latDat, propertyCache);
+            }
+          }
 
-              const distribn_t* lFOld = site.GetFOld<LatticeType> ();
+          /**
+           * Collides the sites kernels::SimdWidth at a time, then streams each site's
+           * post-collision distributions and updates the caches just as the single-site path
+           * does. Any sites left over at the end of the range take the single-site path.
+           */
+          template<bool tDoRayTracing>
+          inline void StreamAndCollideSites(const site_t firstIndex,
+                                            const site_t siteCount,
+                                            const LbmParameters* lbmParams,
+                                            geometry::LatticeData* latDat,
+                                            lb::MacroscopicPropertyCache& propertyCache,
+                                            MultiSiteSelector<true>)
+          {
+            const site_t multiSiteEnd = firstIndex + (siteCount / kernels::SimdWidth) * kernels::SimdWidth;
 
-              kernels::HydroVars<typename CollisionType::CKernel> hydroVars(lFOld);
+            site_t siteIndex = firstIndex;
+            for (; siteIndex < multiSiteEnd; siteIndex += kernels::SimdWidth)
+            {
+              distribn_t fOldBuffer[kernels::SimdWidth][LatticeType::NUMVECTORS];
+              const distribn_t* fOld[kernels::SimdWidth];
 
-              ///< @todo #126 This value of tau will be updated by some kernels within the collider code (e.g. LBGKNN). It would be nicer if tau is handled in a single place.
-              hydroVars.tau = lbmParams->GetTau();
+              kernels::MultiSiteHydroVars<LatticeType> multiSiteHydroVars;
+              for (unsigned lane = 0; lane < kernels::SimdWidth; ++lane)
+              {
+                geometry::Site<geometry::LatticeData> site = latDat->GetSite(siteIndex + lane);
+                fOld[lane] = site.GetFOld<LatticeType> (fOldBuffer[lane]);
+                multiSiteHydroVars.SetSiteF(lane, fOld[lane]);
+                multiSiteHydroVars.tau[lane] = lbmParams->GetTau();
+              }
 
-              collider.CalculatePreCollision(hydroVars, site);
+              collider.CalculatePreCollisionMultiSite(multiSiteHydroVars);
 
-              collider.Collide(lbmParams, hydroVars);
+              collider.CollideMultiSite(lbmParams, multiSiteHydroVars);
 
-              for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ii++)
+              for (unsigned lane = 0; lane < kernels::SimdWidth; ++lane)
               {
-                bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
+                geometry::Site<geometry::LatticeData> site = latDat->GetSite(siteIndex + lane);
+
+                kernels::HydroVars<typename CollisionType::CKernel> hydroVars(fOld[lane]);
+                multiSiteHydroVars.GetSiteHydroVars(lane, hydroVars);
+
+                for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ii++)
+                {
+                  bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
+                }
+
+                BaseStreamer<SimpleCollideAndStream>::template UpdateMinsAndMaxes<tDoRayTracing>(site,
+                                                                                                 hydroVars,
+                                                                                                 lbmParams,
+                                                                                                 propertyCache);
               }
+            }
 
-              BaseStreamer<SimpleCollideAndStream>::template UpdateMinsAndMaxes<tDoRayTracing>(site,
-                                                                                               hydroVars,
-                                                                                               lbmParams,
-                                                                                               propertyCache);
+            for (; siteIndex < (firstIndex + siteCount); siteIndex++)
+            {
+              StreamAndCollideSite<tDoRayTracing>(siteIndex, lbmParams, latDat, propertyCache);
             }
           }
 
           template<bool tDoRayTracing>
-          inline void DoPostStep(const site_t iFirstIndex,
-                                 const site_t iSiteCount,
-                                 const LbmParameters* iLbmParams,
-                                 geometry::LatticeData* bLatDat,
-                                 lb::MacroscopicPropertyCache& propertyCache)
+          inline void StreamAndCollideSite(const site_t siteIndex,
+                                           const LbmParameters* lbmParams,
+                                           geometry::LatticeData* latDat,
+                                           lb::MacroscopicPropertyCache& propertyCache)
           {
+            geometry::Site<geometry::LatticeData> site = latDat->GetSite(siteIndex);
+
+            distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+            const distribn_t* lFOld = site.GetFOld<LatticeType> (fOldBuffer);
+
+            kernels::HydroVars<typename CollisionType::CKernel> hydroVars(lFOld);
+
+            ///< @todo #126 This value of tau will be updated by some kernels within the collider code (e.g. LBGKNN). It would be nicer if tau is handled in a single place.
+            hydroVars.tau = lbmParams->GetTau();
+
+            collider.CalculatePreCollision(hydroVars, site);
+
+            collider.Collide(lbmParams, hydroVars);
+
+            for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ii++)
+            {
+              bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
+            }
 
+            BaseStreamer<SimpleCollideAndStream>::template UpdateMinsAndMaxes<tDoRayTracing>(site,
+                                                                                             hydroVars,
+                                                                                             lbmParams,
+                                                                                             propertyCache);
           }
 
       };
@@ -34,8 +34,9 @@ namespace hemelb
                                  kernels::HydroVars<typename CollisionType::CKernel>& hydroVars,
                                  const Direction& direction)
           {
-            * (latticeData->GetFNew(site.GetStreamedIndex<LatticeType> (direction)))
-                = hydroVars.GetFPostCollision()[direction];
+            latticeData->WriteFNew(site.GetStreamedIndex<LatticeType> (direction),
+                                   direction,
+                                   hydroVars.GetFPostCollision()[direction]);
           }
 
       };
@@ -33,6 +33,7 @@ namespace hemelb
       {
         public:
           typedef CollisionImpl CollisionType;
+          static const bool ThreadSafe = true;
 
         private:
           CollisionType collider;
@@ -48,6 +49,11 @@ namespace hemelb
 
           }
 
+          inline CollisionType& GetCollision()
+          {
+            return collider;
+          }
+
           template<bool tDoRayTracing>
           inline void DoStreamAndCollide(const site_t firstIndex,
                                          const site_t siteCount,
@@ -59,7 +65,8 @@ namespace hemelb
             {
               geometry::Site<geometry::LatticeData> site = latDat->GetSite(siteIndex);
 
-              const distribn_t* fOld = site.GetFOld<LatticeType> ();
+              distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+              const distribn_t* fOld = site.GetFOld<LatticeType> (fOldBuffer);
 
               kernels::HydroVars<typename CollisionType::CKernel> hydroVars(fOld);
 
@@ -124,6 +131,7 @@ namespace hemelb
       {
         public:
           typedef CollisionImpl CollisionType;
+          static const bool ThreadSafe = true;
 
         private:
           CollisionType collider;
@@ -139,6 +147,11 @@ namespace hemelb
 
           }
 
+          inline CollisionType& GetCollision()
+          {
+            return collider;
+          }
+
           template<bool tDoRayTracing>
           inline void DoStreamAndCollide(const site_t firstIndex,
                                          const site_t siteCount,
@@ -150,7 +163,8 @@ namespace hemelb
             {
               geometry::Site<geometry::LatticeData> site = latDat->GetSite(siteIndex);
 
-              const distribn_t* fOld = site.GetFOld<LatticeType> ();
+              distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+              const distribn_t* fOld = site.GetFOld<LatticeType> (fOldBuffer);
 
               kernels::HydroVars<typename CollisionType::CKernel> hydroVars(fOld);
 
@@ -217,6 +231,7 @@ namespace hemelb
       {
         public:
           typedef CollisionImpl CollisionType;
+          static const bool ThreadSafe = true;
           typedef typename CollisionType::CKernel::LatticeType LatticeType;
 
         private:
@@ -233,6 +248,11 @@ namespace hemelb
 
           }
 
+          inline CollisionType& GetCollision()
+          {
+            return collider;
+          }
+
           template<bool tDoRayTracing>
           inline void DoStreamAndCollide(const site_t firstIndex,
                                          const site_t siteCount,
@@ -244,7 +264,8 @@ namespace hemelb
             {
               geometry::Site<geometry::LatticeData> site = latDat->GetSite(siteIndex);
 
-              const distribn_t* fOld = site.GetFOld<LatticeType> ();
+              distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+              const distribn_t* fOld = site.GetFOld<LatticeType> (fOldBuffer);
 
               kernels::HydroVars<typename CollisionType::CKernel> hydroVars(fOld);
 
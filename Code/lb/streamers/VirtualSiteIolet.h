@@ -35,6 +35,8 @@ namespace hemelb
         public:
 
           typedef CollisionImpl CollisionType;
+          // The per-iolet caches of hydrodynamic variables are filled in as sites are visited.
+          static const bool ThreadSafe = false;
           typedef typename CollisionType::CKernel::LatticeType LatticeType;
 
         private:
@@ -95,7 +97,7 @@ namespace hemelb
                 const LatticeVector siteLocation = site.GetGlobalSiteCoords();
 
                 // Get the iolet
-                InOutLet& iolet = *bValues->GetLocalIolet(site.GetIoletId());
+                InOutLet& iolet = *bValues->GetIolet(site.GetIoletId());
 
                 // Get the extra data for this iolet
                 VSExtra<LatticeType>* extra = GetExtra(&iolet);
@@ -138,6 +140,11 @@ namespace hemelb
 
           }
 
+          inline CollisionType& GetCollision()
+          {
+            return collider;
+          }
+
           /*
            * Stream and collide as normal for bulk and wall links. The iolet
            * links will be done in the post-step as we must ensure that all
@@ -153,7 +160,8 @@ namespace hemelb
             {
               geometry::Site<geometry::LatticeData> site = latDat->GetSite(siteIndex);
 
-              const distribn_t* fOld = site.GetFOld<LatticeType> ();
+              distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+              const distribn_t* fOld = site.GetFOld<LatticeType> (fOldBuffer);
 
               kernels::HydroVars<typename CollisionType::CKernel> hydroVars(fOld);
 
@@ -183,7 +191,7 @@ namespace hemelb
                * Store the density and velocity for later use.
                */
               // Get the iolet
-              InOutLet* iolet = bValues->GetLocalIolet(site.GetIoletId());
+              InOutLet* iolet = bValues->GetIolet(site.GetIoletId());
 
               // Get the extra data for this iolet
               VSExtra<LatticeType>* extra = GetExtra(iolet);
@@ -226,7 +234,7 @@ namespace hemelb
               CalculateVirtualSiteDistributions(*latDat, *iolet, extra->hydroVarsCache, *vSite, t);
               // Stream this direction
               Direction i = vSiteIt->second.direction;
-              * (latDat->GetFNew(siteIdx * LatticeType::NUMVECTORS + i)) = vSite->hv.fPostColl[i];
+              latDat->WriteFNew(latDat->GetDistributionIndex<LatticeType>(siteIdx, i), i, vSite->hv.fPostColl[i]);
               //* (latticeData->GetFNew(GetBBIndex(site.GetIndex(), direction))) = hydroVars.GetFPostCollision()[direction];
               //return (siteIndex * LatticeType::NUMVECTORS) + LatticeType::INVERSEDIRECTIONS[direction];
             }
@@ -236,7 +244,7 @@ namespace hemelb
                                  const VirtualSiteIolet* ioletWallStreamer,
                                  const geometry::LatticeData* latDat)
           {
-            InOutLet* iolet = ioletStreamer->bValues->GetLocalIolet(0);
+            InOutLet* iolet = ioletStreamer->bValues->GetIolet(0);
             VSExtra<LatticeType>* extra = GetExtra(iolet);
 
             std::ofstream hvCache("hvCache");
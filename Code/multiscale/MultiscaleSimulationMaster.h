@@ -37,14 +37,20 @@ namespace hemelb
           hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::OnePerCore>("CONSTRUCTOR: inlet and outlet count: %d and %d",
                                                                                inletValues->GetLocalIoletCount(),
                                                                                outletValues->GetLocalIoletCount());
-          hemelb::log::Logger::Log<hemelb::log::Warning, hemelb::log::OnePerCore>("inlets: %d",
-                                                                                  inletValues->GetLocalIolet(0)->IsCommsRequired(),
-                                                                                  inletValues->GetLocalIolet(0)->GetDensityMax(),
-                                                                                  inletValues->GetLocalIolet(0)->GetPressureMax());
-          hemelb::log::Logger::Log<hemelb::log::Warning, hemelb::log::OnePerCore>("outlets: %d",
-                                                                                  outletValues->GetLocalIolet(0)->IsCommsRequired(),
-                                                                                  outletValues->GetLocalIolet(0)->GetDensityMax(),
-                                                                                  outletValues->GetLocalIolet(0)->GetPressureMax());
+          if (inletValues->GetLocalIoletCount() > 0)
+          {
+            hemelb::log::Logger::Log<hemelb::log::Warning, hemelb::log::OnePerCore>("inlets: %d",
+                                                                                    inletValues->GetLocalIolet(0)->IsCommsRequired(),
+                                                                                    inletValues->GetLocalIolet(0)->GetDensityMax(),
+                                                                                    inletValues->GetLocalIolet(0)->GetPressureMax());
+          }
+          if (outletValues->GetLocalIoletCount() > 0)
+          {
+            hemelb::log::Logger::Log<hemelb::log::Warning, hemelb::log::OnePerCore>("outlets: %d",
+                                                                                    outletValues->GetLocalIolet(0)->IsCommsRequired(),
+                                                                                    outletValues->GetLocalIolet(0)->GetDensityMax(),
+                                                                                    outletValues->GetLocalIolet(0)->GetPressureMax());
+          }
 
           // we only want to register those iolets which are needed on this process.
           // Fortunately, the BoundaryValues instance has worked this out for us.
@@ -235,14 +241,20 @@ namespace hemelb
             hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("inlet and outlet count: %d and %d",
                                                                                   inletValues->GetLocalIoletCount(),
                                                                                   outletValues->GetLocalIoletCount());
-            hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("inlets: %d",
-                                                                                  inletValues->GetLocalIolet(0)->IsCommsRequired(),
-                                                                                  inletValues->GetLocalIolet(0)->GetDensityMax(),
-                                                                                  inletValues->GetLocalIolet(0)->GetPressureMax());
-            hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("outlets: %d",
-                                                                                  outletValues->GetLocalIolet(0)->IsCommsRequired(),
-                                                                                  outletValues->GetLocalIolet(0)->GetDensityMax(),
-                                                                                  outletValues->GetLocalIolet(0)->GetPressureMax());
+            if (inletValues->GetLocalIoletCount() > 0)
+            {
+              hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("inlets: %d",
+                                                                                    inletValues->GetLocalIolet(0)->IsCommsRequired(),
+                                                                                    inletValues->GetLocalIolet(0)->GetDensityMax(),
+                                                                                    inletValues->GetLocalIolet(0)->GetPressureMax());
+            }
+            if (outletValues->GetLocalIoletCount() > 0)
+            {
+              hemelb::log::Logger::Log<hemelb::log::Debug, hemelb::log::OnePerCore>("outlets: %d",
+                                                                                    outletValues->GetLocalIolet(0)->IsCommsRequired(),
+                                                                                    outletValues->GetLocalIolet(0)->GetDensityMax(),
+                                                                                    outletValues->GetLocalIolet(0)->GetPressureMax());
+            }
 
             SetCommsRequired(inletValues, true);
             SetCommsRequired(outletValues, true);
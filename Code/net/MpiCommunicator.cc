@@ -7,7 +7,9 @@
 // specifically made by you with University College London.
 //
 
+#include <limits>
 #include "net/MpiCommunicator.h"
+#include "Exception.h"
 #include "net/MpiGroup.h"
 
 namespace hemelb
@@ -114,5 +116,15 @@ namespace hemelb
       HEMELB_MPI_CALL(MPI_Comm_dup, (*commPtr, &newComm));
       return MpiCommunicator(newComm, true);
     }
+
+    int MpiCommunicator::AddCounts(int count1, int count2)
+    {
+      if (count2 > std::numeric_limits<int>::max() - count1)
+      {
+        throw Exception() << "Too much data for one MPI collective: " << count1 << " + " << count2
+            << " values overflows an int";
+      }
+      return count1 + count2;
+    }
   }
 }
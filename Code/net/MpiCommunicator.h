@@ -106,6 +106,15 @@ namespace hemelb
         template <typename T>
         std::vector<T> Reduce(const std::vector<T>& vals, const MPI_Op& op, const int root) const;
 
+        /**
+         * Combine the values on all lower ranks - see MPI_EXSCAN.
+         * @param val
+         * @param op
+         * @return the result on the ranks below this one, or T() on the first rank
+         */
+        template <typename T>
+        T ExclusiveScan(const T& val, const MPI_Op& op) const;
+
         template <typename T>
         std::vector<T> Gather(const T& val, const int root) const;
 
@@ -115,6 +124,17 @@ namespace hemelb
         template <typename T>
         std::vector<T> AllToAll(const std::vector<T>& vals) const;
 
+        /**
+         * Exchange variable amounts of data between all ranks - see MPI_ALLTOALLV.
+         * @param vals the values to send, grouped by destination rank
+         * @param sendCounts the number of values for each rank
+         * @param receiveCounts set to the number of values received from each rank
+         * @return the values received, grouped by source rank
+         */
+        template <typename T>
+        std::vector<T> AllToAllV(const std::vector<T>& vals, const std::vector<int>& sendCounts,
+                                 std::vector<int>& receiveCounts) const;
+
         template <typename T>
         void Send(const T& val, int dest, int tag=0) const;
         template <typename T>
@@ -132,6 +152,15 @@ namespace hemelb
          */
         MpiCommunicator(MPI_Comm communicator, bool willOwn);
 
+        /**
+         * Add two counts or displacements of a variable-sized collective, which MPI takes as
+         * ints, throwing if the sum doesn't fit in one.
+         * @param count1
+         * @param count2
+         * @return
+         */
+        static int AddCounts(int count1, int count2);
+
         boost::shared_ptr<MPI_Comm> commPtr;
     };
 
@@ -87,6 +87,22 @@ namespace hemelb
       return ans;
     }
 
+    template<typename T>
+    T MpiCommunicator::ExclusiveScan(const T& val, const MPI_Op& op) const
+    {
+      T ans = T();
+      HEMELB_MPI_CALL(
+          MPI_Exscan,
+          (MpiConstCast(&val), &ans, 1, MpiDataType<T>(), op, *this)
+      );
+      // The result is undefined on the first rank.
+      if (Rank() == 0)
+      {
+        ans = T();
+      }
+      return ans;
+    }
+
     template<typename T>
     std::vector<T> MpiCommunicator::Gather(const T& val, const int root) const
     {
@@ -136,6 +152,31 @@ namespace hemelb
       return ans;
     }
 
+    template <typename T>
+    std::vector<T> MpiCommunicator::AllToAllV(const std::vector<T>& vals, const std::vector<int>& sendCounts,
+                                              std::vector<int>& receiveCounts) const
+    {
+      receiveCounts = AllToAll(sendCounts);
+
+      std::vector<int> sendDisplacements(Size(), 0);
+      std::vector<int> receiveDisplacements(Size(), 0);
+      for (int rank = 1; rank < Size(); ++rank)
+      {
+        sendDisplacements[rank] = AddCounts(sendDisplacements[rank - 1], sendCounts[rank - 1]);
+        receiveDisplacements[rank] = AddCounts(receiveDisplacements[rank - 1], receiveCounts[rank - 1]);
+      }
+
+      std::vector<T> ans(AddCounts(receiveDisplacements[Size() - 1], receiveCounts[Size() - 1]));
+      HEMELB_MPI_CALL(
+          MPI_Alltoallv,
+          (MpiConstCast(vals.empty() ? NULL : &vals[0]), MpiConstCast(&sendCounts[0]),
+           MpiConstCast(&sendDisplacements[0]), MpiDataType<T>(),
+           ans.empty() ? NULL : &ans[0], &receiveCounts[0], &receiveDisplacements[0], MpiDataType<T>(),
+           *this)
+      );
+      return ans;
+    }
+
     template <typename T>
     void MpiCommunicator::Send(const T& val, int dest, int tag) const
     {
@@ -6,6 +6,7 @@
 // file, or any part thereof, other than as allowed by any agreement
 // specifically made by you with University College London.
 //
+#include <iostream>
 #include <mpi.h>
 
 #include "net/MpiEnvironment.h"
@@ -22,7 +23,20 @@ namespace hemelb
     {
       if (!Initialized())
       {
+#ifdef HEMELB_USE_OPENMP
+        // Only the master thread makes MPI calls; the other threads just share the LB work.
+        int provided;
+        HEMELB_MPI_CALL(MPI_Init_thread, (&argc, &argv, MPI_THREAD_FUNNELED, &provided));
+        if (provided < MPI_THREAD_FUNNELED)
+        {
+          // The logger isn't up yet, and nothing can safely carry on, so report and stop here.
+          std::cerr << "HemeLB was built with OpenMP, which needs MPI_THREAD_FUNNELED, but the MPI "
+              << "library only provides thread support level " << provided << std::endl;
+          HEMELB_MPI_CALL(MPI_Abort, (MPI_COMM_WORLD, -1));
+        }
+#else
         HEMELB_MPI_CALL(MPI_Init, (&argc, &argv));
+#endif
         HEMELB_MPI_CALL(MPI_Comm_set_errhandler, (MPI_COMM_WORLD, MPI_ERRORS_RETURN));
         doesOwnMpi = true;
       }
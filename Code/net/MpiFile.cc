@@ -71,6 +71,18 @@ namespace hemelb
           (*filePtr, disp, etype, filetype, MpiConstCast(datarep.c_str()), info)
       );
     }
+
+    MPI_Offset MpiFile::GetSize() const
+    {
+      MPI_Offset size;
+      HEMELB_MPI_CALL(MPI_File_get_size, (*filePtr, &size));
+      return size;
+    }
+
+    void MpiFile::SetSize(MPI_Offset size)
+    {
+      HEMELB_MPI_CALL(MPI_File_set_size, (*filePtr, size));
+    }
   }
 }
 
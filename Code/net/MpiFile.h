@@ -48,6 +48,19 @@ namespace hemelb
 
         void SetView(MPI_Offset disp, MPI_Datatype etype, MPI_Datatype filetype, const std::string& datarep, MPI_Info info);
 
+        /**
+         * The current size of the file in bytes, from MPI_File_get_size.
+         * @return
+         */
+        MPI_Offset GetSize() const;
+
+        /**
+         * Truncate or extend the file to the given size in bytes, with MPI_File_set_size.
+         * Collective.
+         * @param size
+         */
+        void SetSize(MPI_Offset size);
+
         const MpiCommunicator& GetCommunicator() const;
 
         template<typename T>
@@ -55,10 +68,15 @@ namespace hemelb
         template<typename T>
         void ReadAt(MPI_Offset offset, std::vector<T>& buffer, MPI_Status* stat = MPI_STATUS_IGNORE);
 
+        template<typename T>
+        void ReadAtAll(MPI_Offset offset, std::vector<T>& buffer, MPI_Status* stat = MPI_STATUS_IGNORE);
+
         template<typename T>
         void Write(const std::vector<T>& buffer, MPI_Status* stat = MPI_STATUS_IGNORE);
         template<typename T>
         void WriteAt(MPI_Offset offset, const std::vector<T>& buffer, MPI_Status* stat = MPI_STATUS_IGNORE);
+        template<typename T>
+        void WriteAtAll(MPI_Offset offset, const std::vector<T>& buffer, MPI_Status* stat = MPI_STATUS_IGNORE);
       protected:
         MpiFile(const MpiCommunicator& parentComm, MPI_File fh);
 
@@ -33,6 +33,15 @@ namespace hemelb
           (*filePtr, offset, &buffer[0], buffer.size(), MpiDataType<T>(), stat)
       );
     }
+    template<typename T>
+    void MpiFile::ReadAtAll(MPI_Offset offset, std::vector<T>& buffer, MPI_Status* stat)
+    {
+      // Every rank must take part, even those with nothing to read.
+      HEMELB_MPI_CALL(
+          MPI_File_read_at_all,
+          (*filePtr, offset, buffer.empty() ? NULL : &buffer[0], buffer.size(), MpiDataType<T>(), stat)
+      );
+    }
 
     template<typename T>
     void MpiFile::Write(const std::vector<T>& buffer, MPI_Status* stat)
@@ -51,6 +60,15 @@ namespace hemelb
       );
 
     }
+    template<typename T>
+    void MpiFile::WriteAtAll(MPI_Offset offset, const std::vector<T>& buffer, MPI_Status* stat)
+    {
+      // Every rank must take part, even those with nothing to write.
+      HEMELB_MPI_CALL(
+          MPI_File_write_at_all,
+          (*filePtr, offset, MpiConstCast(buffer.empty() ? NULL : &buffer[0]), buffer.size(), MpiDataType<T>(), stat)
+      );
+    }
 
   }
 }
@@ -0,0 +1,199 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+
+#include "net/PersistentRequests.h"
+#include "net/MpiError.h"
+#include "Exception.h"
+
+namespace hemelb
+{
+  namespace net
+  {
+    PersistentRequests::PersistentRequests(const MpiCommunicator& communicator, int tag, bool pack) :
+        communicator(communicator), tag(tag), pack(pack), created(false)
+    {
+    }
+
+    PersistentRequests::~PersistentRequests()
+    {
+      // Only free MPI objects that still exist: the requests may outlive MPI_Finalize.
+      int finalized;
+      MPI_Finalized(&finalized);
+      if (finalized)
+      {
+        return;
+      }
+
+      for (std::vector<MPI_Request>::iterator it = requests.begin(); it != requests.end(); ++it)
+      {
+        if (*it != MPI_REQUEST_NULL)
+        {
+          HEMELB_MPI_CALL(MPI_Request_free, (&*it));
+        }
+      }
+
+      if (created && !pack)
+      {
+        for (std::vector<Channel>::iterator it = sendChannels.begin(); it != sendChannels.end(); ++it)
+        {
+          HEMELB_MPI_CALL(MPI_Type_free, (&it->Requests.Type));
+        }
+        for (std::vector<Channel>::iterator it = receiveChannels.begin(); it != receiveChannels.end(); ++it)
+        {
+          HEMELB_MPI_CALL(MPI_Type_free, (&it->Requests.Type));
+        }
+      }
+    }
+
+    void PersistentRequests::RequestSendImpl(void* pointer, int count, proc_t rank, MPI_Datatype type)
+    {
+      if (created)
+      {
+        throw Exception() << "Persistent requests can't be added to once started";
+      }
+      if (count > 0)
+      {
+        sendComms[rank].push_back(SimpleRequest(pointer, count, type, rank));
+      }
+    }
+
+    void PersistentRequests::RequestReceiveImpl(void* pointer, int count, proc_t rank, MPI_Datatype type)
+    {
+      if (created)
+      {
+        throw Exception() << "Persistent requests can't be added to once started";
+      }
+      if (count > 0)
+      {
+        receiveComms[rank].push_back(SimpleRequest(pointer, count, type, rank));
+      }
+    }
+
+    void PersistentRequests::StartReceives()
+    {
+      EnsureCreated();
+
+      if (!receiveChannels.empty())
+      {
+        HEMELB_MPI_CALL(MPI_Startall, ((int) receiveChannels.size(), &requests[0]));
+      }
+    }
+
+    void PersistentRequests::StartSends()
+    {
+      EnsureCreated();
+
+      if (pack)
+      {
+        for (std::vector<Channel>::iterator it = sendChannels.begin(); it != sendChannels.end(); ++it)
+        {
+          it->Requests.Pack(it->Buffer, communicator);
+        }
+      }
+
+      if (!sendChannels.empty())
+      {
+        HEMELB_MPI_CALL(MPI_Startall, ((int) sendChannels.size(), &requests[receiveChannels.size()]));
+      }
+    }
+
+    void PersistentRequests::Wait()
+    {
+      if (!requests.empty())
+      {
+        HEMELB_MPI_CALL(MPI_Waitall, ((int) requests.size(), &requests[0], &statuses[0]));
+      }
+
+      if (pack)
+      {
+        for (std::vector<Channel>::iterator it = receiveChannels.begin(); it != receiveChannels.end(); ++it)
+        {
+          it->Requests.Unpack(it->Buffer, communicator);
+        }
+      }
+    }
+
+    void PersistentRequests::EnsureCreated()
+    {
+      if (created)
+      {
+        return;
+      }
+      created = true;
+
+      CreateChannels(receiveComms, receiveChannels);
+      CreateChannels(sendComms, sendChannels);
+
+      size_t receiveCount = receiveChannels.size();
+      requests.resize(receiveCount + sendChannels.size(), MPI_REQUEST_NULL);
+      statuses.resize(requests.size(), MPI_Status());
+
+      // Only set up the requests once the channels are in place, as they point into them.
+      for (size_t ii = 0; ii < requests.size(); ++ii)
+      {
+        bool isReceive = ii < receiveCount;
+        Channel& channel = isReceive ?
+          receiveChannels[ii] :
+          sendChannels[ii - receiveCount];
+
+        void* buffer;
+        int count;
+        MPI_Datatype type;
+        if (pack)
+        {
+          buffer = channel.Buffer.empty() ?
+            NULL :
+            &channel.Buffer[0];
+          count = channel.Bytes;
+          type = MPI_PACKED;
+        }
+        else
+        {
+          buffer = channel.Requests.front().Pointer;
+          count = 1;
+          type = channel.Requests.Type;
+        }
+
+        if (isReceive)
+        {
+          HEMELB_MPI_CALL(MPI_Recv_init, (buffer, count, type, channel.Rank, tag, communicator, &requests[ii]));
+        }
+        else
+        {
+          HEMELB_MPI_CALL(MPI_Send_init, (buffer, count, type, channel.Rank, tag, communicator, &requests[ii]));
+        }
+      }
+    }
+
+    void PersistentRequests::CreateChannels(const std::map<proc_t, ProcComms>& comms,
+                                            std::vector<Channel>& channels)
+    {
+      channels.resize(comms.size());
+
+      std::vector<Channel>::iterator channel = channels.begin();
+      for (std::map<proc_t, ProcComms>::const_iterator it = comms.begin(); it != comms.end(); ++it, ++channel)
+      {
+        channel->Rank = it->first;
+        channel->Requests = it->second;
+
+        if (pack)
+        {
+          channel->Bytes = channel->Requests.GetPackedSize(communicator);
+          channel->Buffer.resize(channel->Bytes);
+        }
+        else
+        {
+          channel->Requests.CreateMPIType();
+          HEMELB_MPI_CALL(MPI_Type_size, (channel->Requests.Type, &channel->Bytes));
+        }
+      }
+    }
+  }
+}
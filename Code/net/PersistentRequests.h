@@ -0,0 +1,133 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+
+#ifndef HEMELB_NET_PERSISTENTREQUESTS_H
+#define HEMELB_NET_PERSISTENTREQUESTS_H
+
+#include <map>
+#include <vector>
+#include "constants.h"
+#include "net/mpi.h"
+#include "net/MpiCommunicator.h"
+#include "net/MpiDataType.h"
+#include "net/ProcComms.h"
+
+namespace hemelb
+{
+  namespace net
+  {
+#ifdef HEMELB_PACK_POINTPOINT
+    static const bool pack_point_point = true;
+#else
+    static const bool pack_point_point = false;
+#endif
+
+    /**
+     * A fixed set of point-to-point messages, exchanged again and again through persistent
+     * requests (MPI_Send_init / MPI_Recv_init, restarted each time with MPI_Startall).
+     *
+     * For a client, such as the halo exchange, that makes the same sends and receives on every
+     * step. It requests them once, as it would of a net, and the persistent requests are set up
+     * the first time they are started; from then on the requests are fixed. Everything else
+     * still goes through the net, so a tag not used by the net must be given.
+     *
+     * There is one message per rank, described either by an MPI struct type over the client's
+     * buffers or, if packing, by a contiguous buffer which is packed before sending and
+     * unpacked after receiving. Packing is always through MPI_Pack and MPI_Unpack, as the two
+     * ends of a message may describe it with different types (e.g. a contiguous range on the
+     * sender and an indexed type on the receiver).
+     */
+    class PersistentRequests
+    {
+      public:
+        PersistentRequests(const MpiCommunicator& communicator, int tag, bool pack = pack_point_point);
+        ~PersistentRequests();
+
+        template<class T>
+        void RequestSend(T* pointer, int count, proc_t rank)
+        {
+          RequestSendImpl(pointer, count, rank, MpiDataType<T>());
+        }
+
+        template<class T>
+        void RequestReceive(T* pointer, int count, proc_t rank)
+        {
+          RequestReceiveImpl(pointer, count, rank, MpiDataType<T>());
+        }
+
+        /**
+         * Request a receive of a datatype the caller has built and committed, e.g. one that
+         * scatters the message into place. The type must outlive these requests.
+         */
+        void RequestReceive(void* pointer, int count, proc_t rank, MPI_Datatype type)
+        {
+          RequestReceiveImpl(pointer, count, rank, type);
+        }
+
+        /**
+         * Start the receives, setting up the persistent requests if this is the first time.
+         */
+        void StartReceives();
+
+        /**
+         * Start the sends, once the data to send is in place.
+         */
+        void StartSends();
+
+        /**
+         * Wait for the sends and receives to complete.
+         */
+        void Wait();
+
+      private:
+        /**
+         * The persistent message to or from one rank.
+         */
+        class Channel
+        {
+          public:
+            proc_t Rank;
+            //! The requests the message was set up for.
+            ProcComms Requests;
+            //! Packed form of the message, if packing.
+            std::vector<char> Buffer;
+            //! Size of the message in bytes.
+            int Bytes;
+        };
+
+        // Copying would leave two objects freeing the same requests.
+        PersistentRequests(const PersistentRequests& other);
+        PersistentRequests& operator=(const PersistentRequests& other);
+
+        void RequestSendImpl(void* pointer, int count, proc_t rank, MPI_Datatype type);
+        void RequestReceiveImpl(void* pointer, int count, proc_t rank, MPI_Datatype type);
+
+        void EnsureCreated();
+        void CreateChannels(const std::map<proc_t, ProcComms>& comms, std::vector<Channel>& channels);
+
+        const MpiCommunicator& communicator;
+        const int tag;
+        //! Whether to send packed buffers rather than MPI struct types.
+        const bool pack;
+
+        std::map<proc_t, ProcComms> sendComms;
+        std::map<proc_t, ProcComms> receiveComms;
+
+        std::vector<Channel> sendChannels;
+        std::vector<Channel> receiveChannels;
+        //! The persistent requests, those for receives first. Empty until first started.
+        std::vector<MPI_Request> requests;
+        std::vector<MPI_Status> statuses;
+        bool created;
+    };
+  }
+}
+
+#endif // HEMELB_NET_PERSISTENTREQUESTS_H
@@ -171,6 +171,21 @@ namespace hemelb
           }
         }
 
+        /**
+         * Whether this node sends to its parent, and so calls PostSendToParent, on the current
+         * iteration. Lets the caller prepare the local data that PostSendToParent uses only on
+         * the iterations that need it.
+         */
+        bool IsSendingToParent()
+        {
+          const unsigned long iCycleNumber = Get0IndexedIterationNumber();
+          const unsigned long firstAscent = base::GetFirstAscending();
+          unsigned long sendOverlap;
+
+          return goUp && iCycleNumber >= firstAscent
+              && base::GetSendParentOverlap(iCycleNumber - firstAscent, &sendOverlap);
+        }
+
         /**
          * Returns the number of the iteration, as an integer between inclusive-0 and
          * exclusive-2 * (the tree depth)
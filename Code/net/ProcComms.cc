@@ -8,6 +8,7 @@
 // 
 
 #include "net/ProcComms.h"
+#include "net/MpiError.h"
 namespace hemelb
 {
   namespace net
@@ -36,5 +37,37 @@ namespace hemelb
       MPI_Type_create_struct(this->size(), &lengths.front(), &displacements.front(), &types.front(), &Type);
       MPI_Type_commit(&Type);
     }
+
+    int ProcComms::GetPackedSize(MPI_Comm comm) const
+    {
+      int total = 0;
+      for (const_iterator it = begin(); it != end(); ++it)
+      {
+        int size;
+        HEMELB_MPI_CALL(MPI_Pack_size, (it->Count, it->Type, comm, &size));
+        total += size;
+      }
+      return total;
+    }
+
+    void ProcComms::Pack(std::vector<char>& buffer, MPI_Comm comm) const
+    {
+      int position = 0;
+      for (const_iterator it = begin(); it != end(); ++it)
+      {
+        HEMELB_MPI_CALL(MPI_Pack,
+                        (it->Pointer, it->Count, it->Type, &buffer[0], (int) buffer.size(), &position, comm));
+      }
+    }
+
+    void ProcComms::Unpack(std::vector<char>& buffer, MPI_Comm comm) const
+    {
+      int position = 0;
+      for (const_iterator it = begin(); it != end(); ++it)
+      {
+        HEMELB_MPI_CALL(MPI_Unpack,
+                        (&buffer[0], (int) buffer.size(), &position, it->Pointer, it->Count, it->Type, comm));
+      }
+    }
   }
 }
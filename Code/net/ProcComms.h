@@ -30,6 +30,28 @@ namespace hemelb
     {
       public:
         void CreateMPIType();
+
+        /**
+         * The number of bytes needed to hold all the requests packed one after the other.
+         * @param comm the communicator the packed buffer will be sent over
+         * @return
+         */
+        int GetPackedSize(MPI_Comm comm) const;
+
+        /**
+         * MPI_Pack the data of all the requests into the contiguous buffer, which must have at
+         * least GetPackedSize() bytes.
+         *
+         * Always MPI_Pack, even when the requests' types are contiguous: the other end may
+         * describe the same data with non-contiguous types and unpack it with MPI_Unpack, which
+         * only has to understand what MPI_Pack produced.
+         */
+        void Pack(std::vector<char>& buffer, MPI_Comm comm) const;
+
+        /**
+         * MPI_Unpack the contiguous buffer, as filled by Pack at either end, out to the requests.
+         */
+        void Unpack(std::vector<char>& buffer, MPI_Comm comm) const;
     };
 
     class GatherProcComms : public BaseProcComms<ScalarRequest>
@@ -140,6 +140,15 @@ namespace hemelb
           RequestReceiveImpl(pointer, count, rank, MpiDataType<T>());
         }
 
+        /**
+         * Request a receive of a datatype the caller has built and committed, e.g. one that
+         * scatters the message into place. The type must outlive the communication.
+         */
+        void RequestReceive(void* pointer, int count, proc_t rank, MPI_Datatype type)
+        {
+          RequestReceiveImpl(pointer, count, rank, type);
+        }
+
         /*
          * Blocking gathers are implemented in MPI as a single call for both send/receive
          * But, here we separate send and receive parts, since this interface may one day be used for
@@ -7,6 +7,7 @@
 // specifically made by you with University College London.
 // 
 
+#include <algorithm>
 #include "reporting/Reporter.h"
 
 namespace hemelb
@@ -29,6 +30,12 @@ namespace hemelb
       reportableObjects.push_back(reportable);
     }
 
+    void Reporter::RemoveReportable(Reportable* reportable)
+    {
+      reportableObjects.erase(std::remove(reportableObjects.begin(), reportableObjects.end(), reportable),
+                              reportableObjects.end());
+    }
+
     void Reporter::Write(const std::string &ctemplate, const std::string &as)
     {
       std::string output;
@@ -46,6 +46,7 @@ namespace hemelb
         void Image(); //! Inform the reporter that an image has been saved.
 
         void AddReportable(Reportable* reportable);
+        void RemoveReportable(Reportable* reportable); //! Stop reporting on an object that is about to be deleted.
 
         void WriteXML()
         {
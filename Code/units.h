@@ -28,6 +28,87 @@ namespace hemelb
   typedef unsigned Direction;
   typedef uint64_t sitedata_t;
 
+  namespace precision
+  {
+    /**
+     * The following classes describe how the velocity distributions are stored in the fOld / fNew
+     * arrays and the halo buffers. Their names must correspond to the options given for the CMake
+     * HEMELB_DISTRIBUTION_PRECISION parameter. Arithmetic on the distributions is always done in
+     * distribn_t.
+     *
+     * Each provides
+     *  - Storage, the type of the stored values,
+     *  - StorageIsArithmetic, true if Storage is distribn_t and values are stored unchanged, so
+     *      that stored distributions can be used in place,
+     *  - Store(value, restEquilibrium) and Load(stored, restEquilibrium), converting between
+     *      the two, given the rest equilibrium (the lattice weight) for the distribution's
+     *      direction.
+     */
+    struct DOUBLE
+    {
+        typedef double Storage;
+        static const bool StorageIsArithmetic = true;
+
+        inline static Storage Store(distribn_t value, distribn_t restEquilibrium)
+        {
+          return value;
+        }
+
+        inline static distribn_t Load(Storage stored, distribn_t restEquilibrium)
+        {
+          return stored;
+        }
+    };
+
+    /**
+     * Single precision storage, which halves the memory traffic of streaming and of the halo
+     * exchange.
+     */
+    struct SINGLE
+    {
+        typedef float Storage;
+        static const bool StorageIsArithmetic = false;
+
+        inline static Storage Store(distribn_t value, distribn_t restEquilibrium)
+        {
+          return (Storage) value;
+        }
+
+        inline static distribn_t Load(Storage stored, distribn_t restEquilibrium)
+        {
+          return stored;
+        }
+    };
+
+    /**
+     * Single precision storage of the difference from the rest equilibrium. At low Mach number
+     * the distributions differ from the lattice weights by a small amount, which is then stored
+     * with the full relative precision of a float rather than losing digits to the weight.
+     */
+    struct MIXED
+    {
+        typedef float Storage;
+        static const bool StorageIsArithmetic = false;
+
+        inline static Storage Store(distribn_t value, distribn_t restEquilibrium)
+        {
+          return (Storage) (value - restEquilibrium);
+        }
+
+        inline static distribn_t Load(Storage stored, distribn_t restEquilibrium)
+        {
+          return stored + restEquilibrium;
+        }
+    };
+  }
+
+#ifndef HEMELB_DISTRIBUTION_PRECISION
+#define HEMELB_DISTRIBUTION_PRECISION DOUBLE
+#endif
+  // Use the storage precision specified through the build system.
+  typedef precision::HEMELB_DISTRIBUTION_PRECISION DistributionPrecision;
+  typedef DistributionPrecision::Storage distribn_storage_t;
+
   // ------- NEW POLICY -------------
   // Types should reflect the meaning of a quantity as well as the precision
   // the type name should reflect the dimensionality and the base of the units
@@ -81,6 +162,10 @@ namespace hemelb
   typedef double PhysicalPressureGradient;
   typedef double LatticePressureGradient;
 
+  typedef double LatticeFlowRate; // volume per time step, in lattice units
+  typedef double LatticeResistance; // pressure difference per flow rate, in lattice units
+  typedef double LatticeCompliance; // volume per pressure difference, in lattice units
+
   typedef double Dimensionless;
 }
 #endif //HEMELB_UNITS_H
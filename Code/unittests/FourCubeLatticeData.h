@@ -70,8 +70,11 @@ namespace hemelb
           site_t sitesAlongCube = sitesPerBlockUnit - 2;
           site_t minInd = 1, maxInd = sitesAlongCube;
 
+          readResult.ReserveSiteStorage(1,
+                                        sitesAlongCube * sitesAlongCube * sitesAlongCube,
+                                        lb::lattices::D3Q15::NUMVECTORS - 1);
+          readResult.AllocateBlockSites(0);
           hemelb::geometry::BlockReadResult& block = readResult.Blocks[0];
-          block.Sites.resize(readResult.GetSitesPerBlock(), geometry::GeometrySite(false));
 
           site_t index = -1;
           for (site_t i = 0; i < sitesPerBlockUnit; ++i)
@@ -90,6 +93,7 @@ namespace hemelb
 
                 site.isFluid = true;
                 site.targetProcessor = 0;
+                site.links = readResult.AllocateLinks(lb::lattices::D3Q15::NUMVECTORS - 1);
 
                 for (Direction direction = 1; direction < lb::lattices::D3Q15::NUMVECTORS; ++direction)
                 {
@@ -122,7 +126,7 @@ namespace hemelb
                     link.distanceToIntersection = randomDistance;
                   }
 
-                  site.links.push_back(link);
+                  site.links[direction - 1] = link;
 
                 }
 
@@ -226,7 +230,7 @@ namespace hemelb
         {
           for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
           {
-            *GetFOld(site * LatticeType::NUMVECTORS + direction) = fOldIn[direction];
+            WriteFOld(GetDistributionIndex<LatticeType>(site, direction), direction, fOldIn[direction]);
           }
         }
 
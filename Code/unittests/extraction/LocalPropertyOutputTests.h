@@ -34,7 +34,8 @@ namespace hemelb
       {
           CPPUNIT_TEST_SUITE (LocalPropertyOutputTests);
           CPPUNIT_TEST (TestStringWrittenLength);
-          CPPUNIT_TEST (TestWrite);CPPUNIT_TEST_SUITE_END();
+          CPPUNIT_TEST (TestWrite);
+          CPPUNIT_TEST (TestAppend);CPPUNIT_TEST_SUITE_END();
 
         public:
           void setUp()
@@ -191,8 +192,38 @@ namespace hemelb
             CheckDataWriting(simpleDataSource, 100, writtenFile);
           }
 
+          void TestAppend()
+          {
+            // Write one iteration, then close the file as happens before a rebalance.
+            propertyWriter = new hemelb::extraction::LocalPropertyOutput(*simpleDataSource, &simpleOutFile, Comms());
+            simpleDataSource->FillFields();
+            propertyWriter->Write(0);
+            delete propertyWriter;
+
+            // Reopening must continue after the existing iteration rather than fail or rewrite it.
+            propertyWriter = new hemelb::extraction::LocalPropertyOutput(*simpleDataSource,
+                                                                         &simpleOutFile,
+                                                                         Comms(),
+                                                                         true);
+            propertyWriter->Write(100);
+
+            writtenFile = std::fopen(simpleOutFile.filename.c_str(), "r");
+            CPPUNIT_ASSERT(writtenFile != NULL);
+
+            // Skip the headers, which were checked in TestWrite.
+            CPPUNIT_ASSERT_EQUAL(0,
+                                 std::fseek(writtenFile,
+                                            hemelb::io::formats::extraction::MainHeaderLength
+                                                + fieldHeaderLength,
+                                            SEEK_SET));
+
+            CheckDataWriting(simpleDataSource, 0, writtenFile, false);
+            CheckDataWriting(simpleDataSource, 100, writtenFile);
+          }
+
         private:
-          void CheckDataWriting(DummyDataSource* datasource, uint64_t timestep, FILE* file)
+          void CheckDataWriting(DummyDataSource* datasource, uint64_t timestep, FILE* file,
+                                bool lastRecord = true)
           {
             // The file should have an entry for each lattice point, consisting
             // of 3D grid coords, pressure (with an offset of 80) and 3D velocity.
@@ -207,9 +238,12 @@ namespace hemelb
             // We also have the iteration number, a long
             size_t expectedSize = 8 + 28 * siteCount;
 
-            // Attempt to read one extra byte, to make sure we aren't under-reading
-            char* contentsBuffer = new char[expectedSize];
-            size_t nRead = std::fread(contentsBuffer, 1, expectedSize + 1, file);
+            // Attempt to read one extra byte from the last record, to make sure we aren't
+            // under-reading
+            char* contentsBuffer = new char[expectedSize + 1];
+            size_t nRead = std::fread(contentsBuffer, 1, lastRecord ?
+              expectedSize + 1 :
+              expectedSize, file);
 
             CPPUNIT_ASSERT_EQUAL(expectedSize, nRead);
 
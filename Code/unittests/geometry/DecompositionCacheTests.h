@@ -0,0 +1,108 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#ifndef HEMELB_UNITTESTS_GEOMETRY_DECOMPOSITIONCACHETESTS_H
+#define HEMELB_UNITTESTS_GEOMETRY_DECOMPOSITIONCACHETESTS_H
+
+#include <cppunit/TestFixture.h>
+#include "geometry/decomposition/DecompositionCache.h"
+#include "unittests/helpers/FolderTestFixture.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace geometry
+    {
+      using namespace hemelb::geometry::decomposition;
+
+      class DecompositionCacheTests : public helpers::FolderTestFixture
+      {
+          CPPUNIT_TEST_SUITE ( DecompositionCacheTests);
+          CPPUNIT_TEST ( TestMissingFile);
+          CPPUNIT_TEST ( TestRoundTrip);
+          CPPUNIT_TEST ( TestDifferentGeometry);CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void setUp()
+          {
+            FolderTestFixture::setUp();
+
+            for (site_t block = 0; block < 8; ++block)
+            {
+              procForEachBlock.push_back(0);
+            }
+            // Each rank moves a different number of its sites, so that the moves from all the
+            // ranks have to be put together in order.
+            for (proc_t rank = 0; rank < Comms().Size(); ++rank)
+            {
+              movesPerProc.push_back(rank + 1);
+              for (idx_t move = 0; move <= rank; ++move)
+              {
+                const idx_t triple[] = { rank % 8, 10 * rank + move, (rank + 1) % Comms().Size() };
+                movesList.insert(movesList.end(), triple, triple + 3);
+                if (rank == Comms().Rank())
+                {
+                  localMoves.insert(localMoves.end(), triple, triple + 3);
+                }
+              }
+            }
+          }
+
+          void TestMissingFile()
+          {
+            DecompositionCache cache(Comms(), "missing.dcm", 15, PARMETIS, 1234, 8);
+            std::vector<proc_t> readProcs;
+            std::vector<idx_t> readMovesPerProc, readMovesList;
+            CPPUNIT_ASSERT(!cache.Read(readProcs, readMovesPerProc, readMovesList));
+          }
+
+          void TestRoundTrip()
+          {
+            DecompositionCache cache(Comms(), "decomposition.dcm", 15, PARMETIS, 1234, 8);
+            cache.Write(procForEachBlock, localMoves);
+
+            std::vector<proc_t> readProcs;
+            std::vector<idx_t> readMovesPerProc, readMovesList;
+            CPPUNIT_ASSERT(cache.Read(readProcs, readMovesPerProc, readMovesList));
+            CPPUNIT_ASSERT(readProcs == procForEachBlock);
+            CPPUNIT_ASSERT(readMovesPerProc == movesPerProc);
+            CPPUNIT_ASSERT(readMovesList == movesList);
+          }
+
+          void TestDifferentGeometry()
+          {
+            DecompositionCache cache(Comms(), "decomposition.dcm", 15, PARMETIS, 1234, 8);
+            cache.Write(procForEachBlock, localMoves);
+
+            // Each part of the key must match.
+            DecompositionCache otherGeometry(Comms(), "decomposition.dcm", 15, PARMETIS, 4321, 8);
+            DecompositionCache otherLattice(Comms(), "decomposition.dcm", 27, PARMETIS, 1234, 8);
+            DecompositionCache otherMethod(Comms(), "decomposition.dcm", 15, HILBERT_CURVE, 1234, 8);
+
+            std::vector<proc_t> readProcs;
+            std::vector<idx_t> readMovesPerProc, readMovesList;
+            CPPUNIT_ASSERT(!otherGeometry.Read(readProcs, readMovesPerProc, readMovesList));
+            CPPUNIT_ASSERT(!otherLattice.Read(readProcs, readMovesPerProc, readMovesList));
+            CPPUNIT_ASSERT(!otherMethod.Read(readProcs, readMovesPerProc, readMovesList));
+          }
+
+        private:
+          std::vector<proc_t> procForEachBlock;
+          std::vector<idx_t> movesPerProc;
+          std::vector<idx_t> movesList;
+          std::vector<idx_t> localMoves;
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( DecompositionCacheTests);
+    }
+  }
+}
+
+#endif // HEMELB_UNITTESTS_GEOMETRY_DECOMPOSITIONCACHETESTS_H
@@ -28,7 +28,10 @@ namespace hemelb
       {
           CPPUNIT_TEST_SUITE ( GeometryReaderTests);
           CPPUNIT_TEST ( TestRead);
-          CPPUNIT_TEST ( TestSameAsFourCube);CPPUNIT_TEST_SUITE_END();
+          CPPUNIT_TEST ( TestSameAsFourCube);
+          CPPUNIT_TEST ( TestCollectiveSameAsBlockwise);
+          CPPUNIT_TEST ( TestColumnarSameAsXdr);
+          CPPUNIT_TEST ( TestCachedDecompositionSameAsComputed);CPPUNIT_TEST_SUITE_END();
 
         public:
 
@@ -40,15 +43,16 @@ namespace hemelb
           {
             FolderTestFixture::setUp();
             timings = new reporting::Timers(Comms());
-            reader = new GeometryReader(false,
-                                        hemelb::lb::lattices::D3Q15::GetLatticeInfo(),
-                                        *timings, Comms());
             lattice = NULL;
             fourCube = FourCubeLatticeData::Create(Comms());
             CopyResourceToTempdir("four_cube.xml");
             CopyResourceToTempdir("four_cube.gmy");
             simConfig = NULL;
             simConfig = configuration::SimConfig::New("four_cube.xml");
+            reader = new GeometryReader(false,
+                                        hemelb::lb::lattices::D3Q15::GetLatticeInfo(),
+                                        *timings, Comms(),
+                                        simConfig->GetGeometryReadingConfiguration());
           }
 
           void tearDown()
@@ -110,6 +114,113 @@ namespace hemelb
 
           }
 
+          void TestCollectiveSameAsBlockwise()
+          {
+            configuration::SimConfig::GeometryReadingConfig readingConfig;
+            readingConfig.collective = true;
+            GeometryReader collectiveReader(false,
+                                            hemelb::lb::lattices::D3Q15::GetLatticeInfo(),
+                                            *timings, Comms(), readingConfig);
+            Geometry collective = collectiveReader.LoadAndDecompose(simConfig->GetDataFilePath());
+
+            readingConfig.collective = false;
+            GeometryReader blockwiseReader(false,
+                                           hemelb::lb::lattices::D3Q15::GetLatticeInfo(),
+                                           *timings, Comms(), readingConfig);
+            Geometry blockwise = blockwiseReader.LoadAndDecompose(simConfig->GetDataFilePath());
+
+            CPPUNIT_ASSERT_EQUAL(blockwise.GetBlockCount(), collective.GetBlockCount());
+            for (site_t block = 0; block < blockwise.GetBlockCount(); ++block)
+            {
+              const ArenaSlice<GeometrySite>& expected = blockwise.Blocks[block].Sites;
+              const ArenaSlice<GeometrySite>& actual = collective.Blocks[block].Sites;
+              CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+              for (size_t site = 0; site < expected.size(); ++site)
+              {
+                CPPUNIT_ASSERT_EQUAL(hemelb::geometry::SiteData(expected[site]),
+                                     hemelb::geometry::SiteData(actual[site]));
+                CPPUNIT_ASSERT_EQUAL(expected[site].targetProcessor, actual[site].targetProcessor);
+                CPPUNIT_ASSERT_EQUAL(expected[site].wallNormalAvailable,
+                                     actual[site].wallNormalAvailable);
+              }
+            }
+          }
+
+          void TestColumnarSameAsXdr()
+          {
+            // four_cube_columnar.gmy is four_cube.gmy run through GmyColumnarConverter.py.
+            CopyResourceToTempdir("four_cube_columnar.gmy");
+            Geometry xdr = reader->LoadAndDecompose(simConfig->GetDataFilePath());
+
+            GeometryReader columnarReader(false,
+                                          hemelb::lb::lattices::D3Q15::GetLatticeInfo(),
+                                          *timings, Comms(),
+                                          simConfig->GetGeometryReadingConfiguration());
+            Geometry columnar = columnarReader.LoadAndDecompose("four_cube_columnar.gmy");
+
+            CPPUNIT_ASSERT_EQUAL(xdr.GetBlockCount(), columnar.GetBlockCount());
+            for (site_t block = 0; block < xdr.GetBlockCount(); ++block)
+            {
+              const ArenaSlice<GeometrySite>& expected = xdr.Blocks[block].Sites;
+              const ArenaSlice<GeometrySite>& actual = columnar.Blocks[block].Sites;
+              CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+              for (size_t site = 0; site < expected.size(); ++site)
+              {
+                CPPUNIT_ASSERT_EQUAL(hemelb::geometry::SiteData(expected[site]),
+                                     hemelb::geometry::SiteData(actual[site]));
+                CPPUNIT_ASSERT_EQUAL(expected[site].links.size(), actual[site].links.size());
+                for (size_t link = 0; link < expected[site].links.size(); ++link)
+                {
+                  CPPUNIT_ASSERT_EQUAL(expected[site].links[link].type,
+                                       actual[site].links[link].type);
+                  CPPUNIT_ASSERT_EQUAL(expected[site].links[link].distanceToIntersection,
+                                       actual[site].links[link].distanceToIntersection);
+                  CPPUNIT_ASSERT_EQUAL(expected[site].links[link].ioletId,
+                                       actual[site].links[link].ioletId);
+                }
+                CPPUNIT_ASSERT_EQUAL(expected[site].wallNormalAvailable,
+                                     actual[site].wallNormalAvailable);
+                bool sameNormal = (expected[site].wallNormal == actual[site].wallNormal);
+                CPPUNIT_ASSERT(sameNormal);
+              }
+            }
+          }
+
+          void TestCachedDecompositionSameAsComputed()
+          {
+            Geometry computed = reader->LoadAndDecompose(simConfig->GetDataFilePath());
+
+            configuration::SimConfig::GeometryReadingConfig readingConfig =
+                simConfig->GetGeometryReadingConfiguration();
+            readingConfig.decompositionCachePath = "four_cube.dcm";
+            for (int run = 0; run < 2; ++run)
+            {
+              // The first run writes the cache and the second reads it.
+              GeometryReader cachingReader(false,
+                                           hemelb::lb::lattices::D3Q15::GetLatticeInfo(),
+                                           *timings, Comms(), readingConfig);
+              Geometry cached = cachingReader.LoadAndDecompose(simConfig->GetDataFilePath());
+              AssertPresent("four_cube.dcm");
+
+              CPPUNIT_ASSERT_EQUAL(computed.GetBlockCount(), cached.GetBlockCount());
+              for (site_t block = 0; block < computed.GetBlockCount(); ++block)
+              {
+                const ArenaSlice<GeometrySite>& expected = computed.Blocks[block].Sites;
+                const ArenaSlice<GeometrySite>& actual = cached.Blocks[block].Sites;
+                CPPUNIT_ASSERT_EQUAL(expected.size(), actual.size());
+                for (size_t site = 0; site < expected.size(); ++site)
+                {
+                  CPPUNIT_ASSERT_EQUAL(expected[site].isFluid, actual[site].isFluid);
+                  // On several ranks the computed decomposition only tells each rank about moves
+                  // to blocks it already knew, while the cache has them all, so they can disagree
+                  // about sites in the halo. Every rank must still own the same sites.
+                  CPPUNIT_ASSERT_EQUAL(expected[site].targetProcessor == Comms().Rank(),
+                                       actual[site].targetProcessor == Comms().Rank());
+                }
+              }
+            }
+          }
+
         private:
           GeometryReader *reader;
           LatticeData* lattice;
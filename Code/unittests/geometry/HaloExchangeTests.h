@@ -0,0 +1,226 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+
+#ifndef HEMELB_UNITTESTS_GEOMETRY_HALOEXCHANGETESTS_H
+#define HEMELB_UNITTESTS_GEOMETRY_HALOEXCHANGETESTS_H
+
+#include <algorithm>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include "geometry/LatticeData.h"
+#include "lb/lattices/D3Q15.h"
+#include "net/net.h"
+#include "unittests/helpers/HasCommsTestFixture.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace geometry
+    {
+      /**
+       * A cube of fluid sites cut into slabs along z, one per rank (or as many as there are
+       * planes), which can also exchange its halo the way it used to: received contiguously and
+       * then copied into place.
+       */
+      class SlabbedCubeLatticeData : public hemelb::geometry::LatticeData
+      {
+        public:
+          SlabbedCubeLatticeData(const hemelb::geometry::Geometry& geometry, const net::IOCommunicator& comms) :
+              hemelb::geometry::LatticeData(lb::lattices::D3Q15::GetLatticeInfo(), geometry, comms)
+          {
+          }
+
+          static hemelb::geometry::Geometry CreateGeometry(proc_t rankCount)
+          {
+            const site_t sitesPerBlockUnit = 6;
+            const site_t minInd = 1, maxInd = sitesPerBlockUnit - 2;
+            const site_t sitesAlongCube = maxInd - minInd + 1;
+
+            hemelb::geometry::Geometry geometry(util::Vector3D<site_t>::Ones(), sitesPerBlockUnit);
+            geometry.ReserveSiteStorage(1,
+                                        sitesAlongCube * sitesAlongCube * sitesAlongCube,
+                                        lb::lattices::D3Q15::NUMVECTORS - 1);
+            geometry.AllocateBlockSites(0);
+            hemelb::geometry::BlockReadResult& block = geometry.Blocks[0];
+
+            const proc_t slabCount = std::min(rankCount, (proc_t) sitesAlongCube);
+            site_t index = -1;
+            for (site_t i = 0; i < sitesPerBlockUnit; ++i)
+            {
+              for (site_t j = 0; j < sitesPerBlockUnit; ++j)
+              {
+                for (site_t k = 0; k < sitesPerBlockUnit; ++k)
+                {
+                  ++index;
+                  if (i < minInd || i > maxInd || j < minInd || j > maxInd || k < minInd || k > maxInd)
+                  {
+                    continue;
+                  }
+
+                  hemelb::geometry::GeometrySite& site = block.Sites[index];
+                  site.isFluid = true;
+                  site.targetProcessor = (proc_t) ( (k - minInd) * slabCount / sitesAlongCube);
+                  site.links = geometry.AllocateLinks(lb::lattices::D3Q15::NUMVECTORS - 1);
+                }
+              }
+            }
+            return geometry;
+          }
+
+          site_t GetHaloDistributionCount() const
+          {
+            return totalSharedFs;
+          }
+
+          //! The number of distributions in fNew: the local ones, the rubbish site and the halo.
+          site_t GetFNewCount() const
+          {
+            return GetLocalDistributionCount() + 1 + totalSharedFs;
+          }
+
+          /**
+           * Receive each neighbour's distributions into a contiguous buffer, then copy them to
+           * where they stream to.
+           */
+          void GatherHalo(net::Net& net)
+          {
+            std::vector<distribn_storage_t> received(totalSharedFs + 1);
+            for (std::vector<hemelb::geometry::NeighbouringProcessor>::const_iterator it = neighbouringProcs.begin();
+                it != neighbouringProcs.end(); ++it)
+            {
+              net.RequestReceive<distribn_storage_t>(&received[it->FirstSharedDistribution
+                                                         - neighbouringProcs[0].FirstSharedDistribution],
+                                                     (int) it->SharedDistributionCount,
+                                                     it->Rank);
+              net.RequestSend<distribn_storage_t>(GetFNew(it->FirstSharedDistribution),
+                                                  (int) it->SharedDistributionCount,
+                                                  it->Rank);
+            }
+            net.Dispatch();
+
+            for (site_t shared = 0; shared < totalSharedFs; ++shared)
+            {
+              *GetFNew(streamingIndicesForReceivedDistributions[shared]) = received[shared];
+            }
+          }
+      };
+
+      /**
+       * The halo exchange, however the distributions are laid out and sent, must put every
+       * received distribution where receiving it contiguously and copying it into place would.
+       */
+      class HaloExchangeTests : public helpers::HasCommsTestFixture
+      {
+          CPPUNIT_TEST_SUITE( HaloExchangeTests);
+          CPPUNIT_TEST( TestMatchesGather);
+          CPPUNIT_TEST( TestPersistentMatchesGather);CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void setUp()
+          {
+            helpers::HasCommsTestFixture::setUp();
+            latDat = new SlabbedCubeLatticeData(SlabbedCubeLatticeData::CreateGeometry(Comms().Size()), Comms());
+          }
+
+          void tearDown()
+          {
+            delete latDat;
+            helpers::HasCommsTestFixture::tearDown();
+          }
+
+          void TestMatchesGather()
+          {
+            net::Net net(Comms());
+            const site_t distributionCount = latDat->GetFNewCount();
+            // Every slab has a neighbour when there is more than one.
+            if (Comms().Size() > 1 && latDat->GetLocalFluidSiteCount() > 0)
+            {
+              CPPUNIT_ASSERT(latDat->GetHaloDistributionCount() > 0);
+            }
+
+            std::vector<distribn_storage_t> initial(distributionCount);
+            for (site_t index = 0; index < distributionCount; ++index)
+            {
+              // Small enough integers to be exact at any storage precision.
+              initial[index] = distribn_storage_t(1000 * Comms().Rank() + index % 1000);
+            }
+
+            SetFNew(initial);
+            latDat->SendAndReceive(&net);
+            net.Dispatch();
+            latDat->CopyReceived();
+            const std::vector<distribn_storage_t> exchanged = GetFNew(distributionCount);
+
+            CheckMatchesGather(net, initial, exchanged);
+          }
+
+          void TestPersistentMatchesGather()
+          {
+            net::Net net(Comms());
+            const site_t distributionCount = latDat->GetFNewCount();
+
+            // Restart the same persistent requests on a few steps.
+            for (unsigned step = 0; step < 3; ++step)
+            {
+              std::vector<distribn_storage_t> initial(distributionCount);
+              for (site_t index = 0; index < distributionCount; ++index)
+              {
+                initial[index] = distribn_storage_t(1000 * Comms().Rank() + (index + 7 * step) % 1000);
+              }
+
+              SetFNew(initial);
+              latDat->StartHaloReceives();
+              latDat->StartHaloSends();
+              latDat->WaitForHalo();
+              latDat->CopyReceived();
+              const std::vector<distribn_storage_t> exchanged = GetFNew(distributionCount);
+
+              CheckMatchesGather(net, initial, exchanged);
+            }
+          }
+
+        private:
+          void CheckMatchesGather(net::Net& net,
+                                  const std::vector<distribn_storage_t>& initial,
+                                  const std::vector<distribn_storage_t>& exchanged)
+          {
+            SetFNew(initial);
+            latDat->GatherHalo(net);
+            const std::vector<distribn_storage_t> gathered = GetFNew(initial.size());
+
+            for (site_t index = 0; index < (site_t) initial.size(); ++index)
+            {
+              CPPUNIT_ASSERT_EQUAL(gathered[index], exchanged[index]);
+            }
+          }
+
+          void SetFNew(const std::vector<distribn_storage_t>& values)
+          {
+            for (site_t index = 0; index < (site_t) values.size(); ++index)
+            {
+              *latDat->GetFNew(index) = values[index];
+            }
+          }
+
+          std::vector<distribn_storage_t> GetFNew(site_t count)
+          {
+            return std::vector<distribn_storage_t>(latDat->GetFNew(0), latDat->GetFNew(0) + count);
+          }
+
+          SlabbedCubeLatticeData* latDat;
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION( HaloExchangeTests);
+    }
+  }
+}
+
+#endif // HEMELB_UNITTESTS_GEOMETRY_HALOEXCHANGETESTS_H
@@ -10,6 +10,7 @@
 #ifndef HEMELB_UNITTESTS_GEOMETRY_LATTICEDATATESTS_H
 #define HEMELB_UNITTESTS_GEOMETRY_LATTICEDATATESTS_H
 
+#include <set>
 #include "geometry/LatticeData.h"
 
 namespace hemelb
@@ -26,6 +27,7 @@ namespace hemelb
           CPPUNIT_TEST ( TestConstruct);
           CPPUNIT_TEST ( TestConvertGlobalId);
           CPPUNIT_TEST ( TestGetProcFromGlobalId);
+          CPPUNIT_TEST ( TestDistributionIndices);
 
           CPPUNIT_TEST_SUITE_END();
 
@@ -71,6 +73,33 @@ namespace hemelb
             CPPUNIT_ASSERT_EQUAL(latDat->ProcProvidingSiteByGlobalNoncontiguousId(43), 0);
           }
 
+          void TestDistributionIndices()
+          {
+            // Whatever the layout, each (site, direction) pair must have its own slot in the
+            // distribution arrays and gathering a site's distributions must find them again.
+            std::set<site_t> seenIndices;
+            for (site_t site = 0; site < latDat->GetLocalFluidSiteCount(); ++site)
+            {
+              for (Direction direction = 0; direction < lb::lattices::D3Q15::NUMVECTORS; ++direction)
+              {
+                site_t index = latDat->GetDistributionIndex<lb::lattices::D3Q15>(site, direction);
+                CPPUNIT_ASSERT(seenIndices.insert(index).second);
+                latDat->WriteFNew(index, direction, distribn_t(index));
+              }
+
+              distribn_t buffer[lb::lattices::D3Q15::NUMVECTORS];
+              const distribn_t* siteFNew = latDat->GetSiteFNew<lb::lattices::D3Q15>(site, buffer);
+              for (Direction direction = 0; direction < lb::lattices::D3Q15::NUMVECTORS; ++direction)
+              {
+                // Reduced precision storage may round the values, but not enough to confuse them.
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(distribn_t(latDat->GetDistributionIndex<lb::lattices::D3Q15>(site,
+                                                                                                          direction)),
+                                             siteFNew[direction],
+                                             1e-3);
+              }
+            }
+          }
+
         private:
       };
       CPPUNIT_TEST_SUITE_REGISTRATION ( NeighbouringLatticeDataTests);
@@ -0,0 +1,93 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#ifndef HEMELB_UNITTESTS_GEOMETRY_LOADBALANCERTESTS_H
+#define HEMELB_UNITTESTS_GEOMETRY_LOADBALANCERTESTS_H
+
+#include <cppunit/TestFixture.h>
+#include "geometry/decomposition/LoadBalancer.h"
+#include "unittests/helpers/FourCubeBasedTestFixture.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace geometry
+    {
+      using namespace hemelb::geometry::decomposition;
+
+      class LoadBalancerTests : public helpers::FourCubeBasedTestFixture
+      {
+          CPPUNIT_TEST_SUITE ( LoadBalancerTests);
+          CPPUNIT_TEST ( TestSingleRankIsBalanced);
+          CPPUNIT_TEST ( TestScalesOnSingleRank);
+          CPPUNIT_TEST ( TestSlowRankScaledUp);CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void TestSingleRankIsBalanced()
+          {
+            LoadBalancer balancer(Comms(), latDat->GetBlockCount(), SiteWeights(), 1.1);
+
+            CPPUNIT_ASSERT(balancer.GetBlockWeightScales().empty());
+            CPPUNIT_ASSERT(!balancer.IsImbalanced(2.0));
+            CPPUNIT_ASSERT(!balancer.IsImbalanced(5.0));
+          }
+
+          void TestScalesOnSingleRank()
+          {
+            // With one rank, every site costs the mean, so the weights should stay as they are.
+            LoadBalancer balancer(Comms(), latDat->GetBlockCount(), SiteWeights(), 1.1);
+            balancer.IsImbalanced(3.0);
+            balancer.UpdateBlockWeightScales(*latDat);
+
+            const std::vector<float>& scales = balancer.GetBlockWeightScales();
+            CPPUNIT_ASSERT_EQUAL((size_t) latDat->GetBlockCount(), scales.size());
+            for (size_t block = 0; block < scales.size(); ++block)
+            {
+              CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, scales[block], 1e-6);
+            }
+          }
+
+          void TestSlowRankScaledUp()
+          {
+            // Each rank has the same sites on a block of its own, and the first takes three times
+            // as long as the others. Its sites cost 3n / (n + 2) times the mean per unit weight,
+            // and the others' n / (n + 2) times, so its block gets heavier and theirs lighter.
+            const proc_t rankCount = Comms().Size();
+            LoadBalancer balancer(Comms(), rankCount, SiteWeights(), 1.1);
+            CPPUNIT_ASSERT_EQUAL(rankCount > 1, balancer.IsImbalanced(Comms().Rank() == 0 ?
+              3.0 :
+              1.0));
+
+            std::vector<site_t> siteBlocks(10, Comms().Rank());
+            std::vector<unsigned> siteCollisionTypes(10, 0);
+            siteCollisionTypes[0] = 1;
+            balancer.UpdateBlockWeightScales(siteBlocks, siteCollisionTypes);
+
+            const std::vector<float>& scales = balancer.GetBlockWeightScales();
+            CPPUNIT_ASSERT_EQUAL((size_t) rankCount, scales.size());
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0 * rankCount / (rankCount + 2), scales[0], 1e-6);
+            for (proc_t rank = 1; rank < rankCount; ++rank)
+            {
+              CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0 * rankCount / (rankCount + 2), scales[rank], 1e-6);
+              CPPUNIT_ASSERT(scales[rank] < 1.0F);
+            }
+            if (rankCount > 1)
+            {
+              CPPUNIT_ASSERT(scales[0] > 1.0F);
+            }
+          }
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( LoadBalancerTests);
+    }
+  }
+}
+
+#endif // HEMELB_UNITTESTS_GEOMETRY_LOADBALANCERTESTS_H
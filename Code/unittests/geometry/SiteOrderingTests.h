@@ -0,0 +1,141 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#ifndef HEMELB_UNITTESTS_GEOMETRY_SITEORDERINGTESTS_H
+#define HEMELB_UNITTESTS_GEOMETRY_SITEORDERINGTESTS_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <cppunit/TestFixture.h>
+#include "geometry/SiteOrdering.h"
+#include "lb/lattices/D3Q15.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace geometry
+    {
+      using namespace hemelb::geometry;
+
+      class SiteOrderingTests : public CppUnit::TestFixture
+      {
+          CPPUNIT_TEST_SUITE ( SiteOrderingTests);
+          CPPUNIT_TEST ( TestRcmNarrowsBand);
+          CPPUNIT_TEST ( TestRcmSeparatePieces);
+          CPPUNIT_TEST ( TestHilbertIsContinuous);CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void setUp()
+          {
+            // An 8x8x8 cube of sites, listed in a scrambled order.
+            locations.clear();
+            for (site_t site = 0; site < 512; ++site)
+            {
+              site_t scrambled = (site * 37) % 512;
+              locations.push_back(util::Vector3D<site_t>(scrambled / 64, (scrambled / 8) % 8, scrambled % 8));
+            }
+          }
+
+          void TestRcmNarrowsBand()
+          {
+            std::vector<site_t> order;
+            RCM::GetOrder(locations, lb::lattices::D3Q15::GetLatticeInfo(), order);
+
+            AssertIsPermutation(order);
+            // Linked sites should end up within a few planes of the cube of each other, rather than
+            // anywhere in the scrambled list.
+            std::vector<site_t> identity;
+            BLOCK::GetOrder(locations, lb::lattices::D3Q15::GetLatticeInfo(), identity);
+            CPPUNIT_ASSERT(GetBandwidth(identity) > 6 * 64);
+            CPPUNIT_ASSERT(GetBandwidth(order) < 3 * 64);
+          }
+
+          void TestRcmSeparatePieces()
+          {
+            // Two cubes with no links between them should each be ordered contiguously.
+            std::vector<util::Vector3D<site_t> > twoCubes(locations);
+            for (site_t site = 0; site < (site_t) locations.size(); ++site)
+            {
+              twoCubes.push_back(locations[site] + util::Vector3D<site_t>(20, 0, 0));
+            }
+            std::vector<site_t> order;
+            RCM::GetOrder(twoCubes, lb::lattices::D3Q15::GetLatticeInfo(), order);
+
+            AssertIsPermutation(order);
+            for (site_t position = 1; position < (site_t) order.size(); ++position)
+            {
+              bool sameCube = (order[position] < 512) == (order[position - 1] < 512);
+              CPPUNIT_ASSERT(sameCube || position == 512);
+            }
+          }
+
+          void TestHilbertIsContinuous()
+          {
+            std::vector<site_t> order;
+            HILBERT::GetOrder(locations, lb::lattices::D3Q15::GetLatticeInfo(), order);
+
+            AssertIsPermutation(order);
+            for (site_t position = 1; position < (site_t) order.size(); ++position)
+            {
+              util::Vector3D<site_t> step = locations[order[position]] - locations[order[position - 1]];
+              CPPUNIT_ASSERT_EQUAL(1L, (long) (std::labs(step.x) + std::labs(step.y) + std::labs(step.z)));
+            }
+          }
+
+        private:
+          void AssertIsPermutation(const std::vector<site_t>& order) const
+          {
+            std::vector<site_t> sorted(order);
+            std::sort(sorted.begin(), sorted.end());
+            for (site_t site = 0; site < (site_t) sorted.size(); ++site)
+            {
+              CPPUNIT_ASSERT_EQUAL(site, sorted[site]);
+            }
+          }
+
+          /**
+           * The furthest apart, in the given order, that any two sites one lattice vector apart
+           * are placed.
+           */
+          site_t GetBandwidth(const std::vector<site_t>& order) const
+          {
+            const lb::lattices::LatticeInfo& latticeInfo = lb::lattices::D3Q15::GetLatticeInfo();
+            std::vector<site_t> positionOfSite(order.size());
+            for (site_t position = 0; position < (site_t) order.size(); ++position)
+            {
+              positionOfSite[order[position]] = position;
+            }
+
+            site_t bandwidth = 0;
+            for (site_t site = 0; site < (site_t) locations.size(); ++site)
+            {
+              for (site_t other = 0; other < (site_t) locations.size(); ++other)
+              {
+                for (Direction direction = 1; direction < latticeInfo.GetNumVectors(); ++direction)
+                {
+                  if (locations[site] + util::Vector3D<site_t>(latticeInfo.GetVector(direction)) == locations[other])
+                  {
+                    bandwidth = std::max(bandwidth, std::abs(positionOfSite[site] - positionOfSite[other]));
+                  }
+                }
+              }
+            }
+            return bandwidth;
+          }
+
+          std::vector<util::Vector3D<site_t> > locations;
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( SiteOrderingTests);
+    }
+  }
+}
+
+#endif // HEMELB_UNITTESTS_GEOMETRY_SITEORDERINGTESTS_H
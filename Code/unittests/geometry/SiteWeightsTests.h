@@ -0,0 +1,78 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#ifndef HEMELB_UNITTESTS_GEOMETRY_SITEWEIGHTSTESTS_H
+#define HEMELB_UNITTESTS_GEOMETRY_SITEWEIGHTSTESTS_H
+
+#include <cppunit/TestFixture.h>
+#include "geometry/decomposition/SiteWeights.h"
+#include "geometry/decomposition/DecompositionWeights.h"
+#include "unittests/helpers/FolderTestFixture.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace geometry
+    {
+      using namespace hemelb::geometry::decomposition;
+
+      class SiteWeightsTests : public helpers::FolderTestFixture
+      {
+          CPPUNIT_TEST_SUITE ( SiteWeightsTests);
+          CPPUNIT_TEST ( TestCompiledIn);
+          CPPUNIT_TEST ( TestMeasuredCosts);
+          CPPUNIT_TEST ( TestRoundTrip);CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void TestCompiledIn()
+          {
+            SiteWeights weights;
+            for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+            {
+              CPPUNIT_ASSERT_EQUAL(hemelbSiteWeights[collisionType], weights[collisionType]);
+            }
+          }
+
+          void TestMeasuredCosts()
+          {
+            // No outlet/wall sites were measured.
+            const double costs[] = { 2e-8, 3e-8, 8e-8, 8.2e-8, 1.2e-7, 0.0 };
+            SiteWeights weights = SiteWeights::FromMeasuredCosts(std::vector<double>(costs, costs + 6));
+
+            CPPUNIT_ASSERT_EQUAL(SiteWeights::WeightResolution, weights[0]);
+            CPPUNIT_ASSERT_EQUAL(15, weights[1]);
+            CPPUNIT_ASSERT_EQUAL(40, weights[2]);
+            CPPUNIT_ASSERT_EQUAL(41, weights[3]);
+            CPPUNIT_ASSERT_EQUAL(60, weights[4]);
+            const int compiledIn = (int) (double(SiteWeights::WeightResolution) * hemelbSiteWeights[5]
+                / hemelbSiteWeights[0] + 0.5);
+            CPPUNIT_ASSERT_EQUAL(compiledIn, weights[5]);
+          }
+
+          void TestRoundTrip()
+          {
+            const double costs[] = { 1.0, 1.7, 3.0, 3.3, 5.0, 6.0 };
+            SiteWeights weights = SiteWeights::FromMeasuredCosts(std::vector<double>(costs, costs + 6));
+            weights.Write("weights.xml");
+
+            SiteWeights readWeights("weights.xml");
+            for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+            {
+              CPPUNIT_ASSERT_EQUAL(weights[collisionType], readWeights[collisionType]);
+            }
+          }
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( SiteWeightsTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_GEOMETRY_SITEWEIGHTSTESTS_H */
@@ -0,0 +1,81 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#ifndef HEMELB_UNITTESTS_GEOMETRY_SPACEFILLINGCURVEDECOMPOSITIONTESTS_H
+#define HEMELB_UNITTESTS_GEOMETRY_SPACEFILLINGCURVEDECOMPOSITIONTESTS_H
+
+#include <cstdlib>
+#include <map>
+#include <cppunit/TestFixture.h>
+#include "geometry/decomposition/SpaceFillingCurveDecomposition.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace geometry
+    {
+      using namespace hemelb::geometry::decomposition;
+
+      class SpaceFillingCurveDecompositionTests : public CppUnit::TestFixture
+      {
+          CPPUNIT_TEST_SUITE ( SpaceFillingCurveDecompositionTests);
+          CPPUNIT_TEST ( TestMortonKey);
+          CPPUNIT_TEST ( TestHilbertKeyIsContinuous);CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void TestMortonKey()
+          {
+            typedef util::Vector3D<site_t> Location;
+            CPPUNIT_ASSERT_EQUAL((uint64_t) 0, SpaceFillingCurveDecomposition::MortonKey(Location(0, 0, 0), 3));
+            CPPUNIT_ASSERT_EQUAL((uint64_t) 1, SpaceFillingCurveDecomposition::MortonKey(Location(0, 0, 1), 3));
+            CPPUNIT_ASSERT_EQUAL((uint64_t) 2, SpaceFillingCurveDecomposition::MortonKey(Location(0, 1, 0), 3));
+            CPPUNIT_ASSERT_EQUAL((uint64_t) 4, SpaceFillingCurveDecomposition::MortonKey(Location(1, 0, 0), 3));
+            CPPUNIT_ASSERT_EQUAL((uint64_t) 8, SpaceFillingCurveDecomposition::MortonKey(Location(0, 0, 2), 3));
+            CPPUNIT_ASSERT_EQUAL((uint64_t) 511, SpaceFillingCurveDecomposition::MortonKey(Location(7, 7, 7), 3));
+          }
+
+          void TestHilbertKeyIsContinuous()
+          {
+            // The curve should visit every site of an 8x8x8 cube once, each a single step from the
+            // one before.
+            const unsigned bits = 3;
+            const site_t sites = 1 << bits;
+            std::map<uint64_t, util::Vector3D<site_t> > sitesByKey;
+            for (site_t x = 0; x < sites; ++x)
+            {
+              for (site_t y = 0; y < sites; ++y)
+              {
+                for (site_t z = 0; z < sites; ++z)
+                {
+                  util::Vector3D<site_t> location(x, y, z);
+                  sitesByKey[SpaceFillingCurveDecomposition::HilbertKey(location, bits)] = location;
+                }
+              }
+            }
+
+            CPPUNIT_ASSERT_EQUAL((size_t) (sites * sites * sites), sitesByKey.size());
+            CPPUNIT_ASSERT_EQUAL((uint64_t) (sites * sites * sites - 1), sitesByKey.rbegin()->first);
+
+            std::map<uint64_t, util::Vector3D<site_t> >::const_iterator previous = sitesByKey.begin();
+            for (std::map<uint64_t, util::Vector3D<site_t> >::const_iterator it = ++sitesByKey.begin();
+                it != sitesByKey.end(); previous = it++)
+            {
+              util::Vector3D<site_t> step = it->second - previous->second;
+              CPPUNIT_ASSERT_EQUAL(1L, (long) (std::labs(step.x) + std::labs(step.y) + std::labs(step.z)));
+            }
+          }
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( SpaceFillingCurveDecompositionTests);
+    }
+  }
+}
+
+#endif // HEMELB_UNITTESTS_GEOMETRY_SPACEFILLINGCURVEDECOMPOSITIONTESTS_H
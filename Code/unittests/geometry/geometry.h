@@ -11,8 +11,14 @@
 #define HEMELB_UNITTESTS_GEOMETRY_GEOMETRY_H
 
 #include "unittests/geometry/GeometryReaderTests.h"
+#include "unittests/geometry/DecompositionCacheTests.h"
+#include "unittests/geometry/SpaceFillingCurveDecompositionTests.h"
+#include "unittests/geometry/SiteOrderingTests.h"
+#include "unittests/geometry/LoadBalancerTests.h"
+#include "unittests/geometry/SiteWeightsTests.h"
 #include "unittests/geometry/NeedsTests.h"
 #include "unittests/geometry/LatticeDataTests.h"
+#include "unittests/geometry/HaloExchangeTests.h"
 #include "unittests/geometry/neighbouring/neighbouring.h"
 
 #endif // ONCE
@@ -225,7 +225,8 @@ namespace hemelb
 
               // It should arrive in the NeighbouringDataManager, from the values sent from the localLatticeData
 
-              netMock->RequireSend(const_cast<distribn_t*> (exampleSite.GetFOld<lb::lattices::D3Q15> ()),
+              distribn_t fOldBuffer[lb::lattices::D3Q15::NUMVECTORS];
+              netMock->RequireSend(const_cast<distribn_t*> (exampleSite.GetFOld<lb::lattices::D3Q15> (fOldBuffer)),
                                    lb::lattices::D3Q15::NUMVECTORS,
                                    0,
                                    "IntersectionDataToSelf");
@@ -275,7 +276,8 @@ namespace hemelb
               Site < LatticeData > exampleSite = latDat->GetSite(targetLocalIdx);
               // It should arrive in the NeighbouringDataManager, from the values sent from the localLatticeData
 
-              netMock->RequireSend(const_cast<distribn_t*> (exampleSite.GetFOld<lb::lattices::D3Q15> ()),
+              distribn_t fOldBuffer[lb::lattices::D3Q15::NUMVECTORS];
+              netMock->RequireSend(const_cast<distribn_t*> (exampleSite.GetFOld<lb::lattices::D3Q15> (fOldBuffer)),
                                    lb::lattices::D3Q15::NUMVECTORS,
                                    0,
                                    "IntersectionDataToSelf");
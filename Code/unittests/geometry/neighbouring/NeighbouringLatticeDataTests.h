@@ -86,17 +86,19 @@ namespace hemelb
 
             void TestInsertAndRetrieveDistributions()
             {
+              distribn_t fOldBuffer[lb::lattices::D3Q15::NUMVECTORS];
+              const distribn_t* exampleFOld = exampleSite->GetFOld<lb::lattices::D3Q15>(fOldBuffer);
               std::vector<distribn_t> distribution;
               for (unsigned int direction = 0; direction < lb::lattices::D3Q15::NUMVECTORS; direction++)
               {
-                distribution.push_back(exampleSite->GetFOld<lb::lattices::D3Q15>()[direction]);
+                distribution.push_back(exampleFOld[direction]);
               }
 
               data->GetDistribution(dummyId) = distribution;
 
               for (unsigned int direction = 0; direction < lb::lattices::D3Q15::NUMVECTORS; direction++)
               {
-                CPPUNIT_ASSERT_EQUAL(exampleSite->GetFOld<lb::lattices::D3Q15>()[direction],
+                CPPUNIT_ASSERT_EQUAL(exampleFOld[direction],
                                      data->GetFOld(dummyId * lb::lattices::D3Q15::NUMVECTORS)[direction]);
               }
             }
@@ -110,10 +112,12 @@ namespace hemelb
                 distances.push_back(exampleSite->GetWallDistance < lb::lattices::D3Q15 > (direction + 1));
               }
 
+              distribn_t fOldBuffer[lb::lattices::D3Q15::NUMVECTORS];
+              const distribn_t* exampleFOld = exampleSite->GetFOld<lb::lattices::D3Q15>(fOldBuffer);
               std::vector<distribn_t> distribution;
               for (unsigned int direction = 0; direction < lb::lattices::D3Q15::NUMVECTORS; direction++)
               {
-                distribution.push_back(exampleSite->GetFOld<lb::lattices::D3Q15>()[direction]);
+                distribution.push_back(exampleFOld[direction]);
               }
               data->SaveSite(dummyId,
                              distribution,
@@ -132,7 +136,7 @@ namespace hemelb
               CPPUNIT_ASSERT_EQUAL(exampleSite->GetWallNormal(), neighbouringSite.GetWallNormal());
               for (unsigned int direction = 0; direction < lb::lattices::D3Q15::NUMVECTORS; direction++)
               {
-                CPPUNIT_ASSERT_EQUAL(exampleSite->GetFOld<lb::lattices::D3Q15>()[direction],
+                CPPUNIT_ASSERT_EQUAL(exampleFOld[direction],
                                      neighbouringSite.GetFOld<lb::lattices::D3Q15>()[direction]);
               }
             }
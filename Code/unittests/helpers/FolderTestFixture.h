@@ -30,11 +30,15 @@ namespace hemelb
           {
             HasCommsTestFixture::setUp();
 
+            // All ranks work in the same folder, named by the time on the IO rank.
+            double stamp = util::myClock();
+            Comms().Broadcast(stamp, Comms().GetIORank());
+
             std::stringstream tempPathStream;
             // next line is a hack to get the build working again
             // TODO: find a portable uuid solution. BOOST?
             tempPathStream << util::GetTemporaryDir() << "/" << "HemeLBTest" << std::fixed
-                << floor(util::myClock() * 100000) << std::flush;
+                << floor(stamp * 100000) << std::flush;
             tempPath = tempPathStream.str();
             // store current location
             origin = util::GetCurrentDir();
@@ -60,8 +64,14 @@ namespace hemelb
           void CopyResourceToTempdir(const std::string & resource)
           {
             // TODO this should use a filesystem-independent path join (BOOST)
-            bool ok = util::FileCopy(resources::Resource(resource).Path().c_str(),
-                                     (tempPath + "/" + resource).c_str());
+            int ok = 1;
+            if (Comms().OnIORank())
+            {
+              ok = util::FileCopy(resources::Resource(resource).Path().c_str(),
+                                  (tempPath + "/" + resource).c_str());
+            }
+            // Nobody reads the copy before it is complete.
+            Comms().Broadcast(ok, Comms().GetIORank());
             CPPUNIT_ASSERT(ok);
           }
           void MoveToTempdir()
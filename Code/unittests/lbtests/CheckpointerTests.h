@@ -0,0 +1,151 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+
+#ifndef HEMELB_UNITTESTS_LBTESTS_CHECKPOINTERTESTS_H
+#define HEMELB_UNITTESTS_LBTESTS_CHECKPOINTERTESTS_H
+
+#include <cppunit/TestFixture.h>
+#include "io/formats/checkpoint.h"
+#include "lb/Checkpointer.h"
+#include "net/MpiFile.h"
+#include "unittests/helpers/FolderTestFixture.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace lbtests
+    {
+      /**
+       * Check that checkpoints can be written and read back, whatever order the sites are
+       * requested in.
+       */
+      class CheckpointerTests : public helpers::FolderTestFixture
+      {
+          CPPUNIT_TEST_SUITE( CheckpointerTests);
+          CPPUNIT_TEST( TestRoundTrip);
+          CPPUNIT_TEST( TestWrongValuesPerSite);
+          CPPUNIT_TEST( TestOverwriteWithShorter);
+          CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void setUp()
+          {
+            FolderTestFixture::setUp();
+
+            // Three values for each of five sites, numbered out of order.
+            const site_t ids[] = { 42, 7, 1000, 3, 19 };
+            written.timeStep = 1234;
+            written.valuesPerSite = 3;
+            for (unsigned site = 0; site < 5; ++site)
+            {
+              written.siteIds.push_back(ids[site]);
+              for (unsigned value = 0; value < 3; ++value)
+              {
+                written.siteValues.push_back(ids[site] + 0.25 * value);
+              }
+            }
+            written.ioletState.push_back(1.5);
+            written.ioletState.push_back(-2.5);
+            written.valuesPerParticle = 2;
+            written.particleValues.push_back(11.0);
+            written.particleValues.push_back(12.0);
+          }
+
+          void TestRoundTrip()
+          {
+            lb::Checkpointer checkpointer(Comms());
+            checkpointer.Write("round_trip.chk", written);
+
+            lb::CheckpointData read;
+            read.valuesPerSite = 3;
+            const site_t requested[] = { 19, 42, 3 };
+            read.siteIds.assign(requested, requested + 3);
+            checkpointer.Read("round_trip.chk", read);
+
+            CPPUNIT_ASSERT_EQUAL(written.timeStep, read.timeStep);
+            CPPUNIT_ASSERT(written.ioletState == read.ioletState);
+            CPPUNIT_ASSERT_EQUAL(written.valuesPerParticle, read.valuesPerParticle);
+            // Every process reads back the particles that all of them wrote.
+            std::vector<distribn_t> allParticleValues;
+            for (int rank = 0; rank < Comms().Size(); ++rank)
+            {
+              allParticleValues.insert(allParticleValues.end(),
+                                       written.particleValues.begin(),
+                                       written.particleValues.end());
+            }
+            CPPUNIT_ASSERT(allParticleValues == read.particleValues);
+
+            CPPUNIT_ASSERT_EQUAL((size_t) 9, read.siteValues.size());
+            for (unsigned site = 0; site < 3; ++site)
+            {
+              for (unsigned value = 0; value < 3; ++value)
+              {
+                CPPUNIT_ASSERT_EQUAL(requested[site] + 0.25 * value, read.siteValues[3 * site + value]);
+              }
+            }
+          }
+
+          void TestWrongValuesPerSite()
+          {
+            lb::Checkpointer checkpointer(Comms());
+            checkpointer.Write("wrong_values.chk", written);
+
+            lb::CheckpointData read;
+            read.valuesPerSite = 4;
+            read.siteIds.push_back(7);
+            bool threw = false;
+            try
+            {
+              checkpointer.Read("wrong_values.chk", read);
+            }
+            catch (Exception& e)
+            {
+              threw = true;
+            }
+            CPPUNIT_ASSERT(threw);
+          }
+
+          void TestOverwriteWithShorter()
+          {
+            lb::Checkpointer checkpointer(Comms());
+            checkpointer.Write("overwrite.chk", written);
+
+            // Rewrite the same checkpoint with fewer sites: none of the old file may be left.
+            lb::CheckpointData shorter = written;
+            shorter.siteIds.resize(2);
+            shorter.siteValues.resize(2 * 3);
+            checkpointer.Write("overwrite.chk", shorter);
+
+            const MPI_Offset ranks = Comms().Size();
+            const MPI_Offset expectedLength = io::formats::checkpoint::HeaderLength + 2 * sizeof(distribn_t)
+                + ranks * 2 * sizeof(distribn_t) + ranks * 2 * (sizeof(site_t) + 3 * sizeof(distribn_t));
+            net::MpiFile file = net::MpiFile::Open(Comms(), "overwrite.chk", MPI_MODE_RDONLY);
+            CPPUNIT_ASSERT_EQUAL(expectedLength, file.GetSize());
+            file.Close();
+
+            lb::CheckpointData read;
+            read.valuesPerSite = 3;
+            read.siteIds.push_back(7);
+            checkpointer.Read("overwrite.chk", read);
+            CPPUNIT_ASSERT_EQUAL((size_t) 3, read.siteValues.size());
+            CPPUNIT_ASSERT_EQUAL(7.5, read.siteValues[2]);
+          }
+
+        private:
+          lb::CheckpointData written;
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION( CheckpointerTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_LBTESTS_CHECKPOINTERTESTS_H */
@@ -39,8 +39,7 @@ namespace hemelb
             LbTestsHelper::InitialiseAnisotropicTestData<lb::lattices::D3Q15>(latDat);
             cache = new lb::MacroscopicPropertyCache(*simState, *latDat);
 
-            cache->densityCache.SetRefreshFlag();
-            cache->velocityCache.SetRefreshFlag();
+            cache->monitoringAccumulator.SetRefreshFlag();
             lbtests::LbTestsHelper::UpdatePropertyCache<lb::lattices::D3Q15>(*latDat, *cache, *simState);
 
             // These are the smallest and largest density values in FourCubeLatticeData by default
@@ -66,7 +65,7 @@ namespace hemelb
 
           void AdvanceActorOneTimeStep(net::IteratedAction& actor)
           {
-            cache->densityCache.SetRefreshFlag();
+            cache->monitoringAccumulator.SetRefreshFlag();
             LbTestsHelper::UpdatePropertyCache<lb::lattices::D3Q15>(*latDat, *cache, *simState);
 
             actor.RequestComms();
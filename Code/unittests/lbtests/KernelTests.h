@@ -42,7 +42,10 @@ namespace hemelb
           CPPUNIT_TEST ( TestLBGKCalculationsAndCollision);
           CPPUNIT_TEST ( TestLBGKNNCalculationsAndCollision);
           CPPUNIT_TEST ( TestMRTConstantRelaxationTimeEqualsLBGK);
-          CPPUNIT_TEST ( TestD3Q19MRTConstantRelaxationTimeEqualsLBGK);CPPUNIT_TEST_SUITE_END();
+          CPPUNIT_TEST ( TestD3Q19MRTConstantRelaxationTimeEqualsLBGK);
+          CPPUNIT_TEST ( TestLBGKMultiSiteAgreesWithSingleSite);
+          CPPUNIT_TEST ( TestTRTMultiSiteAgreesWithSingleSite);
+          CPPUNIT_TEST ( TestMRTMultiSiteAgreesWithSingleSite);CPPUNIT_TEST_SUITE_END();
         public:
           void setUp()
           {
@@ -702,6 +705,89 @@ namespace hemelb
                                                    allowedError);
             }
           }
+
+          void TestLBGKMultiSiteAgreesWithSingleSite()
+          {
+            lb::kernels::LBGK<lb::lattices::D3Q15> lbgk(initParams);
+            CompareMultiSiteWithSingleSite(lbgk, "LBGK");
+          }
+
+          void TestTRTMultiSiteAgreesWithSingleSite()
+          {
+            lb::kernels::TRT<lb::lattices::D3Q15> trt(initParams);
+            CompareMultiSiteWithSingleSite(trt, "TRT");
+          }
+
+          void TestMRTMultiSiteAgreesWithSingleSite()
+          {
+            lb::kernels::MRT<lb::kernels::momentBasis::DHumieresD3Q19MRTBasis> mrt(initParams);
+            CompareMultiSiteWithSingleSite(mrt, "MRT");
+          }
+
+        private:
+          /**
+           * Collides kernels::SimdWidth different sites with the multi-site functions of the
+           * kernel, then each of them with the single-site functions, and checks that the two
+           * agree.
+           */
+          template<class KernelType>
+          void CompareMultiSiteWithSingleSite(KernelType& kernel, const std::string& kernelName)
+          {
+            typedef typename KernelType::LatticeType LatticeType;
+
+            distribn_t f_original[lb::kernels::SimdWidth][LatticeType::NUMVECTORS];
+            lb::kernels::MultiSiteHydroVars<LatticeType> multiSiteHydroVars;
+            for (unsigned lane = 0; lane < lb::kernels::SimdWidth; ++lane)
+            {
+              LbTestsHelper::InitialiseAnisotropicTestData<LatticeType>(lane, f_original[lane]);
+              multiSiteHydroVars.SetSiteF(lane, f_original[lane]);
+              multiSiteHydroVars.tau[lane] = lbmParams->GetTau();
+            }
+
+            kernel.CalculateDensityMomentumFeqMultiSite(multiSiteHydroVars);
+            kernel.CollideMultiSite(lbmParams, multiSiteHydroVars);
+
+            distribn_t allowedError = 1e-10;
+            for (unsigned lane = 0; lane < lb::kernels::SimdWidth; ++lane)
+            {
+              lb::kernels::HydroVars<KernelType> expected(f_original[lane]);
+              expected.tau = lbmParams->GetTau();
+              kernel.CalculateDensityMomentumFeq(expected, lane);
+              kernel.Collide(lbmParams, expected);
+
+              distribn_t expectedFEq[LatticeType::NUMVECTORS];
+              for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ++ii)
+              {
+                expectedFEq[ii] = expected.GetFEq()[ii];
+              }
+
+              lb::kernels::HydroVars<KernelType> actual(f_original[lane]);
+              multiSiteHydroVars.GetSiteHydroVars(lane, actual);
+
+              std::stringstream laneName;
+              laneName << kernelName << ", site " << lane;
+
+              LbTestsHelper::CompareHydros(expected.density,
+                                           expected.momentum.x,
+                                           expected.momentum.y,
+                                           expected.momentum.z,
+                                           expectedFEq,
+                                           laneName.str(),
+                                           actual,
+                                           allowedError);
+
+              for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ++ii)
+              {
+                std::stringstream message;
+                message << laneName.str() << ", post-collision " << ii;
+
+                CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(message.str(),
+                                                     expected.GetFPostCollision()[ii],
+                                                     actual.GetFPostCollision()[ii],
+                                                     allowedError);
+              }
+            }
+          }
       };
       CPPUNIT_TEST_SUITE_REGISTRATION ( KernelTests);
     }
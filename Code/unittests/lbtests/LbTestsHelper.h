@@ -216,11 +216,13 @@ namespace hemelb
           {
             for (site_t site = 0; site < latDat.GetLocalFluidSiteCount(); ++site)
             {
-              distribn_t density, feq[Lattice::NUMVECTORS];
+              distribn_t density, feq[Lattice::NUMVECTORS], fOldBuffer[Lattice::NUMVECTORS];
               util::Vector3D<distribn_t> momentum;
               util::Vector3D<distribn_t> velocity;
 
-              Lattice::CalculateDensityMomentumFEq(latDat.GetSite(site).GetFOld<Lattice> (),
+              const distribn_t* fOld = latDat.GetSite(site).template GetFOld<Lattice> (fOldBuffer);
+
+              Lattice::CalculateDensityMomentumFEq(fOld,
                                                    density,
                                                    momentum[0],
                                                    momentum[1],
@@ -238,6 +240,10 @@ namespace hemelb
               {
                 cache.velocityCache.Put(site, velocity);
               }
+              if (cache.monitoringAccumulator.RequiresRefresh())
+              {
+                cache.monitoringAccumulator.Accumulate<Lattice>(density, velocity, fOld);
+              }
 
               // TODO stress cache filling not yet implemented.
             }
@@ -0,0 +1,330 @@
+// 
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+// 
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+// 
+
+#ifndef HEMELB_UNITTESTS_LBTESTS_PRECISIONTESTS_H
+#define HEMELB_UNITTESTS_LBTESTS_PRECISIONTESTS_H
+
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include "constants.h"
+#include "lb/LbmParameters.h"
+#include "lb/kernels/LBGK.h"
+#include "lb/lattices/D3Q15.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace lbtests
+    {
+      /**
+       * Largest difference we accept between the relative L2 velocity error of a run with the
+       * given distribution precision and that of the same run at DOUBLE precision.
+       */
+      template<class Precision>
+      struct ErrorTolerance;
+
+      template<>
+      struct ErrorTolerance<precision::SINGLE>
+      {
+          static double Get()
+          {
+            return 1e-3;
+          }
+      };
+
+      template<>
+      struct ErrorTolerance<precision::MIXED>
+      {
+          static double Get()
+          {
+            return 1e-5;
+          }
+      };
+
+      /**
+       * A plane channel of fluid sites between two walls, periodic along the flow, which is
+       * stepped with the LBGK kernel and stores its distributions between steps with the given
+       * precision policy, as LatticeData does for the configured one. Halfway bounce-back is used
+       * at the walls, which then lie half a lattice unit beyond the first and last sites.
+       */
+      template<class Precision>
+      class Channel
+      {
+        public:
+          typedef lb::lattices::D3Q15 LatticeType;
+          typedef lb::kernels::LBGK<LatticeType> Kernel;
+
+          Channel(site_t width, distribn_t tau) :
+            width(width), lbmParams(TimeStepForTau(tau), VoxelSize()), kernel(initParams),
+                distributions(width * LatticeType::NUMVECTORS)
+          {
+            for (site_t site = 0; site < width; ++site)
+            {
+              distribn_t fEq[LatticeType::NUMVECTORS];
+              LatticeType::CalculateFeq(1.0, 0.0, 0.0, 0.0, fEq);
+              Store(site, fEq);
+            }
+          }
+
+          /**
+           * Kinematic viscosity in lattice units.
+           */
+          distribn_t GetViscosity() const
+          {
+            return Cs2 * (lbmParams.GetTau() - 0.5);
+          }
+
+          /**
+           * Collide, apply a body force along x and stream.
+           * @param force
+           */
+          void Step(distribn_t force)
+          {
+            std::vector<distribn_t> streamed(distributions.size());
+            for (site_t site = 0; site < width; ++site)
+            {
+              distribn_t f[LatticeType::NUMVECTORS];
+              Load(site, f);
+
+              lb::kernels::HydroVars<Kernel> hydroVars(f);
+              kernel.CalculateDensityMomentumFeq(hydroVars, site);
+              kernel.Collide(&lbmParams, hydroVars);
+
+              for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+              {
+                distribn_t postCollision = hydroVars.GetFPostCollision()[direction]
+                    + 3.0 * LatticeType::EQMWEIGHTS[direction] * LatticeType::CX[direction] * force;
+
+                site_t destination = site + LatticeType::CY[direction];
+                if (destination >= 0 && destination < width)
+                {
+                  streamed[destination * LatticeType::NUMVECTORS + direction] = postCollision;
+                }
+                else
+                {
+                  streamed[site * LatticeType::NUMVECTORS + LatticeType::INVERSEDIRECTIONS[direction]]
+                      = postCollision;
+                }
+              }
+            }
+
+            for (site_t site = 0; site < width; ++site)
+            {
+              Store(site, &streamed[site * LatticeType::NUMVECTORS]);
+            }
+          }
+
+          /**
+           * The velocity along the channel at a site, given the force applied in the last step.
+           * @param site
+           * @param force
+           * @return
+           */
+          distribn_t GetVelocity(site_t site, distribn_t force) const
+          {
+            distribn_t f[LatticeType::NUMVECTORS];
+            Load(site, f);
+
+            distribn_t density = 0.0, momentum = 0.0;
+            for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+            {
+              density += f[direction];
+              momentum += LatticeType::CX[direction] * f[direction];
+            }
+            return (momentum + 0.5 * force) / density;
+          }
+
+        private:
+          /**
+           * The time step giving the requested relaxation time for blood at our voxel size.
+           * @param tau
+           * @return
+           */
+          static PhysicalTime TimeStepForTau(distribn_t tau)
+          {
+            return (tau - 0.5) * Cs2 * VoxelSize() * VoxelSize() * BLOOD_DENSITY_Kg_per_m3
+                / BLOOD_VISCOSITY_Pa_s;
+          }
+
+          static PhysicalDistance VoxelSize()
+          {
+            return 1e-4;
+          }
+
+          void Load(site_t site, distribn_t* f) const
+          {
+            for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+            {
+              f[direction] = Precision::Load(distributions[site * LatticeType::NUMVECTORS + direction],
+                                             LatticeType::EQMWEIGHTS[direction]);
+            }
+          }
+
+          void Store(site_t site, const distribn_t* f)
+          {
+            for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+            {
+              distributions[site * LatticeType::NUMVECTORS + direction]
+                  = Precision::Store(f[direction], LatticeType::EQMWEIGHTS[direction]);
+            }
+          }
+
+          const site_t width;
+          lb::LbmParameters lbmParams;
+          lb::kernels::InitParams initParams;
+          Kernel kernel;
+          std::vector<typename Precision::Storage> distributions;
+      };
+
+      /**
+       * Validate the reduced precision storage policies by running Poiseuille and Womersley flow
+       * in a plane channel at each precision, and checking that the L2 error in the velocity
+       * against the analytic solution stays within a stated tolerance of the DOUBLE run's.
+       */
+      class PrecisionTests : public CppUnit::TestFixture
+      {
+          CPPUNIT_TEST_SUITE( PrecisionTests);
+          CPPUNIT_TEST( TestPoiseuille);
+          CPPUNIT_TEST( TestWomersley);
+          CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void TestPoiseuille()
+          {
+            double doubleError = PoiseuilleError<precision::DOUBLE>();
+            CPPUNIT_ASSERT(doubleError < 1e-2);
+
+            CPPUNIT_ASSERT(std::abs(PoiseuilleError<precision::SINGLE>() - doubleError)
+                < ErrorTolerance<precision::SINGLE>::Get());
+            CPPUNIT_ASSERT(std::abs(PoiseuilleError<precision::MIXED>() - doubleError)
+                < ErrorTolerance<precision::MIXED>::Get());
+          }
+
+          void TestWomersley()
+          {
+            double doubleError = WomersleyError<precision::DOUBLE>();
+            CPPUNIT_ASSERT(doubleError < 2e-2);
+
+            CPPUNIT_ASSERT(std::abs(WomersleyError<precision::SINGLE>() - doubleError)
+                < ErrorTolerance<precision::SINGLE>::Get());
+            CPPUNIT_ASSERT(std::abs(WomersleyError<precision::MIXED>() - doubleError)
+                < ErrorTolerance<precision::MIXED>::Get());
+          }
+
+        private:
+          static const site_t Width = 16;
+          static const unsigned Steps = 4000;
+
+          /**
+           * The distance of a site from the channel centre line, and the channel half width.
+           */
+          static double DistanceFromCentre(site_t site)
+          {
+            return site - 0.5 * (Width - 1);
+          }
+
+          static double HalfWidth()
+          {
+            return 0.5 * Width;
+          }
+
+          /**
+           * Relative L2 norm of the difference between the channel's velocity profile and the
+           * expected one.
+           */
+          template<class Precision>
+          static void AccumulateError(const Channel<Precision>& channel,
+                                      const std::vector<double>& expected,
+                                      distribn_t force,
+                                      double& errorNorm,
+                                      double& expectedNorm)
+          {
+            for (site_t site = 0; site < Width; ++site)
+            {
+              double difference = channel.GetVelocity(site, force) - expected[site];
+              errorNorm += difference * difference;
+              expectedNorm += expected[site] * expected[site];
+            }
+          }
+
+          /**
+           * Drive the channel with a constant body force until it reaches steady state and
+           * compare with the parabolic profile.
+           */
+          template<class Precision>
+          static double PoiseuilleError()
+          {
+            Channel<Precision> channel(Width, 1.0);
+            // A peak velocity of 0.01, i.e. a low Mach number flow.
+            const distribn_t force = 0.02 * channel.GetViscosity() / (HalfWidth() * HalfWidth());
+
+            for (unsigned step = 0; step < Steps; ++step)
+            {
+              channel.Step(force);
+            }
+
+            std::vector<double> expected(Width);
+            for (site_t site = 0; site < Width; ++site)
+            {
+              double y = DistanceFromCentre(site);
+              expected[site] = force / (2.0 * channel.GetViscosity()) * (HalfWidth() * HalfWidth() - y * y);
+            }
+
+            double errorNorm = 0.0, expectedNorm = 0.0;
+            AccumulateError(channel, expected, force, errorNorm, expectedNorm);
+            return std::sqrt(errorNorm / expectedNorm);
+          }
+
+          /**
+           * Drive the channel with an oscillating body force until the start-up transient has
+           * decayed, then compare with the analytic profile over the last period.
+           */
+          template<class Precision>
+          static double WomersleyError()
+          {
+            const unsigned period = 400;
+            const double omega = 2.0 * PI / period;
+
+            Channel<Precision> channel(Width, 1.0);
+            const distribn_t peakForce = 0.02 * channel.GetViscosity() / (HalfWidth() * HalfWidth());
+            const std::complex<double> k = std::sqrt(std::complex<double>(0.0, omega / channel.GetViscosity()));
+
+            double errorNorm = 0.0, expectedNorm = 0.0;
+            for (unsigned step = 0; step < Steps; ++step)
+            {
+              // The force acts over the step, so take its value half way through.
+              distribn_t force = peakForce * std::cos(omega * (step + 0.5));
+              channel.Step(force);
+
+              if (step + period >= Steps && step % (period / 8) == 0)
+              {
+                std::vector<double> expected(Width);
+                std::complex<double> phase = std::exp(std::complex<double>(0.0, omega * (step + 1)));
+                for (site_t site = 0; site < Width; ++site)
+                {
+                  std::complex<double> shape = 1.0 - std::cosh(k * DistanceFromCentre(site))
+                      / std::cosh(k * HalfWidth());
+                  expected[site] = std::real(peakForce / std::complex<double>(0.0, omega) * shape * phase);
+                }
+                AccumulateError(channel, expected, force, errorNorm, expectedNorm);
+              }
+            }
+            return std::sqrt(errorNorm / expectedNorm);
+          }
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION( PrecisionTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_LBTESTS_PRECISIONTESTS_H */
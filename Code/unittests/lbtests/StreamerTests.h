@@ -11,7 +11,10 @@
 #define HEMELB_UNITTESTS_LBTESTS_STREAMERTESTS_H
 
 #include <cppunit/TestFixture.h>
+#include <algorithm>
+#include <cfloat>
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 #include "lb/streamers/Streamers.h"
@@ -38,9 +41,12 @@ namespace hemelb
       {
           CPPUNIT_TEST_SUITE ( StreamerTests);
           CPPUNIT_TEST ( TestSimpleCollideAndStream);
+          CPPUNIT_TEST ( TestMonitoringAccumulator);
           CPPUNIT_TEST ( TestBouzidiFirdaousLallemand);
           CPPUNIT_TEST ( TestSimpleBounceBack);
+#ifndef HEMELB_USE_AA_PATTERN
           CPPUNIT_TEST ( TestGuoZhengShi);
+#endif
           CPPUNIT_TEST ( TestNashZerothOrderPressureIolet);
           CPPUNIT_TEST ( TestNashZerothOrderPressureBB);
           CPPUNIT_TEST ( TestJunkYangEquivalentToBounceBack);CPPUNIT_TEST_SUITE_END();
@@ -86,8 +92,9 @@ namespace hemelb
               geometry::Site < geometry::LatticeData > streamedSite
                   = latDat->GetSite(streamedToSite);
 
-              distribn_t* streamedToFNew = latDat->GetFNew(lb::lattices::D3Q15::NUMVECTORS
-                  * streamedToSite);
+              distribn_t streamedToFNewBuffer[lb::lattices::D3Q15::NUMVECTORS];
+              const distribn_t* streamedToFNew =
+                  latDat->GetSiteFNew<lb::lattices::D3Q15>(streamedToSite, streamedToFNewBuffer);
 
               for (unsigned int streamedDirection = 0; streamedDirection
                   < lb::lattices::D3Q15::NUMVECTORS; ++streamedDirection)
@@ -126,6 +133,57 @@ namespace hemelb
             }
           }
 
+          void TestMonitoringAccumulator()
+          {
+            lb::streamers::SimpleCollideAndStream<lb::collisions::Normal<lb::kernels::LBGK<
+                lb::lattices::D3Q15> > > simpleCollideAndStream(initParams);
+
+            LbTestsHelper::InitialiseAnisotropicTestData<lb::lattices::D3Q15>(latDat);
+
+            propertyCache->monitoringAccumulator.SetRefreshFlag();
+            simpleCollideAndStream.StreamAndCollide<false> (0,
+                                                            latDat->GetLocalFluidSiteCount(),
+                                                            lbmParams,
+                                                            latDat,
+                                                            *propertyCache);
+
+            // Work out the same reductions by sweeping over the sites afterwards.
+            distribn_t minDensity = DBL_MAX, maxDensity = -DBL_MAX, maxVelocity = 0.0;
+            bool nonPositive = false;
+            for (site_t siteIndex = 0; siteIndex < latDat->GetLocalFluidSiteCount(); ++siteIndex)
+            {
+              distribn_t fOld[lb::lattices::D3Q15::NUMVECTORS];
+              LbTestsHelper::InitialiseAnisotropicTestData<lb::lattices::D3Q15>(siteIndex, fOld);
+
+              lb::kernels::HydroVars<lb::kernels::LBGK<lb::lattices::D3Q15> > hydroVars(fOld);
+              normalCollision->CalculatePreCollision(hydroVars, latDat->GetSite(siteIndex));
+              normalCollision->Collide(lbmParams, hydroVars);
+
+              minDensity = std::min(minDensity, hydroVars.density);
+              maxDensity = std::max(maxDensity, hydroVars.density);
+              maxVelocity = std::max(maxVelocity, hydroVars.velocity.GetMagnitude());
+              for (unsigned direction = 0; direction < lb::lattices::D3Q15::NUMVECTORS; ++direction)
+              {
+                nonPositive |= ! (hydroVars.GetFPostCollision()[direction] > 0.0);
+              }
+            }
+
+            const lb::MonitoringAccumulator& accumulator = propertyCache->monitoringAccumulator;
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(minDensity, accumulator.GetMinDensity(), allowedError);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(maxDensity, accumulator.GetMaxDensity(), allowedError);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(maxVelocity, accumulator.GetMaxVelocityMagnitude(), allowedError);
+            CPPUNIT_ASSERT_EQUAL(nonPositive, accumulator.IsNonPositiveDistributionPresent());
+
+            // A stray NaN on a later step must be picked up.
+            simState->Increment();
+            distribn_t fOld[lb::lattices::D3Q15::NUMVECTORS];
+            LbTestsHelper::InitialiseAnisotropicTestData<lb::lattices::D3Q15>(0, fOld);
+            fOld[0] = std::numeric_limits<distribn_t>::quiet_NaN();
+            latDat->SetFOld<lb::lattices::D3Q15>(0, fOld);
+            simpleCollideAndStream.StreamAndCollide<false> (0, 1, lbmParams, latDat, *propertyCache);
+            CPPUNIT_ASSERT(accumulator.IsNonPositiveDistributionPresent());
+          }
+
           void TestBouzidiFirdaousLallemand()
           {
             // Initialise fOld in the lattice data. We choose values so that each site has
@@ -152,8 +210,9 @@ namespace hemelb
               const geometry::Site<geometry::LatticeData> streamedSite =
                   latDat->GetSite(streamedToSite);
 
-              distribn_t* streamedToFNew = latDat->GetFNew(lb::lattices::D3Q15::NUMVECTORS
-                  * streamedToSite);
+              distribn_t streamedToFNewBuffer[lb::lattices::D3Q15::NUMVECTORS];
+              const distribn_t* streamedToFNew =
+                  latDat->GetSiteFNew<lb::lattices::D3Q15>(streamedToSite, streamedToFNewBuffer);
 
               for (unsigned int streamedDirection = 0; streamedDirection
                   < lb::lattices::D3Q15::NUMVECTORS; ++streamedDirection)
@@ -278,9 +337,9 @@ namespace hemelb
                     // Assert that this is the case.
                     CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(msg.str(),
                                                          streamed,
-                                                         * (latDat->GetFNew(streamedToSite
+                                                         latDat->ReadFNew(streamedToSite
                                                              * lb::lattices::D3Q15::NUMVECTORS
-                                                             + streamedDirection)),
+                                                             + streamedDirection, streamedDirection),
                                                          allowedError);
                   }
 
@@ -293,9 +352,9 @@ namespace hemelb
 
                     CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(msg.str(),
                                                          hydroVars.GetFPostCollision()[oppDirection],
-                                                         * (latDat->GetFNew(streamedToSite
+                                                         latDat->ReadFNew(streamedToSite
                                                              * lb::lattices::D3Q15::NUMVECTORS
-                                                             + streamedDirection)),
+                                                             + streamedDirection, streamedDirection),
                                                          allowedError);
                   }
                 }
@@ -366,8 +425,9 @@ namespace hemelb
               site_t streamedToSite = firstWallSite + wallSiteLocalIndex;
               const geometry::Site<geometry::LatticeData> streamedSite =
                   latDat->GetSite(streamedToSite);
-              distribn_t* streamedToFNew = latDat->GetFNew(lb::lattices::D3Q15::NUMVECTORS
-                  * streamedToSite);
+              distribn_t streamedToFNewBuffer[lb::lattices::D3Q15::NUMVECTORS];
+              const distribn_t* streamedToFNew =
+                  latDat->GetSiteFNew<lb::lattices::D3Q15>(streamedToSite, streamedToFNewBuffer);
 
               for (unsigned int streamedDirection = 0; streamedDirection
                   < lb::lattices::D3Q15::NUMVECTORS; ++streamedDirection)
@@ -434,6 +494,7 @@ namespace hemelb
             }
           }
 
+#ifndef HEMELB_USE_AA_PATTERN
           void TestGuoZhengShi()
           {
             lb::streamers::GuoZhengShi<lb::collisions::Normal<
@@ -553,8 +614,8 @@ namespace hemelb
                     distribn_t prediction = fEqm[streamedDirection] + (1.0 + lbmParams->GetOmega())
                         * fNeqWall;
                     // This is the answer from the code we're testing
-                    distribn_t streamedFNew = latDat->GetFNew(lb::lattices::D3Q15::NUMVECTORS
-                        * chosenSite)[streamedDirection];
+                    distribn_t streamedFNew = latDat->ReadFNew(lb::lattices::D3Q15::NUMVECTORS
+                        * chosenSite + streamedDirection, streamedDirection);
 
                     CPPUNIT_ASSERT_DOUBLES_EQUAL(prediction, streamedFNew, allowedError);
                     break;
@@ -569,8 +630,8 @@ namespace hemelb
                       Direction inv = lb::lattices::D3Q15::INVERSEDIRECTIONS[streamedDirection];
                       distribn_t prediction = streamerHydroVars.GetFPostCollision()[inv];
                       // This is the answer from the code we're testing
-                      distribn_t streamedFNew = latDat->GetFNew(lb::lattices::D3Q15::NUMVECTORS
-                          * chosenSite)[streamedDirection];
+                      distribn_t streamedFNew = latDat->ReadFNew(lb::lattices::D3Q15::NUMVECTORS
+                          * chosenSite + streamedDirection, streamedDirection);
                       CPPUNIT_ASSERT_DOUBLES_EQUAL(prediction, streamedFNew, allowedError);
                     }
                     else
@@ -599,8 +660,8 @@ namespace hemelb
                       distribn_t prediction = fEqm[streamedDirection] + (1.0
                           + lbmParams->GetOmega()) * fNeqWall;
                       // This is the answer from the code we're testing
-                      distribn_t streamedFNew = latDat->GetFNew(lb::lattices::D3Q15::NUMVECTORS
-                          * chosenSite)[streamedDirection];
+                      distribn_t streamedFNew = latDat->ReadFNew(lb::lattices::D3Q15::NUMVECTORS
+                          * chosenSite + streamedDirection, streamedDirection);
 
                       CPPUNIT_ASSERT_DOUBLES_EQUAL(prediction, streamedFNew, allowedError);
 
@@ -614,7 +675,7 @@ namespace hemelb
                     // We have nothing to do with a wall so simple streaming
                     const site_t streamedIndex =
                         streamer.GetStreamedIndex<lb::lattices::D3Q15> (streamedDirection);
-                    distribn_t streamedToFNew = *latDat->GetFNew(streamedIndex);
+                    distribn_t streamedToFNew = latDat->ReadFNew(streamedIndex, streamedDirection);
 
                     // F_new should be equal to the value that was streamed from this other site
                     // in the same direction as we're streaming from.
@@ -627,6 +688,7 @@ namespace hemelb
               }
             }
           }
+#endif
 
           /**
            * Junk&Yang should behave like simple bounce back when fluid sites are 0.5 lattice length units away
@@ -705,8 +767,9 @@ namespace hemelb
               site_t streamedToSite = firstWallSite + wallSiteLocalIndex;
               const geometry::Site<geometry::LatticeData> streamedSite =
                   latDat->GetSite(streamedToSite);
-              distribn_t* streamedToFNew = latDat->GetFNew(lb::lattices::D3Q15::NUMVECTORS
-                  * streamedToSite);
+              distribn_t streamedToFNewBuffer[lb::lattices::D3Q15::NUMVECTORS];
+              const distribn_t* streamedToFNew =
+                  latDat->GetSiteFNew<lb::lattices::D3Q15>(streamedToSite, streamedToFNewBuffer);
 
               for (unsigned int streamedDirection = 0; streamedDirection
                   < lb::lattices::D3Q15::NUMVECTORS; ++streamedDirection)
@@ -843,7 +906,7 @@ namespace hemelb
                 if (!streamer.HasIolet(streamedDirection) && streamedIndex >= 0 && streamedIndex
                     < (lb::lattices::D3Q15::NUMVECTORS * latDat->GetLocalFluidSiteCount()))
                 {
-                  distribn_t streamedToFNew = *latDat->GetFNew(streamedIndex);
+                  distribn_t streamedToFNew = latDat->ReadFNew(streamedIndex, streamedDirection);
 
                   // F_new should be equal to the value that was streamed from this other site
                   // in the same direction as we're streaming from.
@@ -878,8 +941,9 @@ namespace hemelb
                                                                         ghostSiteMomentum.z,
                                                                         ghostPostCollision);
 
-                  CPPUNIT_ASSERT_DOUBLES_EQUAL(latDat->GetFNew(chosenSite
-                                                   * lb::lattices::D3Q15::NUMVECTORS)[chosenUnstreamedDirection],
+                  CPPUNIT_ASSERT_DOUBLES_EQUAL(latDat->ReadFNew(chosenSite
+                                                   * lb::lattices::D3Q15::NUMVECTORS + chosenUnstreamedDirection,
+                                                   chosenUnstreamedDirection),
                                                ghostPostCollision[chosenUnstreamedDirection],
                                                allowedError);
                 }
@@ -960,7 +1024,7 @@ namespace hemelb
                     && streamedIndex >= 0 && streamedIndex < (lb::lattices::D3Q15::NUMVECTORS
                     * latDat->GetLocalFluidSiteCount()))
                 {
-                  distribn_t streamedToFNew = *latDat->GetFNew(streamedIndex);
+                  distribn_t streamedToFNew = latDat->ReadFNew(streamedIndex, streamedDirection);
 
                   // F_new should be equal to the value that was streamed from this other site
                   // in the same direction as we're streaming from.
@@ -975,8 +1039,8 @@ namespace hemelb
                 // Check the case by a wall.
                 if (streamer.HasWall(streamedDirection))
                 {
-                  distribn_t streamedToFNew = *latDat->GetFNew(lb::lattices::D3Q15::NUMVECTORS
-                      * chosenSite + inverseDirection);
+                  distribn_t streamedToFNew = latDat->ReadFNew(lb::lattices::D3Q15::NUMVECTORS
+                      * chosenSite + inverseDirection, inverseDirection);
 
                   CPPUNIT_ASSERT_DOUBLES_EQUAL(streamerHydroVars.GetFPostCollision()[streamedDirection],
                                                streamedToFNew,
@@ -1009,8 +1073,9 @@ namespace hemelb
                                                                         ghostSiteMomentum.z,
                                                                         ghostPostCollision);
 
-                  CPPUNIT_ASSERT_DOUBLES_EQUAL(latDat->GetFNew(chosenSite
-                                                   * lb::lattices::D3Q15::NUMVECTORS)[chosenUnstreamedDirection],
+                  CPPUNIT_ASSERT_DOUBLES_EQUAL(latDat->ReadFNew(chosenSite
+                                                   * lb::lattices::D3Q15::NUMVECTORS + chosenUnstreamedDirection,
+                                                   chosenUnstreamedDirection),
                                                ghostPostCollision[chosenUnstreamedDirection],
                                                allowedError);
                 }
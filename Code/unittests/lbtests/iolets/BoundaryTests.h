@@ -66,6 +66,11 @@ namespace hemelb
 
               CPPUNIT_ASSERT_DOUBLES_EQUAL(pressureToDensity(80.0 + 1.0), inlets->GetBoundaryDensity(0), 1e-9);
 
+              // The per-step values are only brought up to date by FinishReceive.
+              CPPUNIT_ASSERT_DOUBLES_EQUAL(pressureToDensity(80.0 - 1.0), inlets->GetCurrentDensity(0), 1e-9);
+              inlets->FinishReceive();
+              CPPUNIT_ASSERT_DOUBLES_EQUAL(pressureToDensity(80.0 + 1.0), inlets->GetCurrentDensity(0), 1e-9);
+
               while (simState->Get0IndexedTimeStep() < simState->GetTotalTimeSteps() / 10)
               {
                 simState->Increment();
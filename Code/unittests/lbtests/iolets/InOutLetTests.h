@@ -14,6 +14,7 @@
 
 #include "unittests/helpers/FolderTestFixture.h"
 #include "lb/iolets/InOutLets.h"
+#include "util/Bessel.h"
 #include "resources/Resource.h"
 #include "debug/Debugger.h"
 
@@ -55,7 +56,9 @@ namespace hemelb
             CPPUNIT_TEST(TestIoletCoordinates);
             CPPUNIT_TEST(TestParabolicVelocityConstruct);
             CPPUNIT_TEST(TestWomersleyVelocityConstruct);
-            CPPUNIT_TEST(TestFileVelocityConstruct);CPPUNIT_TEST_SUITE_END();
+            CPPUNIT_TEST(TestWomersleyProfileTable);
+            CPPUNIT_TEST(TestFileVelocityConstruct);
+            CPPUNIT_TEST(TestWindkessel);CPPUNIT_TEST_SUITE_END();
           public:
             void setUp()
             {
@@ -277,6 +280,43 @@ namespace hemelb
 
             }
 
+            void TestWomersleyProfileTable()
+            {
+              InOutLetWomersleyVelocity womersley;
+              womersley.SetPosition(LatticePosition(10, 10, 0));
+              womersley.SetNormal(util::Vector3D<Dimensionless>(0, 0, 1));
+              womersley.SetRadius(8.0);
+              womersley.SetPressureGradientAmplitude(1e-5);
+              womersley.SetPeriod(1000.0);
+              womersley.SetWomersleyNumber(12.0);
+              womersley.Initialise(NULL);
+
+              // The tabulated profile must match the analytical one away from the table's points,
+              // including in the boundary layer near the wall, at any phase.
+              const std::complex<double> iPowThreeHalves = pow(std::complex<double>(0, 1), 1.5);
+              const double omega = 2.0 * PI / womersley.GetPeriod();
+              const double radii[] = { 0.3, 2.71, 5.5, 7.3, 7.77, 7.99 };
+              for (unsigned j = 0; j < 6; ++j)
+              {
+                for (LatticeTimeStep t = 0; t < 1000; t += 173)
+                {
+                  const std::complex<double> profile = 1.0
+                      - util::BesselJ0ComplexArgument(iPowThreeHalves * 12.0 * radii[j] / 8.0)
+                          / util::BesselJ0ComplexArgument(iPowThreeHalves * 12.0);
+                  const double expected = -1e-5 / omega
+                      * std::real(profile * std::exp(std::complex<double>(0, omega * t)));
+
+                  LatticeVelocity velocity = womersley.GetVelocity(LatticePosition(10 + radii[j],
+                                                                                   10,
+                                                                                   3),
+                                                                   t);
+                  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, velocity.x, 1e-12);
+                  CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, velocity.y, 1e-12);
+                  CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, velocity.z, 1e-6 * 1e-5 / omega);
+                }
+              }
+            }
+
             void TestFileVelocityConstruct()
             {
               // We have to move to a tempdir, as the path specified in the xml file is a relative path
@@ -332,6 +372,18 @@ namespace hemelb
                 CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0075, physVelPointEqui[2], 1e-9);
               }
 
+              // The same once the maximum speed has been worked out for the time step, as the
+              // BoundaryValues do before streaming.
+              fileVel->UpdateToTimeStep(converter.ConvertTimeToLatticeUnits(3.0));
+              {
+                LatticeVelocity velAtPointEquidistant(fileVel->GetVelocity(pointEquidistant,
+                                                                           converter.ConvertTimeToLatticeUnits(3.0)));
+                PhysicalVelocity physVelPointEqui =
+                    converter.ConvertVelocityToPhysicalUnits(velAtPointEquidistant);
+
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0075, physVelPointEqui[2], 1e-9);
+              }
+
               FolderTestFixture::tearDown();
             }
 
@@ -359,6 +411,52 @@ namespace hemelb
                 }
             };
 
+            void TestWindkessel()
+            {
+              InOutLetWindkessel windkessel;
+              windkessel.SetProximalResistance(2.0);
+              windkessel.SetDistalResistance(10.0);
+              windkessel.SetCompliance(5.0);
+              windkessel.SetDistalPressure(1.1 * Cs2);
+
+              // At rest, the pressure is the distal pressure.
+              CPPUNIT_ASSERT_DOUBLES_EQUAL(1.1, windkessel.GetDensity(0), 1e-12);
+
+              // The first step charges the compliance by backward Euler.
+              const LatticeFlowRate flowRate = 1e-3;
+              windkessel.UpdateFlowRate(flowRate);
+              const LatticePressure capacitorPressure = (5.0 * 1.1 * Cs2 + flowRate + 1.1 * Cs2 / 10.0)
+                  / (5.0 + 1.0 / 10.0);
+              CPPUNIT_ASSERT_DOUBLES_EQUAL(capacitorPressure + 2.0 * flowRate,
+                                           windkessel.GetPressure(),
+                                           1e-12);
+
+              // Take a copy of the state part way through.
+              std::vector<distribn_t> checkpoint;
+              windkessel.SaveToCheckpoint(checkpoint);
+              CPPUNIT_ASSERT_EQUAL((size_t) 4, checkpoint.size());
+
+              // With a steady flow it settles, after many time constants (RC = 50 steps), to the
+              // distal pressure plus the flow across both resistances.
+              for (unsigned step = 0; step < 2000; ++step)
+              {
+                windkessel.UpdateFlowRate(flowRate);
+              }
+              CPPUNIT_ASSERT_DOUBLES_EQUAL(1.1 * Cs2 + 12.0 * flowRate, windkessel.GetPressure(), 1e-12);
+              CPPUNIT_ASSERT_DOUBLES_EQUAL(1.1, windkessel.GetDensityMin(), 1e-12);
+              CPPUNIT_ASSERT_DOUBLES_EQUAL(windkessel.GetDensity(0), windkessel.GetDensityMax(), 1e-12);
+
+              // Restoring the copy picks up from where it was taken.
+              InOutLetWindkessel* restored = static_cast<InOutLetWindkessel*>(windkessel.Clone());
+              std::vector<distribn_t>::const_iterator state = checkpoint.begin();
+              restored->RestoreFromCheckpoint(state);
+              CPPUNIT_ASSERT(state == checkpoint.end());
+              CPPUNIT_ASSERT_DOUBLES_EQUAL(capacitorPressure + 2.0 * flowRate,
+                                           restored->GetPressure(),
+                                           1e-12);
+              delete restored;
+            }
+
             void TestIoletCoordinates()
             {
               // unit converter - make physical and lattice units the same
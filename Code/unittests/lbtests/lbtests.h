@@ -19,5 +19,7 @@
 #include "unittests/lbtests/iolets/BoundaryTests.h"
 #include "unittests/lbtests/iolets/InOutLetTests.h"
 #include "unittests/lbtests/VirtualSiteIoletStreamerTests.h"
+#include "unittests/lbtests/CheckpointerTests.h"
+#include "unittests/lbtests/PrecisionTests.h"
 
 #endif /* HEMELB_UNITTESTS_LBTESTS_LBTESTS_H */
@@ -22,6 +22,7 @@
 #include "unittests/configuration/configuration.h"
 #include "unittests/geometry/geometry.h"
 #include "unittests/SimulationMasterTests.h"
+#include "unittests/RebalancingTests.h"
 #include "unittests/extraction/extraction.h"
 #include "unittests/net/net.h"
 #include "unittests/multiscale/multiscale.h"
@@ -30,6 +30,7 @@ namespace hemelb
         public:
         CPPUNIT_TEST_SUITE (MpiTests);
         CPPUNIT_TEST (TestMpiComm);
+        CPPUNIT_TEST (TestExclusiveScan);
         CPPUNIT_TEST_SUITE_END();
 
           void TestMpiComm()
@@ -60,6 +61,14 @@ namespace hemelb
               CPPUNIT_ASSERT(commWorld2 != commWorld);
             }
           }
+
+          void TestExclusiveScan()
+          {
+            MpiCommunicator commWorld = MpiCommunicator::World();
+            // Rank r contributes r + 1, so the sum over the lower ranks is r(r + 1) / 2.
+            const uint64_t lower = commWorld.ExclusiveScan(uint64_t(commWorld.Rank() + 1), MPI_SUM);
+            CPPUNIT_ASSERT_EQUAL(uint64_t(commWorld.Rank() * (commWorld.Rank() + 1) / 2), lower);
+          }
       };
       CPPUNIT_TEST_SUITE_REGISTRATION (MpiTests);
     }
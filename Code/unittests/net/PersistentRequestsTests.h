@@ -0,0 +1,183 @@
+//
+// Copyright (C) University College London, 2007-2012, all rights reserved.
+//
+// This file is part of HemeLB and is CONFIDENTIAL. You may not work
+// with, install, use, duplicate, modify, redistribute or share this
+// file, or any part thereof, other than as allowed by any agreement
+// specifically made by you with University College London.
+//
+
+
+#ifndef HEMELB_UNITTESTS_NET_PERSISTENTREQUESTSTESTS_H
+#define HEMELB_UNITTESTS_NET_PERSISTENTREQUESTSTESTS_H
+
+#include <cppunit/TestFixture.h>
+#include "net/PersistentRequests.h"
+#include "net/MpiDataType.h"
+#include "net/MpiError.h"
+#include "Exception.h"
+#include "unittests/helpers/HasCommsTestFixture.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace net
+    {
+      using namespace hemelb::net;
+
+      /**
+       * Exchange the same messages over several steps through one set of persistent requests,
+       * described by struct types or packed.
+       */
+      class PersistentRequestsTests : public helpers::HasCommsTestFixture
+      {
+          CPPUNIT_TEST_SUITE( PersistentRequestsTests);
+          CPPUNIT_TEST( TestStructTypes);
+          CPPUNIT_TEST( TestPacked);
+          CPPUNIT_TEST( TestStructTypesScatteredReceive);
+          CPPUNIT_TEST( TestPackedScatteredReceive);
+          CPPUNIT_TEST( TestFixedOnceStarted);
+          CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void TestStructTypes()
+          {
+            CheckExchanges(false);
+          }
+
+          void TestPacked()
+          {
+            CheckExchanges(true);
+          }
+
+          void TestStructTypesScatteredReceive()
+          {
+            CheckScatteredReceive(false);
+          }
+
+          void TestPackedScatteredReceive()
+          {
+            CheckScatteredReceive(true);
+          }
+
+          void TestFixedOnceStarted()
+          {
+            int sent = 1, received = 0;
+            PersistentRequests requests(Comms(), tag);
+            requests.RequestSend(&sent, 1, Comms().Rank());
+            requests.RequestReceive(&received, 1, Comms().Rank());
+            requests.StartReceives();
+            requests.StartSends();
+            requests.Wait();
+            CPPUNIT_ASSERT_EQUAL(1, received);
+
+            bool threw = false;
+            try
+            {
+              requests.RequestSend(&sent, 1, Comms().Rank());
+            }
+            catch (Exception& e)
+            {
+              threw = true;
+            }
+            CPPUNIT_ASSERT(threw);
+          }
+
+        private:
+          static const int tag = 20;
+
+          /**
+           * Pass a contiguous array round a ring of the ranks, received through an indexed type
+           * that scatters it, as the lattice receives its halo.
+           */
+          void CheckScatteredReceive(bool pack)
+          {
+            proc_t rank = Comms().Rank();
+            proc_t size = Comms().Size();
+            proc_t from = (rank + size - 1) % size;
+
+            int displacements[4] = { 6, 0, 4, 2 };
+            MPI_Datatype scattered;
+            HEMELB_MPI_CALL(MPI_Type_create_indexed_block,
+                            (4, 1, displacements, MpiDataType<double>(), &scattered));
+            HEMELB_MPI_CALL(MPI_Type_commit, (&scattered));
+
+            double sent[4], received[8];
+            {
+              PersistentRequests requests(Comms(), tag, pack);
+              requests.RequestSend(sent, 4, (rank + 1) % size);
+              requests.RequestReceive(received, 1, from, scattered);
+
+              for (int step = 0; step < 3; ++step)
+              {
+                for (int ii = 0; ii < 8; ++ii)
+                {
+                  received[ii] = -1.0;
+                }
+                requests.StartReceives();
+
+                for (int ii = 0; ii < 4; ++ii)
+                {
+                  sent[ii] = 100.0 * rank + 10.0 * step + ii;
+                }
+                requests.StartSends();
+                requests.Wait();
+
+                for (int ii = 0; ii < 4; ++ii)
+                {
+                  CPPUNIT_ASSERT_EQUAL(100.0 * from + 10.0 * step + ii, received[displacements[ii]]);
+                  // The gaps are left alone.
+                  CPPUNIT_ASSERT_EQUAL(-1.0, received[2 * ii + 1]);
+                }
+              }
+            }
+            HEMELB_MPI_CALL(MPI_Type_free, (&scattered));
+          }
+
+          /**
+           * Send several arrays of different types to this rank itself.
+           */
+          void CheckExchanges(bool pack)
+          {
+            proc_t self = Comms().Rank();
+            int sentInts[3], receivedInts[3];
+            double sentDoubles[2], receivedDoubles[2];
+
+            PersistentRequests requests(Comms(), tag, pack);
+            requests.RequestSend(sentInts, 3, self);
+            requests.RequestSend(sentDoubles, 2, self);
+            requests.RequestReceive(receivedInts, 3, self);
+            requests.RequestReceive(receivedDoubles, 2, self);
+            // Nothing is set up for empty messages.
+            requests.RequestSend(sentInts, 0, (self + 1) % Comms().Size());
+
+            for (int step = 0; step < 4; ++step)
+            {
+              for (int ii = 0; ii < 3; ++ii)
+              {
+                sentInts[ii] = 10 * step + ii;
+              }
+              sentDoubles[0] = step + 0.5;
+              sentDoubles[1] = -step - 0.25;
+
+              requests.StartReceives();
+              requests.StartSends();
+              requests.Wait();
+
+              for (int ii = 0; ii < 3; ++ii)
+              {
+                CPPUNIT_ASSERT_EQUAL(sentInts[ii], receivedInts[ii]);
+              }
+              CPPUNIT_ASSERT_EQUAL(sentDoubles[0], receivedDoubles[0]);
+              CPPUNIT_ASSERT_EQUAL(sentDoubles[1], receivedDoubles[1]);
+            }
+          }
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION( PersistentRequestsTests);
+    }
+  }
+}
+
+#endif // HEMELB_UNITTESTS_NET_PERSISTENTREQUESTSTESTS_H
@@ -12,5 +12,6 @@
 
 #include "unittests/net/phased/phased.h"
 #include "unittests/net/MpiTests.h"
+#include "unittests/net/PersistentRequestsTests.h"
 
 #endif
@@ -184,6 +184,18 @@ namespace hemelb
           {
             scale_factor = latticeMass / (latticeDistance * latticeDistance * latticeTime * latticeTime);
           }
+          else if (units == "Pa*s/m^3")
+          {
+            // Resistance, a pressure difference per volume flow rate.
+            scale_factor = latticeMass
+                / (latticeDistance * latticeDistance * latticeDistance * latticeDistance * latticeTime);
+          }
+          else if (units == "m^3/Pa")
+          {
+            // Compliance, a volume per pressure difference.
+            scale_factor = latticeDistance * latticeDistance * latticeDistance * latticeDistance
+                * latticeTime * latticeTime / latticeMass;
+          }
           else
           {
             throw Exception() << "Unknown units '" << units << "'";
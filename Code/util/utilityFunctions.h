@@ -11,6 +11,7 @@
 #define HEMELB_UTIL_UTILITYFUNCTIONS_H
 
 #include "log/Logger.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <cstdlib>
@@ -135,6 +136,25 @@ namespace hemelb
           return (yVector[lowerIndex] + (targetX - xVector[lowerIndex]) / (xVector[lowerIndex + 1]
               - xVector[lowerIndex]) * (yVector[lowerIndex + 1] - yVector[lowerIndex]));
         }
+
+        /**
+         * As LinearInterpolate, but finds the interval by bisection, so is cheap enough to call
+         * every time step. The x values must be strictly increasing; targetX is clamped to the
+         * first and last intervals. Gives exactly the same result as LinearInterpolate within
+         * the range, as it picks the same (lowest) interval containing targetX.
+         */
+        template<typename T>
+        static T LinearInterpolateSorted(const std::vector<T> &xVector,
+                                         const std::vector<T> &yVector, T targetX)
+        {
+          // The first point not below targetX ends the interval.
+          size_t upperIndex = std::lower_bound(xVector.begin(), xVector.end(), targetX)
+              - xVector.begin();
+          size_t lowerIndex = enforceBounds<size_t>(upperIndex, 1, xVector.size() - 1) - 1;
+
+          return (yVector[lowerIndex] + (targetX - xVector[lowerIndex]) / (xVector[lowerIndex + 1]
+              - xVector[lowerIndex]) * (yVector[lowerIndex + 1] - yVector[lowerIndex]));
+        }
     };
 
     class NumericalMethods
@@ -0,0 +1,185 @@
+# 
+# Copyright (C) University College London, 2007-2012, all rights reserved.
+# 
+# This file is part of HemeLB and is CONFIDENTIAL. You may not work 
+# with, install, use, duplicate, modify, redistribute or share this
+# file, or any part thereof, other than as allowed by any agreement
+# specifically made by you with University College London.
+# 
+
+"""Convert a HemeLB geometry file (.gmy) from the XDR site-by-site format
+(version 4) into the columnar format (version 5) that HemeLB can copy straight
+into its arrays while reading.
+
+The preamble and header keep their layout. Each block is rewritten as a run of
+little-endian arrays (site types, cut types, wall normal flags, cut distances,
+inlet/outlet IDs and wall normals) and compressed with the chosen codec: zlib
+by default or, for HemeLB builds with HEMELB_USE_LZ4, LZ4.
+
+This module only needs the standard library (and the lz4 package for the LZ4
+codec); run it as a script with no arguments for usage.
+"""
+import struct
+import zlib
+
+HemeLbMagicNumber = 0x686c6221
+GeometryMagicNumber = 0x676d7904
+VersionNumber = 4
+ColumnarVersionNumber = 5
+
+CODEC_ZLIB = 0
+CODEC_LZ4 = 1
+Codecs = {'zlib': CODEC_ZLIB, 'lz4': CODEC_LZ4}
+
+PreambleLength = 32
+HeaderRecordLength = 12
+NumberOfDisplacements = 26
+
+SOLID = 0
+FLUID = 1
+CUT_NONE = 0
+CUT_WALL = 1
+WALL_NORMAL_AVAILABLE = 1
+
+
+class XdrBlockReader(object):
+    """Reads the big-endian (XDR) values of one decompressed version 4 block.
+    """
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+        return
+
+    def _Unpack(self, fmt):
+        value, = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += 4
+        return value
+
+    def UInt(self):
+        return self._Unpack('>I')
+
+    def Float(self):
+        return self._Unpack('>f')
+
+    def AtEnd(self):
+        return self.pos == len(self.data)
+    pass
+
+
+def ConvertBlock(data, sitesPerBlock):
+    """Turn one decompressed version 4 block into the uncompressed columnar
+    representation.
+    """
+    reader = XdrBlockReader(data)
+    siteTypes = []
+    cutTypes = []
+    normalAvailable = []
+    distances = []
+    ioletIds = []
+    normals = []
+
+    for i in range(sitesPerBlock):
+        siteType = reader.UInt()
+        siteTypes.append(siteType)
+        if siteType != FLUID:
+            continue
+
+        for d in range(NumberOfDisplacements):
+            cut = reader.UInt()
+            cutTypes.append(cut)
+            if cut == CUT_WALL:
+                distances.append(reader.Float())
+            elif cut != CUT_NONE:
+                # Inlets and outlets store the ID before the distance.
+                ioletIds.append(reader.UInt())
+                distances.append(reader.Float())
+                pass
+            continue
+
+        available = reader.UInt()
+        normalAvailable.append(available)
+        if available == WALL_NORMAL_AVAILABLE:
+            normals.extend(reader.Float() for j in range(3))
+            pass
+        continue
+
+    if not reader.AtEnd():
+        raise ValueError('Block has trailing data')
+
+    return b''.join([
+        struct.pack('<%dB' % len(siteTypes), *siteTypes),
+        struct.pack('<%dB' % len(cutTypes), *cutTypes),
+        struct.pack('<%dB' % len(normalAvailable), *normalAvailable),
+        struct.pack('<%df' % len(distances), *distances),
+        struct.pack('<%dI' % len(ioletIds), *ioletIds),
+        struct.pack('<%df' % len(normals), *normals)])
+
+
+def Compress(data, codec):
+    if codec == CODEC_LZ4:
+        import lz4.block
+        return lz4.block.compress(data, store_size=False)
+    return zlib.compress(data)
+
+
+def Convert(inputFile, outputFile, codec=CODEC_ZLIB):
+    """Read the version 4 geometry file inputFile and write it in columnar
+    form to outputFile.
+    """
+    input = open(inputFile, 'rb')
+    preamble = input.read(PreambleLength)
+    hlbMagic, gmyMagic, version, bx, by, bz, blockSize, padding = struct.unpack(
+        '>8I', preamble)
+    if hlbMagic != HemeLbMagicNumber or gmyMagic != GeometryMagicNumber:
+        raise ValueError('%s is not a HemeLB geometry file' % inputFile)
+    if version != VersionNumber:
+        raise ValueError('Can only convert version %d geometry files, not %d' %
+                         (VersionNumber, version))
+
+    nBlocks = bx * by * bz
+    headerData = input.read(nBlocks * HeaderRecordLength)
+    header = [struct.unpack_from('>3I', headerData, i * HeaderRecordLength)
+              for i in range(nBlocks)]
+
+    newHeader = []
+    newBlocks = []
+    for fluidSites, compressedBytes, uncompressedBytes in header:
+        if fluidSites == 0:
+            newHeader.append((0, 0, 0))
+            continue
+        data = zlib.decompress(input.read(compressedBytes))
+        if len(data) != uncompressedBytes:
+            raise ValueError('Block has the wrong uncompressed length')
+        columns = ConvertBlock(data, blockSize ** 3)
+        compressed = Compress(columns, codec)
+        newHeader.append((fluidSites, len(compressed), len(columns)))
+        newBlocks.append(compressed)
+        continue
+    input.close()
+
+    output = open(outputFile, 'wb')
+    output.write(struct.pack('>8I', hlbMagic, gmyMagic, ColumnarVersionNumber,
+                             bx, by, bz, blockSize, codec))
+    for record in newHeader:
+        output.write(struct.pack('>3I', *record))
+        continue
+    for block in newBlocks:
+        output.write(block)
+        continue
+    output.close()
+    return
+
+
+if __name__ == '__main__':
+    import argparse
+    parser = argparse.ArgumentParser(
+        description='Convert a version 4 HemeLB geometry file to the '
+        'columnar (version 5) format')
+    parser.add_argument('input', help='Input version 4 .gmy file')
+    parser.add_argument('output', help='Output columnar .gmy file')
+    parser.add_argument('--codec', choices=sorted(Codecs.keys()),
+                        default='zlib',
+                        help='Block compression codec (default zlib)')
+    args = parser.parse_args()
+
+    Convert(args.input, args.output, Codecs[args.codec])
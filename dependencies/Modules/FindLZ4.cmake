@@ -0,0 +1,24 @@
+# - Find LZ4
+# Find the native LZ4 includes and library
+#
+#   LZ4_FOUND       - True if LZ4 found.
+#   LZ4_INCLUDE_DIR - where to find lz4.h, etc.
+#   LZ4_LIBRARIES   - List of libraries when using LZ4.
+#
+
+IF( LZ4_INCLUDE_DIR )
+    # Already in cache, be silent
+    SET( LZ4_FIND_QUIETLY TRUE )
+ENDIF( LZ4_INCLUDE_DIR )
+
+FIND_PATH( LZ4_INCLUDE_DIR "lz4.h" )
+
+FIND_LIBRARY( LZ4_LIBRARIES
+              NAMES "lz4" )
+
+# handle the QUIETLY and REQUIRED arguments and set LZ4_FOUND to TRUE if
+# all listed variables are TRUE
+INCLUDE( "FindPackageHandleStandardArgs" )
+FIND_PACKAGE_HANDLE_STANDARD_ARGS( "LZ4" DEFAULT_MSG LZ4_INCLUDE_DIR LZ4_LIBRARIES )
+
+MARK_AS_ADVANCED( LZ4_INCLUDE_DIR LZ4_LIBRARIES )